@@ -7,7 +7,7 @@
 #define AAD_CODEC_VERSION           18
 
 /* フォーマットバージョン */
-#define AAD_FORMAT_VERSION          4
+#define AAD_FORMAT_VERSION          5
 
 /* 処理可能な最大チャンネル数 */
 #define AAD_MAX_NUM_CHANNELS        2
@@ -19,7 +19,11 @@
 #define AAD_MAX_BITS_PER_SAMPLE     4
 
 /* ヘッダサイズ[byte] */
-#define AAD_HEADER_SIZE             31
+#define AAD_HEADER_SIZE             37
+
+/* 総サンプル数が不明であることを示すヘッダの値 */
+/* 補足）ライブストリーム向け。デコーダはデータが尽きるまでブロックをデコードする */
+#define AAD_NUM_SAMPLES_UNKNOWN     UINT64_MAX
 
 /* API結果型 */
 typedef enum AADApiResultTag {
@@ -39,15 +43,43 @@ typedef enum AADChannelProcessMethodTag {
   AAD_CH_PROCESS_METHOD_INVALID    /* 無効値         */
 } AADChannelProcessMethod;
 
+/* サンプルの型 */
+typedef enum AADSampleFormatTag {
+  AAD_SAMPLE_FORMAT_INT16 = 0,    /* int16_t                                      */
+  AAD_SAMPLE_FORMAT_INT32,        /* int32_t（16bit幅の値を格納）                 */
+  AAD_SAMPLE_FORMAT_INT32_MSB,    /* int32_t（上位16bitに値を持つ32bit PCM）      */
+  AAD_SAMPLE_FORMAT_FLOAT32,      /* float（[-1.0, 1.0)に正規化）                 */
+  AAD_SAMPLE_FORMAT_INVALID       /* 無効値                                       */
+} AADSampleFormat;
+
+/* サンプルの並び */
+typedef enum AADSampleLayoutTag {
+  AAD_SAMPLE_LAYOUT_INTERLEAVED = 0,  /* チャンネルを交互に並べる     */
+  AAD_SAMPLE_LAYOUT_PLANAR,           /* チャンネルごとに別の配列     */
+  AAD_SAMPLE_LAYOUT_INVALID           /* 無効値                       */
+} AADSampleLayout;
+
+/* サンプルバッファ記述子 */
+/* 補足）チャンネルchのsmpl番目のサンプルは、インターリーブでは channels[0][smpl * stride + ch]、 */
+/*       プレーナでは channels[ch][smpl * stride] にある（添字は要素単位） */
+struct AADSampleBuffer {
+  AADSampleFormat format;                   /* サンプルの型                     */
+  AADSampleLayout layout;                   /* サンプルの並び                   */
+  void *channels[AAD_MAX_NUM_CHANNELS];     /* 先頭アドレス（インターリーブでは[0]のみ使用） */
+  uint32_t num_channels;                    /* チャンネル数                     */
+  uint64_t num_samples;                     /* 1チャンネルあたりサンプル数      */
+  uint32_t stride;                          /* 隣り合うサンプルの間隔[要素]     */
+};
+
 /* ヘッダ情報 */
 struct AADHeaderInfo {
   uint32_t format_version;                    /* フォーマットバージョン         */
   uint32_t codec_version;                     /* コーデックバージョン           */
   uint16_t num_channels;                      /* チャンネル数                   */
-  uint32_t num_samples;                       /* 1チャンネルあたり総サンプル数  */
+  uint64_t num_samples;                       /* 1チャンネルあたり総サンプル数（不明ならAAD_NUM_SAMPLES_UNKNOWN） */
   uint32_t sampling_rate;                     /* サンプリングレート             */
   uint16_t bits_per_sample;                   /* サンプルあたりビット数         */
-  uint16_t block_size;                        /* ブロックサイズ                 */
+  uint32_t block_size;                        /* ブロックサイズ                 */
   uint32_t num_samples_per_block;             /* ブロックあたりサンプル数       */
   AADChannelProcessMethod ch_process_method;  /* マルチチャンネル処理法         */
 };
@@ -1,9 +1,25 @@
 #include "aad_decoder.h"
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+
+/* AVX2によるマルチブロックデコードの利用可否（AAD_DISABLE_SIMDで無効化） */
+#if !defined(AAD_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AAD_DECODER_USE_AVX2 1
+#include <immintrin.h>
+#else
+#define AAD_DECODER_USE_AVX2 0
+#endif
+
+/* AVX2で同時にデコードするブロック数 */
+#define AAD_DECODER_NUM_AVX2_LANES 8
+/* ブロックデコードで一度に展開する符号数 */
+/* 補足）2の冪にしてデータ単位・チャンネル数・バイト境界のいずれとも割り切れるようにする */
+#define AAD_DECODER_CODE_BUFFER_SIZE 1024
 #include "aad_internal.h"
 #include "byte_array.h"
 #include "aad_tables.h"
+#include "aad_sample_buffer.h"
 
 /* デコード処理ハンドル */
 struct AADDecodeProcessor {
@@ -12,24 +28,121 @@ struct AADDecodeProcessor {
   struct AADTable table;              /* ステップサイズテーブル */
 };
 
+/* ストリーミングデコードの状態 */
+typedef enum AADDecodeStreamStateTag {
+  AAD_DECODE_STREAM_STATE_FILE_HEADER = 0,  /* ファイルヘッダ待ち             */
+  AAD_DECODE_STREAM_STATE_BLOCK_HEADER,     /* ブロックヘッダ待ち             */
+  AAD_DECODE_STREAM_STATE_BLOCK_DATA,       /* 符号データ待ち                 */
+  AAD_DECODE_STREAM_STATE_BLOCK_PADDING,    /* ブロック末尾の未使用領域待ち   */
+  AAD_DECODE_STREAM_STATE_END               /* 全サンプル出力済み             */
+} AADDecodeStreamState;
+
 /* デコーダハンドル */
 struct AADDecoder {
   struct AADHeaderInfo      header;
   struct AADDecodeProcessor processor[AAD_MAX_NUM_CHANNELS];
   uint8_t                   alloced_by_own;
   uint8_t                   set_header;
+  AADDecodeStreamState      stream_state;                 /* ストリーミングデコードの状態 */
+  uint8_t                   stream_pending[AAD_MAX_VAL(AAD_HEADER_SIZE, AAD_BLOCK_HEADER_SIZE(AAD_MAX_NUM_CHANNELS))];  /* 揃っていない入力データ */
+  uint32_t                  stream_num_pending_bytes;     /* 揃っていない入力データのサイズ */
+  uint64_t                  stream_num_samples;           /* 出力済みの総サンプル数 */
+  uint32_t                  stream_block_num_samples;     /* 現在ブロックで出力済みのサンプル数 */
+  uint32_t                  stream_block_offset;          /* 現在ブロックで読み込み済みのサイズ */
+  int32_t                   stream_output[AAD_MAX_NUM_CHANNELS][8];  /* デコード済みで未出力のサンプル */
+  uint32_t                  stream_num_output_samples;    /* stream_outputに入っているサンプル数 */
+  uint32_t                  stream_output_offset;         /* stream_outputで出力済みのサンプル数 */
   void                      *work;
 };
 
+/* 並列デコードのワーカ */
+struct AADDecodeWorker {
+  struct AADDecoder decoder;        /* ワーカ専用のデコーダ（状態の複製）   */
+  const uint8_t     *data;          /* データ先頭（ファイルヘッダを含む）   */
+  uint64_t          data_size;      /* データサイズ                         */
+  struct AADSampleBuffer output;    /* 出力バッファ                         */
+  int32_t           *scratch[AAD_MAX_NUM_CHANNELS]; /* 変換用の作業領域（不要ならNULL） */
+  uint64_t          start_block;    /* 担当する先頭ブロック番号             */
+  uint64_t          end_block;      /* 担当する末尾ブロック番号（含まない） */
+  AADApiResult      result;         /* 処理結果                             */
+};
+
 /* デコード処理ハンドルのリセット */
 static void AADDecodeProcessor_Reset(struct AADDecodeProcessor *processor);
 
 /* ヘッダのフォーマットチェック */
 static AADError AADDecoder_CheckHeaderFormat(const struct AADHeaderInfo *header);
 
-/* 1サンプルデコード */
-static int32_t AADDecodeProcessor_DecodeSample(
-    struct AADDecodeProcessor *processor, uint8_t code, uint8_t bits_per_sample);
+/* 1サンプルデコード（サンプルあたりビット数ごとに特殊化） */
+static int32_t AADDecodeProcessor_DecodeSample4bit(struct AADDecodeProcessor *processor, uint8_t code);
+static int32_t AADDecodeProcessor_DecodeSample3bit(struct AADDecodeProcessor *processor, uint8_t code);
+static int32_t AADDecodeProcessor_DecodeSample2bit(struct AADDecodeProcessor *processor, uint8_t code);
+
+/* ブロックヘッダをデコードしてプロセッサに状態をセット */
+static void AADDecoder_DecodeBlockHeader(struct AADDecoder *decoder, const uint8_t *data);
+
+/* 1チャンネル分のデータ単位をデコード */
+/* 補足）4bitは1byteで2サンプル、3bitは3byteで8サンプル、2bitは1byteで4サンプル */
+static void AADDecodeProcessor_DecodeUnit(
+    struct AADDecodeProcessor *processor, const uint8_t *data, uint8_t bits_per_sample, int32_t *output);
+
+/* 1サンプルずつ符号を取り出し符号配列に展開 */
+/* 補足）dataはMSBから詰められた符号列。data_size * 8 / bits_per_sample 個の符号を出力する */
+static void AADDecoder_UnpackCodesScalar(
+    const uint8_t *data, uint32_t data_size, uint8_t bits_per_sample, uint8_t *codes);
+
+/* 符号列を符号配列に展開 */
+static void AADDecoder_UnpackCodes(
+    const uint8_t *data, uint32_t data_size, uint8_t bits_per_sample, uint8_t *codes);
+
+/* 符号配列から1チャンネル分のサンプルをデコード（サンプルあたりビット数ごとに特殊化） */
+/* 補足）code_strideはデータ単位ごとの符号配列上の間隔 */
+static void AADDecodeProcessor_DecodeCodes4bit(struct AADDecodeProcessor *processor,
+    const uint8_t *codes, uint32_t code_stride, int32_t *output, uint32_t num_samples);
+static void AADDecodeProcessor_DecodeCodes3bit(struct AADDecodeProcessor *processor,
+    const uint8_t *codes, uint32_t code_stride, int32_t *output, uint32_t num_samples);
+static void AADDecodeProcessor_DecodeCodes2bit(struct AADDecodeProcessor *processor,
+    const uint8_t *codes, uint32_t code_stride, int32_t *output, uint32_t num_samples);
+
+/* ブロック内の指定サンプル位置以降をデコード */
+static AADApiResult AADDecoder_DecodeBlockFrom(
+    struct AADDecoder *decoder,
+    const uint8_t *data, uint32_t data_size, uint32_t start_sample,
+    int32_t **buffer, uint32_t buffer_num_samples, uint32_t *num_decode_samples);
+
+/* 連続する複数ブロックをデコード */
+static AADApiResult AADDecoder_DecodeBlocks(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size, uint64_t num_blocks,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples,
+    uint64_t *num_decode_samples);
+
+/* 連続する複数ブロックをデコードしてサンプルバッファ記述子のoffset以降に書き出し */
+/* 補足）記述子が作業形式と異なる場合はscratch（各チャンネルAAD_DECODER_NUM_AVX2_LANESブロック分）を経由して変換する */
+static AADApiResult AADDecoder_DecodeBlocksToBuffer(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size, uint64_t num_blocks,
+    const struct AADSampleBuffer *output, uint64_t offset, int32_t **scratch,
+    uint64_t *num_decode_samples);
+
+/* 記述子への書き出しに必要な作業領域を確保 */
+/* 補足）作業形式の記述子では確保せずNULLを返す。num_scratchesセット分を連続して確保する */
+static int32_t *AADDecoder_AllocateScratch(
+    const struct AADHeaderInfo *header, const struct AADSampleBuffer *output, uint32_t num_scratches);
+
+#if AAD_DECODER_USE_AVX2
+/* SSSE3のシャッフルで符号列を符号配列に展開 展開したバイト数を返す */
+static uint32_t AADDecoder_UnpackCodesSSSE3(
+    const uint8_t *data, uint32_t data_size, uint8_t bits_per_sample, uint8_t *codes);
+
+/* AVX2によるマルチブロックデコードが使えるか判定 */
+static uint8_t AADDecoder_CanDecodeBlocksAVX2(const struct AADHeaderInfo *header);
+
+/* 連続するブロックをAVX2の各レーンに割り当てて同時にデコード */
+static void AADDecoder_DecodeBlocksAVX2(
+    struct AADDecoder *decoder, const uint8_t *data, int32_t **buffer);
+#endif
+
+/* ワーカが担当するブロック範囲をデコード */
+static void *AADDecodeWorker_Run(void *arg);
 
 /* ワークサイズ計算 */
 int32_t AADDecoder_CalculateWorkSize(void)
@@ -78,6 +191,15 @@ struct AADDecoder *AADDecoder_Create(void *work, int32_t work_size)
   /* ヘッダは未セット状態 */
   decoder->set_header = 0;
 
+  /* ストリーミングはファイルヘッダ待ち状態 */
+  decoder->stream_state = AAD_DECODE_STREAM_STATE_FILE_HEADER;
+  decoder->stream_num_pending_bytes = 0;
+  decoder->stream_num_samples = 0;
+  decoder->stream_block_num_samples = 0;
+  decoder->stream_block_offset = 0;
+  decoder->stream_num_output_samples = 0;
+  decoder->stream_output_offset = 0;
+
   /* バッファオーバーランチェック */
   AAD_ASSERT((int32_t)(work_ptr - (uint8_t *)work) <= work_size);
 
@@ -97,9 +219,10 @@ void AADDecoder_Destroy(struct AADDecoder *decoder)
 
 /* ヘッダデコード */
 AADApiResult AADDecoder_DecodeHeader(
-    const uint8_t *data, uint32_t data_size, struct AADHeaderInfo *header_info)
+    const uint8_t *data, uint64_t data_size, struct AADHeaderInfo *header_info)
 {
   const uint8_t *data_pos;
+  uint64_t u64buf;
   uint32_t u32buf;
   uint16_t u16buf;
   uint8_t  u8buf;
@@ -143,8 +266,8 @@ AADApiResult AADDecoder_DecodeHeader(
   ByteArray_GetUint16BE(data_pos, &u16buf);
   tmp_header_info.num_channels = u16buf;
   /* サンプル数 */
-  ByteArray_GetUint32BE(data_pos, &u32buf);
-  tmp_header_info.num_samples = u32buf;
+  ByteArray_GetUint64BE(data_pos, &u64buf);
+  tmp_header_info.num_samples = u64buf;
   /* サンプリングレート */
   ByteArray_GetUint32BE(data_pos, &u32buf);
   tmp_header_info.sampling_rate = u32buf;
@@ -152,8 +275,8 @@ AADApiResult AADDecoder_DecodeHeader(
   ByteArray_GetUint16BE(data_pos, &u16buf);
   tmp_header_info.bits_per_sample = u16buf;
   /* ブロックサイズ */
-  ByteArray_GetUint16BE(data_pos, &u16buf);
-  tmp_header_info.block_size = u16buf;
+  ByteArray_GetUint32BE(data_pos, &u32buf);
+  tmp_header_info.block_size = u32buf;
   /* ブロックあたりサンプル数 */
   ByteArray_GetUint32BE(data_pos, &u32buf);
   tmp_header_info.num_samples_per_block = u32buf;
@@ -265,58 +388,235 @@ static void AADDecodeProcessor_Reset(struct AADDecodeProcessor *processor)
   }
 }
 
-/* 1サンプルデコード */
-static int32_t AADDecodeProcessor_DecodeSample(
-    struct AADDecodeProcessor *processor, uint8_t code, uint8_t bits_per_sample)
-{
-  int32_t sample, qdiff, delta, predict, stepsize, ord;
-  const uint8_t signbit = (uint8_t)(1U << (bits_per_sample - 1));
-  const uint8_t absmask = (uint8_t)(signbit - 1);
+/* 1サンプルデコード関数の定義マクロ */
+/* 補足）サンプルあたりビット数ごとに展開し、テーブルはポインタを介さず直接参照する */
+#define AAD_DECODER_DEFINE_DECODE_SAMPLE(bits_per_sample)\
+static int32_t AADDecodeProcessor_DecodeSample ## bits_per_sample ## bit(\
+    struct AADDecodeProcessor *processor, uint8_t code)\
+{\
+  int32_t sample, qdiff, predict, ord;\
+\
+  AAD_ASSERT(processor != NULL);\
+  AAD_ASSERT(code < (1U << (bits_per_sample)));\
+\
+  /* 差分算出: ステップサイズと符号からテーブル引き */\
+  qdiff = AAD_qdiff_table_ ## bits_per_sample ## bit[\
+    AAD_TABLES_FLOAT_TO_INDEX(processor->table.stepsize_index)][code];\
+\
+  /* フィルタ予測 */\
+  predict = AAD_FIXEDPOINT_0_5;\
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {\
+    predict += processor->history[ord] * processor->weight[ord];\
+  }\
+  predict >>= AAD_FIXEDPOINT_DIGITS;\
+\
+  /* 予測を加え信号を復元 */\
+  sample = qdiff + predict;\
+  /* 16bit幅にクリップ */\
+  sample = AAD_INNER_VAL(sample, INT16_MIN, INT16_MAX);\
+\
+  /* インデックス更新 */\
+  AADTable_UpdateIndexNbit(processor->table.stepsize_index, code, bits_per_sample);\
+\
+  /* 係数更新 */\
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {\
+    processor->weight[ord]\
+      += (qdiff * processor->history[ord] + AAD_FIXEDPOINT_0_5) >> (AAD_FIXEDPOINT_DIGITS + AAD_LMSFILTER_SHIFT);\
+  }\
+\
+  /* 入力データ履歴更新 */\
+  for (ord = AAD_FILTER_ORDER - 1; ord > 0; ord--) {\
+    processor->history[ord] = processor->history[ord - 1];\
+  }\
+  processor->history[0] = (int16_t)sample;\
+\
+  return sample;\
+}
 
-  AAD_ASSERT(processor != NULL);
-  AAD_ASSERT((bits_per_sample >= AAD_MIN_BITS_PER_SAMPLE) && (bits_per_sample <= AAD_MAX_BITS_PER_SAMPLE));
-  AAD_ASSERT(code <= ((1U << bits_per_sample) - 1));
+/* 1サンプルデコード（サンプルあたりビット数ごとに特殊化） */
+AAD_DECODER_DEFINE_DECODE_SAMPLE(4)
+AAD_DECODER_DEFINE_DECODE_SAMPLE(3)
+AAD_DECODER_DEFINE_DECODE_SAMPLE(2)
 
-  /* ステップサイズの取得 */
-  stepsize = AADTable_GetStepSize(&(processor->table));
+/* ブロックヘッダをデコードしてプロセッサに状態をセット */
+static void AADDecoder_DecodeBlockHeader(struct AADDecoder *decoder, const uint8_t *data)
+{
+  uint32_t ch, ord;
+  const uint8_t *read_pos = data;
 
-  /* 差分算出 */
-  /* diff = stepsize * (delta + 0.5) / 2**(bits_per_sample-2) */
-  /* -> diff = stepsize * (delta * 2 + 1) / 2**(bits_per_sample-1) */
-  delta = code & absmask;
-  qdiff = (stepsize * ((delta << 1) + 1)) >> (bits_per_sample - 1);
-  qdiff = (code & signbit) ? -qdiff : qdiff; /* 符号ビットの反映 */
+  AAD_ASSERT((decoder != NULL) && (data != NULL));
 
-  /* フィルタ予測 */
-  predict = AAD_FIXEDPOINT_0_5;
-  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
-    predict += processor->history[ord] * processor->weight[ord];
+  for (ch = 0; ch < decoder->header.num_channels; ch++) {
+    uint16_t u16buf;
+    uint8_t shift;
+    /* ステップサイズインデックス12bit + 係数シフト量4bit */
+    AAD_STATIC_ASSERT(AAD_TABLES_FLOAT_DIGITS == 4);
+    ByteArray_GetUint16BE(read_pos, &u16buf);
+    decoder->processor[ch].table.stepsize_index = (int16_t)(u16buf >> AAD_TABLES_FLOAT_DIGITS);
+    shift = u16buf & 0xF;
+    /* フィルタの状態 */
+    for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+      ByteArray_GetUint16BE(read_pos, &u16buf);
+      decoder->processor[ch].weight[ord] = (int16_t)u16buf;
+      decoder->processor[ch].weight[ord] <<= shift;
+      ByteArray_GetUint16BE(read_pos, &u16buf);
+      decoder->processor[ch].history[ord] = (int16_t)u16buf;
+    }
   }
-  predict >>= AAD_FIXEDPOINT_DIGITS;
 
-  /* 予測を加え信号を復元 */
-  sample = qdiff + predict;
-  /* 16bit幅にクリップ */
-  sample = AAD_INNER_VAL(sample, INT16_MIN, INT16_MAX);
+  /* ブロックヘッダサイズチェック */
+  AAD_ASSERT((uint32_t)(read_pos - data) == AAD_BLOCK_HEADER_SIZE(decoder->header.num_channels));
+}
+
+/* 1チャンネル分のデータ単位をデコード */
+static void AADDecodeProcessor_DecodeUnit(
+    struct AADDecodeProcessor *processor, const uint8_t *data, uint8_t bits_per_sample, int32_t *output)
+{
+  uint8_t code;
+  uint32_t code24;
+  const uint8_t *read_pos = data;
+
+  AAD_ASSERT((processor != NULL) && (data != NULL) && (output != NULL));
+
+  switch (bits_per_sample) {
+    case 4:
+      ByteArray_GetUint8(read_pos, &code);
+      output[0] = AADDecodeProcessor_DecodeSample4bit(processor, (code >> 4) & 0xF);
+      output[1] = AADDecodeProcessor_DecodeSample4bit(processor, (code >> 0) & 0xF);
+      break;
+    case 3:
+      ByteArray_GetUint24BE(read_pos, &code24);
+      output[0] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >> 21) & 0x7);
+      output[1] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >> 18) & 0x7);
+      output[2] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >> 15) & 0x7);
+      output[3] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >> 12) & 0x7);
+      output[4] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >>  9) & 0x7);
+      output[5] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >>  6) & 0x7);
+      output[6] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >>  3) & 0x7);
+      output[7] = AADDecodeProcessor_DecodeSample3bit(processor, (code24 >>  0) & 0x7);
+      break;
+    case 2:
+      ByteArray_GetUint8(read_pos, &code);
+      output[0] = AADDecodeProcessor_DecodeSample2bit(processor, (code >> 6) & 0x3);
+      output[1] = AADDecodeProcessor_DecodeSample2bit(processor, (code >> 4) & 0x3);
+      output[2] = AADDecodeProcessor_DecodeSample2bit(processor, (code >> 2) & 0x3);
+      output[3] = AADDecodeProcessor_DecodeSample2bit(processor, (code >> 0) & 0x3);
+      break;
+    default:
+      AAD_ASSERT(0);
+  }
+}
 
-  /* インデックス更新 */
-  AADTable_UpdateIndex(&(processor->table), code);
+/* 1サンプルずつ符号を取り出し符号配列に展開 */
+static void AADDecoder_UnpackCodesScalar(
+    const uint8_t *data, uint32_t data_size, uint8_t bits_per_sample, uint8_t *codes)
+{
+  uint32_t i, num_codes;
+
+  AAD_ASSERT((data != NULL) && (codes != NULL));
+  AAD_ASSERT((bits_per_sample >= 1) && (bits_per_sample <= 8));
+
+  num_codes = (data_size * 8) / bits_per_sample;
+  for (i = 0; i < num_codes; i++) {
+    /* 符号を含む2byteをビッグエンディアンで読み、左詰めしてから上位ビットを取り出す */
+    const uint32_t offset = i * bits_per_sample;
+    const uint32_t pos = offset >> 3;
+    uint32_t word = (uint32_t)data[pos] << 8;
+    if ((pos + 1) < data_size) {
+      word |= data[pos + 1];
+    }
+    codes[i] = (uint8_t)(((word << (offset & 7)) & 0xFFFF) >> (16 - bits_per_sample));
+  }
+}
 
-  /* 係数更新 */
-  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
-    processor->weight[ord]
-      += (qdiff * processor->history[ord] + AAD_FIXEDPOINT_0_5) >> (AAD_FIXEDPOINT_DIGITS + AAD_LMSFILTER_SHIFT);
+#if AAD_DECODER_USE_AVX2
+/* SSSE3のシャッフルで符号列を符号配列に展開 */
+/* 補足）8符号はbits_per_sample[byte]に収まる。各符号を含む2byteを16bitレーンにシャッフルし、 */
+/*       レーンごとの乗算で左詰めした後に右シフトで取り出す。2グループ16符号ずつ処理する */
+__attribute__((target("ssse3")))
+static uint32_t AADDecoder_UnpackCodesSSSE3(
+    const uint8_t *data, uint32_t data_size, uint8_t bits_per_sample, uint8_t *codes)
+{
+  uint32_t k, pos;
+  uint8_t shuffle[16];
+  int16_t multiplier[8];
+  __m128i vshuffle_lo, vshuffle_hi, vmultiplier, vshift;
+
+  AAD_ASSERT((data != NULL) && (codes != NULL));
+  AAD_ASSERT((bits_per_sample >= 1) && (bits_per_sample <= 8));
+
+  /* シャッフルと乗数の作成: レーンkには上位byteにdata[i], 下位byteにdata[i + 1]を置く */
+  for (k = 0; k < 8; k++) {
+    const uint32_t offset = k * bits_per_sample;
+    shuffle[2 * k + 0] = (uint8_t)((offset >> 3) + 1);
+    shuffle[2 * k + 1] = (uint8_t)(offset >> 3);
+    multiplier[k] = (int16_t)(1 << (offset & 7));
+  }
+  vshuffle_lo = _mm_loadu_si128((const __m128i *)shuffle);
+  vshuffle_hi = _mm_add_epi8(vshuffle_lo, _mm_set1_epi8((char)bits_per_sample));
+  vmultiplier = _mm_loadu_si128((const __m128i *)multiplier);
+  vshift = _mm_cvtsi32_si128(16 - bits_per_sample);
+
+  /* 16byteのロードがデータ末尾を超えない範囲で処理 */
+  for (pos = 0; (pos + 16) <= data_size; pos += 2U * bits_per_sample) {
+    const __m128i vdata = _mm_loadu_si128((const __m128i *)&data[pos]);
+    const __m128i vlo = _mm_srl_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(vdata, vshuffle_lo), vmultiplier), vshift);
+    const __m128i vhi = _mm_srl_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(vdata, vshuffle_hi), vmultiplier), vshift);
+    _mm_storeu_si128((__m128i *)codes, _mm_packus_epi16(vlo, vhi));
+    codes += 16;
   }
 
-  /* 入力データ履歴更新 */
-  for (ord = AAD_FILTER_ORDER - 1; ord > 0; ord--) {
-    processor->history[ord] = processor->history[ord - 1];
+  return pos;
+}
+#endif /* AAD_DECODER_USE_AVX2 */
+
+/* 符号列を符号配列に展開 */
+static void AADDecoder_UnpackCodes(
+    const uint8_t *data, uint32_t data_size, uint8_t bits_per_sample, uint8_t *codes)
+{
+  uint32_t pos = 0;
+
+  AAD_ASSERT((data != NULL) && (codes != NULL));
+
+#if AAD_DECODER_USE_AVX2
+  if (__builtin_cpu_supports("ssse3")) {
+    pos = AADDecoder_UnpackCodesSSSE3(data, data_size, bits_per_sample, codes);
   }
-  processor->history[0] = (int16_t)sample;
+#endif
+
+  /* 残りは逐次処理 */
+  /* 補足）posは8符号単位の区切りなので、符号配列の位置はpos * 8 / bits_per_sample */
+  AADDecoder_UnpackCodesScalar(&data[pos], data_size - pos, bits_per_sample,
+      &codes[(pos * 8) / bits_per_sample]);
+}
 
-  return sample;
+/* 符号配列から1チャンネル分のサンプルをデコードする関数の定義マクロ */
+/* 補足）符号の取り出しを済ませてあるので、ループは予測・量子化・更新の再帰計算のみになる */
+#define AAD_DECODER_DEFINE_DECODE_CODES(bits_per_sample, num_unit_samples)\
+static void AADDecodeProcessor_DecodeCodes ## bits_per_sample ## bit(struct AADDecodeProcessor *processor,\
+    const uint8_t *codes, uint32_t code_stride, int32_t *output, uint32_t num_samples)\
+{\
+  uint32_t smpl, k;\
+  const uint32_t num_unit_aligned_samples = num_samples - (num_samples % (num_unit_samples));\
+\
+  AAD_ASSERT((processor != NULL) && (codes != NULL) && (output != NULL));\
+\
+  for (smpl = 0; smpl < num_unit_aligned_samples; smpl += (num_unit_samples)) {\
+    for (k = 0; k < (num_unit_samples); k++) {\
+      output[smpl + k] = AADDecodeProcessor_DecodeSample ## bits_per_sample ## bit(processor, codes[k]);\
+    }\
+    codes += code_stride;\
+  }\
+  for (k = 0; smpl < num_samples; k++, smpl++) {\
+    output[smpl] = AADDecodeProcessor_DecodeSample ## bits_per_sample ## bit(processor, codes[k]);\
+  }\
 }
 
+/* 符号配列から1チャンネル分のサンプルをデコード（サンプルあたりビット数ごとに特殊化） */
+AAD_DECODER_DEFINE_DECODE_CODES(4, 2)
+AAD_DECODER_DEFINE_DECODE_CODES(3, 8)
+AAD_DECODER_DEFINE_DECODE_CODES(2, 4)
+
 /* 単一データブロックデコード */
 AADApiResult AADDecoder_DecodeBlock(
     struct AADDecoder *decoder,
@@ -328,6 +628,9 @@ AADApiResult AADDecoder_DecodeBlock(
   uint32_t ch, smpl;
   const uint8_t *read_pos;
   uint32_t tmp_num_decode_samples;
+  uint32_t num_unit_samples, unit_size, num_chunk_units;
+  void (*decode_codes)(struct AADDecodeProcessor *processor,
+      const uint8_t *codes, uint32_t code_stride, int32_t *output, uint32_t num_samples);
 
   /* 引数チェック */
   if ((decoder == NULL) || (data == NULL)
@@ -361,26 +664,8 @@ AADApiResult AADDecoder_DecodeBlock(
   }
 
   /* ブロックヘッダデコード */
-  for (ch = 0; ch < header->num_channels; ch++) {
-    uint16_t u16buf;
-    uint8_t shift;
-    /* ステップサイズインデックス12bit + 係数シフト量4bit */
-    AAD_STATIC_ASSERT(AAD_TABLES_FLOAT_DIGITS == 4);
-    ByteArray_GetUint16BE(read_pos, &u16buf);
-    decoder->processor[ch].table.stepsize_index = (int16_t)(u16buf >> AAD_TABLES_FLOAT_DIGITS);
-    shift = u16buf & 0xF;
-    /* フィルタの状態 */
-    for (smpl = 0; smpl < AAD_FILTER_ORDER; smpl++) {
-      ByteArray_GetUint16BE(read_pos, &u16buf);
-      decoder->processor[ch].weight[smpl] = (int16_t)u16buf;
-      decoder->processor[ch].weight[smpl] <<= shift;
-      ByteArray_GetUint16BE(read_pos, &u16buf);
-      decoder->processor[ch].history[smpl] = (int16_t)u16buf;
-    }
-  }
-
-  /* ブロックヘッダサイズチェック */
-  AAD_ASSERT((uint32_t)(read_pos - data) == AAD_BLOCK_HEADER_SIZE(header->num_channels));
+  AADDecoder_DecodeBlockHeader(decoder, read_pos);
+  read_pos += AAD_BLOCK_HEADER_SIZE(header->num_channels);
 
   /* 先頭サンプルはヘッダに入っている */
   for (ch = 0; ch < header->num_channels; ch++) {
@@ -390,68 +675,31 @@ AADApiResult AADDecoder_DecodeBlock(
     }
   }
 
-  /* データデコード */
+  /* データ単位あたりのサンプル数・サイズとデコード関数 */
+  /* 補足）サンプルあたりビット数での分岐はブロックごとに1回だけ行う */
   switch (header->bits_per_sample) {
-    case 4:
-      for (smpl = AAD_FILTER_ORDER; smpl < tmp_num_decode_samples; smpl += 2) {
-        const size_t copy_size = sizeof(int32_t) * AAD_MIN_VAL(2, tmp_num_decode_samples - smpl);
-        for (ch = 0; ch < header->num_channels; ch++) {
-          uint8_t code;
-          int32_t outbuf[2];
-          struct AADDecodeProcessor *processor = &(decoder->processor[ch]);
-          AAD_ASSERT((uint32_t)(read_pos - data) < data_size);
-          AAD_ASSERT((uint32_t)(read_pos - data) < header->block_size);
-          ByteArray_GetUint8(read_pos, &code);
-          outbuf[0] = AADDecodeProcessor_DecodeSample(processor, (code >> 4) & 0xF, 4); 
-          outbuf[1] = AADDecodeProcessor_DecodeSample(processor, (code >> 0) & 0xF, 4); 
-          memcpy(&buffer[ch][smpl], outbuf, copy_size);
-        }
-      }
-      break;
-    case 3:
-      for (smpl = AAD_FILTER_ORDER; smpl < tmp_num_decode_samples; smpl += 8) {
-        const size_t copy_size = sizeof(int32_t) * AAD_MIN_VAL(8, tmp_num_decode_samples - smpl);
-        for (ch = 0; ch < header->num_channels; ch++) {
-          uint32_t code24;
-          int32_t outbuf[8];
-          struct AADDecodeProcessor *processor = &(decoder->processor[ch]);
-          AAD_ASSERT((uint32_t)(read_pos - data) < data_size);
-          AAD_ASSERT((uint32_t)(read_pos - data) < header->block_size);
-          ByteArray_GetUint24BE(read_pos, &code24);
-          AAD_ASSERT((uint32_t)(read_pos - data) <= data_size);
-          AAD_ASSERT((uint32_t)(read_pos - data) <= header->block_size);
-          outbuf[0] = AADDecodeProcessor_DecodeSample(processor, (code24 >> 21) & 0x7, 3); 
-          outbuf[1] = AADDecodeProcessor_DecodeSample(processor, (code24 >> 18) & 0x7, 3); 
-          outbuf[2] = AADDecodeProcessor_DecodeSample(processor, (code24 >> 15) & 0x7, 3); 
-          outbuf[3] = AADDecodeProcessor_DecodeSample(processor, (code24 >> 12) & 0x7, 3); 
-          outbuf[4] = AADDecodeProcessor_DecodeSample(processor, (code24 >>  9) & 0x7, 3); 
-          outbuf[5] = AADDecodeProcessor_DecodeSample(processor, (code24 >>  6) & 0x7, 3); 
-          outbuf[6] = AADDecodeProcessor_DecodeSample(processor, (code24 >>  3) & 0x7, 3); 
-          outbuf[7] = AADDecodeProcessor_DecodeSample(processor, (code24 >>  0) & 0x7, 3); 
-          memcpy(&buffer[ch][smpl], outbuf, copy_size);
-        }
-      }
-      break;
-    case 2:
-      for (smpl = AAD_FILTER_ORDER; smpl < tmp_num_decode_samples; smpl += 4) {
-        const size_t copy_size = sizeof(int32_t) * AAD_MIN_VAL(4, tmp_num_decode_samples - smpl);
-        for (ch = 0; ch < header->num_channels; ch++) {
-          uint8_t code;
-          int32_t outbuf[4];
-          struct AADDecodeProcessor *processor = &(decoder->processor[ch]);
-          AAD_ASSERT((uint32_t)(read_pos - data) < data_size);
-          AAD_ASSERT((uint32_t)(read_pos - data) < header->block_size);
-          ByteArray_GetUint8(read_pos, &code);
-          outbuf[0] = AADDecodeProcessor_DecodeSample(processor, (code >> 6) & 0x3, 2); 
-          outbuf[1] = AADDecodeProcessor_DecodeSample(processor, (code >> 4) & 0x3, 2); 
-          outbuf[2] = AADDecodeProcessor_DecodeSample(processor, (code >> 2) & 0x3, 2); 
-          outbuf[3] = AADDecodeProcessor_DecodeSample(processor, (code >> 0) & 0x3, 2); 
-          memcpy(&buffer[ch][smpl], outbuf, copy_size);
-        }
-      }
-      break;
-    default:
-      return AAD_APIRESULT_INVALID_FORMAT;
+    case 4: num_unit_samples = 2; unit_size = 1; decode_codes = AADDecodeProcessor_DecodeCodes4bit; break;
+    case 3: num_unit_samples = 8; unit_size = 3; decode_codes = AADDecodeProcessor_DecodeCodes3bit; break;
+    case 2: num_unit_samples = 4; unit_size = 1; decode_codes = AADDecodeProcessor_DecodeCodes2bit; break;
+    default: return AAD_APIRESULT_INVALID_FORMAT;
+  }
+
+  /* データデコード */
+  /* 補足）符号列をまとめて符号配列に展開してから、チャンネルごとに再帰計算でデコードする */
+  num_chunk_units = AAD_DECODER_CODE_BUFFER_SIZE / (num_unit_samples * header->num_channels);
+  for (smpl = AAD_FILTER_ORDER; smpl < tmp_num_decode_samples; smpl += num_chunk_units * num_unit_samples) {
+    uint8_t codes[AAD_DECODER_CODE_BUFFER_SIZE];
+    const uint32_t num_samples = AAD_MIN_VAL(num_chunk_units * num_unit_samples, tmp_num_decode_samples - smpl);
+    const uint32_t num_units = (num_samples + num_unit_samples - 1) / num_unit_samples;
+    const uint32_t read_size = num_units * unit_size * header->num_channels;
+    AAD_ASSERT((uint32_t)(read_pos - data) + read_size <= data_size);
+    AAD_ASSERT((uint32_t)(read_pos - data) + read_size <= header->block_size);
+    AADDecoder_UnpackCodes(read_pos, read_size, (uint8_t)header->bits_per_sample, codes);
+    read_pos += read_size;
+    for (ch = 0; ch < header->num_channels; ch++) {
+      decode_codes(&(decoder->processor[ch]), &codes[ch * num_unit_samples],
+          num_unit_samples * header->num_channels, &buffer[ch][smpl], num_samples);
+    }
   }
 
   /* MS -> LR */
@@ -474,25 +722,960 @@ AADApiResult AADDecoder_DecodeBlock(
   return AAD_APIRESULT_OK;
 }
 
+#if AAD_DECODER_USE_AVX2
+/* AVX2によるマルチブロックデコードが使えるか判定 */
+static uint8_t AADDecoder_CanDecodeBlocksAVX2(const struct AADHeaderInfo *header)
+{
+  uint32_t unit_size, num_unit_samples, num_units;
+
+  AAD_ASSERT(header != NULL);
+
+  /* CPUがAVX2に対応しているか */
+  if (!__builtin_cpu_supports("avx2")) {
+    return 0;
+  }
+
+  /* ブロック内のデータ単位がブロックサイズに収まっているか */
+  /* 補足）ヘッダのブロックあたりサンプル数を信用して読むため、不整合なら逐次処理に任せる */
+  unit_size = (header->bits_per_sample == 3) ? 3U : 1U;
+  num_unit_samples = (header->bits_per_sample == 3) ? 8U : (8U / header->bits_per_sample);
+  if ((header->num_samples_per_block < AAD_FILTER_ORDER)
+      || (header->num_samples_per_block > (UINT32_MAX / AAD_DECODER_NUM_AVX2_LANES))) {
+    return 0;
+  }
+  num_units = (header->num_samples_per_block - AAD_FILTER_ORDER + num_unit_samples - 1) / num_unit_samples;
+  if (AAD_BLOCK_HEADER_SIZE(header->num_channels) + (uint64_t)num_units * unit_size * header->num_channels
+      > header->block_size) {
+    return 0;
+  }
+
+  return 1;
+}
+
+/* 連続するブロックをAVX2の各レーンに割り当てて同時にデコード */
+/* 補足）ブロック内の処理は逐次的だがブロック間は独立なので、 */
+/*       AAD_DECODER_NUM_AVX2_LANES個のブロックの予測・ステップサイズ更新・クリップを揃えて実行する。 */
+/*       各ブロックはブロックあたりサンプル数を全て含んでいること。MS処理は呼び出し側で行う */
+__attribute__((target("avx2")))
+static void AADDecoder_DecodeBlocksAVX2(
+    struct AADDecoder *decoder, const uint8_t *data, int32_t **buffer)
+{
+  uint32_t ch, ord, lane, smpl, k;
+  const struct AADHeaderInfo *header = &(decoder->header);
+  const uint32_t num_samples_per_block = header->num_samples_per_block;
+  const uint32_t bits_per_sample = header->bits_per_sample;
+  const uint32_t unit_size = (bits_per_sample == 3) ? 3U : 1U;
+  const uint32_t num_unit_samples = (bits_per_sample == 3) ? 8U : (8U / bits_per_sample);
+  const uint32_t block_header_size = AAD_BLOCK_HEADER_SIZE(header->num_channels);
+  int32_t index_table[AAD_MAX_CODE_VALUE + 1];
+  int32_t codes[8][AAD_DECODER_NUM_AVX2_LANES];
+  int32_t output[AAD_DECODER_NUM_AVX2_LANES];
+  int32_t index[AAD_MAX_NUM_CHANNELS][AAD_DECODER_NUM_AVX2_LANES];
+  int32_t weight[AAD_MAX_NUM_CHANNELS][AAD_FILTER_ORDER][AAD_DECODER_NUM_AVX2_LANES];
+  int32_t history[AAD_MAX_NUM_CHANNELS][AAD_FILTER_ORDER][AAD_DECODER_NUM_AVX2_LANES];
+
+  AAD_ASSERT((decoder != NULL) && (data != NULL) && (buffer != NULL));
+
+  /* インデックス変動テーブルをギャザー用に32bit幅へ展開 */
+  for (k = 0; k < (uint32_t)decoder->processor[0].table.index_table_size; k++) {
+    index_table[k] = decoder->processor[0].table.index_table[k];
+  }
+
+  /* 各レーンのブロックヘッダをデコードし、先頭サンプルを出力 */
+  for (lane = 0; lane < AAD_DECODER_NUM_AVX2_LANES; lane++) {
+    AADDecoder_DecodeBlockHeader(decoder, &data[lane * header->block_size]);
+    for (ch = 0; ch < header->num_channels; ch++) {
+      const struct AADDecodeProcessor *processor = &(decoder->processor[ch]);
+      index[ch][lane] = processor->table.stepsize_index;
+      for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+        weight[ch][ord][lane] = processor->weight[ord];
+        history[ch][ord][lane] = processor->history[ord];
+        buffer[ch][lane * num_samples_per_block + ord] = processor->history[AAD_FILTER_ORDER - ord - 1];
+      }
+    }
+  }
+
+  for (ch = 0; ch < header->num_channels; ch++) {
+    const int32_t *qdiff_table = decoder->processor[0].table.qdiff_table;
+    const __m128i vcode_bits = _mm_cvtsi32_si128((int)bits_per_sample);
+    const __m256i vhalf = _mm256_set1_epi32(AAD_FIXEDPOINT_0_5);
+    const __m256i vtable_half = _mm256_set1_epi32(AAD_TABLES_FLOAT_0_5);
+    const __m256i vmin_sample = _mm256_set1_epi32(INT16_MIN);
+    const __m256i vmax_sample = _mm256_set1_epi32(INT16_MAX);
+    const __m256i vmin_index = _mm256_setzero_si256();
+    const __m256i vmax_index = _mm256_set1_epi32(AAD_TABLES_INDEX_TO_FLOAT(AAD_STEPSIZE_TABLE_SIZE - 1));
+    __m256i vindex, vweight[AAD_FILTER_ORDER], vhistory[AAD_FILTER_ORDER];
+
+    vindex = _mm256_loadu_si256((const __m256i *)index[ch]);
+    for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+      vweight[ord] = _mm256_loadu_si256((const __m256i *)weight[ch][ord]);
+      vhistory[ord] = _mm256_loadu_si256((const __m256i *)history[ch][ord]);
+    }
+
+    for (smpl = AAD_FILTER_ORDER; smpl < num_samples_per_block; smpl += num_unit_samples) {
+      const uint32_t unit_offset
+        = block_header_size + (((smpl - AAD_FILTER_ORDER) / num_unit_samples) * header->num_channels + ch) * unit_size;
+      const uint32_t num_decode_samples = AAD_MIN_VAL(num_unit_samples, num_samples_per_block - smpl);
+
+      /* 各レーンのデータ単位から符号を取り出す */
+      for (lane = 0; lane < AAD_DECODER_NUM_AVX2_LANES; lane++) {
+        const uint8_t *read_pos = &data[lane * header->block_size + unit_offset];
+        uint8_t code;
+        uint32_t code24;
+        switch (bits_per_sample) {
+          case 4:
+            ByteArray_GetUint8(read_pos, &code);
+            codes[0][lane] = (code >> 4) & 0xF;
+            codes[1][lane] = (code >> 0) & 0xF;
+            break;
+          case 3:
+            ByteArray_GetUint24BE(read_pos, &code24);
+            for (k = 0; k < 8; k++) {
+              codes[k][lane] = (int32_t)((code24 >> (21 - 3 * k)) & 0x7);
+            }
+            break;
+          case 2:
+            ByteArray_GetUint8(read_pos, &code);
+            codes[0][lane] = (code >> 6) & 0x3;
+            codes[1][lane] = (code >> 4) & 0x3;
+            codes[2][lane] = (code >> 2) & 0x3;
+            codes[3][lane] = (code >> 0) & 0x3;
+            break;
+          default:
+            AAD_ASSERT(0);
+        }
+      }
+
+      for (k = 0; k < num_decode_samples; k++) {
+        __m256i vcode, vqdiff, vpredict, vsample;
+
+        /* 差分算出: [ステップサイズテーブルインデックス][符号]でテーブル引き */
+        vcode = _mm256_loadu_si256((const __m256i *)codes[k]);
+        vqdiff = _mm256_srai_epi32(_mm256_add_epi32(vindex, vtable_half), AAD_TABLES_FLOAT_DIGITS);
+        vqdiff = _mm256_add_epi32(_mm256_sll_epi32(vqdiff, vcode_bits), vcode);
+        vqdiff = _mm256_i32gather_epi32((const int *)qdiff_table, vqdiff, 4);
+
+        /* フィルタ予測 */
+        vpredict = vhalf;
+        for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+          vpredict = _mm256_add_epi32(vpredict, _mm256_mullo_epi32(vhistory[ord], vweight[ord]));
+        }
+        vpredict = _mm256_srai_epi32(vpredict, AAD_FIXEDPOINT_DIGITS);
+
+        /* 予測を加え信号を復元し16bit幅にクリップ */
+        vsample = _mm256_add_epi32(vqdiff, vpredict);
+        vsample = _mm256_max_epi32(vmin_sample, _mm256_min_epi32(vmax_sample, vsample));
+
+        /* インデックス更新 */
+        vindex = _mm256_add_epi32(vindex, _mm256_i32gather_epi32((const int *)index_table, vcode, 4));
+        vindex = _mm256_max_epi32(vmin_index, _mm256_min_epi32(vmax_index, vindex));
+
+        /* 係数更新 */
+        for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+          vweight[ord] = _mm256_add_epi32(vweight[ord],
+              _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(vqdiff, vhistory[ord]), vhalf),
+                AAD_FIXEDPOINT_DIGITS + AAD_LMSFILTER_SHIFT));
+        }
+
+        /* 入力データ履歴更新 */
+        for (ord = AAD_FILTER_ORDER - 1; ord > 0; ord--) {
+          vhistory[ord] = vhistory[ord - 1];
+        }
+        vhistory[0] = vsample;
+
+        /* 各レーンのブロックの位置に書き出し */
+        _mm256_storeu_si256((__m256i *)output, vsample);
+        for (lane = 0; lane < AAD_DECODER_NUM_AVX2_LANES; lane++) {
+          buffer[ch][lane * num_samples_per_block + smpl + k] = output[lane];
+        }
+      }
+    }
+  }
+}
+#endif /* AAD_DECODER_USE_AVX2 */
+
+/* 連続する複数ブロックをデコード */
+/* 補足）dataは先頭ブロックを指す。ブロックはサイズ・サンプル数ともに固定なので、 */
+/*       全サンプルを含むブロックが揃っていればSIMDでまとめてデコードする */
+static AADApiResult AADDecoder_DecodeBlocks(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size, uint64_t num_blocks,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples,
+    uint64_t *num_decode_samples)
+{
+  AADApiResult ret;
+  uint32_t ch, read_block_size, num_block_decode_samples;
+  uint64_t blk, progress, read_offset;
+  int32_t *buffer_ptr[AAD_MAX_NUM_CHANNELS];
+  const struct AADHeaderInfo *header;
+#if AAD_DECODER_USE_AVX2
+  uint8_t use_avx2;
+#endif
+
+  AAD_ASSERT((decoder != NULL) && (data != NULL) && (buffer != NULL) && (num_decode_samples != NULL));
+  AAD_ASSERT(decoder->set_header == 1);
+  AAD_ASSERT(buffer_num_channels >= decoder->header.num_channels);
+
+  header = &(decoder->header);
+#if AAD_DECODER_USE_AVX2
+  use_avx2 = AADDecoder_CanDecodeBlocksAVX2(header);
+#endif
+
+  blk = 0;
+  progress = 0;
+  read_offset = 0;
+  while ((blk < num_blocks) && (progress < buffer_num_samples) && (read_offset < data_size)) {
+    /* サンプル書き出し位置のセット */
+    for (ch = 0; ch < header->num_channels; ch++) {
+      buffer_ptr[ch] = &buffer[ch][progress];
+    }
+#if AAD_DECODER_USE_AVX2
+    /* 全サンプルを含むブロックがレーン数分あればまとめてデコード */
+    if (use_avx2 && ((num_blocks - blk) >= AAD_DECODER_NUM_AVX2_LANES)
+        && ((data_size - read_offset) >= (uint64_t)AAD_DECODER_NUM_AVX2_LANES * header->block_size)
+        && ((buffer_num_samples - progress) >= (uint64_t)AAD_DECODER_NUM_AVX2_LANES * header->num_samples_per_block)) {
+      num_block_decode_samples = AAD_DECODER_NUM_AVX2_LANES * header->num_samples_per_block;
+      AADDecoder_DecodeBlocksAVX2(decoder, &data[read_offset], buffer_ptr);
+      /* MS -> LR */
+      if (header->ch_process_method == AAD_CH_PROCESS_METHOD_MS) {
+        uint32_t smpl;
+        int32_t mid, side;
+        for (smpl = 0; smpl < num_block_decode_samples; smpl++) {
+          mid   = buffer_ptr[0][smpl];
+          side  = buffer_ptr[1][smpl];
+          buffer_ptr[0][smpl] = AAD_INNER_VAL(mid + side, INT16_MIN, INT16_MAX);
+          buffer_ptr[1][smpl] = AAD_INNER_VAL(mid - side, INT16_MIN, INT16_MAX);
+        }
+      }
+      blk         += AAD_DECODER_NUM_AVX2_LANES;
+      read_offset += (uint64_t)AAD_DECODER_NUM_AVX2_LANES * header->block_size;
+      progress    += num_block_decode_samples;
+      continue;
+    }
+#endif
+    /* 読み出しサイズの確定 */
+    read_block_size = (uint32_t)AAD_MIN_VAL(data_size - read_offset, header->block_size);
+    /* ブロックデコード */
+    if ((ret = AADDecoder_DecodeBlock(decoder,
+          &data[read_offset], read_block_size,
+          buffer_ptr, buffer_num_channels,
+          (uint32_t)AAD_MIN_VAL(buffer_num_samples - progress, header->num_samples_per_block),
+          &num_block_decode_samples)) != AAD_APIRESULT_OK) {
+      return ret;
+    }
+    /* 進捗更新 */
+    blk         += 1;
+    read_offset += read_block_size;
+    progress    += num_block_decode_samples;
+    AAD_ASSERT(progress <= buffer_num_samples);
+    AAD_ASSERT(read_offset <= data_size);
+  }
+
+  (*num_decode_samples) = progress;
+  return AAD_APIRESULT_OK;
+}
+
+/* 連続する複数ブロックをデコードしてサンプルバッファ記述子のoffset以降に書き出し */
+static AADApiResult AADDecoder_DecodeBlocksToBuffer(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size, uint64_t num_blocks,
+    const struct AADSampleBuffer *output, uint64_t offset, int32_t **scratch,
+    uint64_t *num_decode_samples)
+{
+  AADApiResult ret;
+  uint32_t ch, num_group_blocks;
+  uint64_t blk, progress, read_offset, num_group_samples;
+  const struct AADHeaderInfo *header = &(decoder->header);
+
+  AAD_ASSERT(offset <= output->num_samples);
+
+  /* 作業形式の記述子には直接デコード */
+  if (AADSampleBuffer_IsPlanarInt32(output)) {
+    int32_t *buffer_ptr[AAD_MAX_NUM_CHANNELS];
+    for (ch = 0; ch < header->num_channels; ch++) {
+      buffer_ptr[ch] = &(((int32_t *)output->channels[ch])[offset]);
+    }
+    return AADDecoder_DecodeBlocks(decoder, data, data_size, num_blocks,
+        buffer_ptr, header->num_channels, output->num_samples - offset, num_decode_samples);
+  }
+
+  AAD_ASSERT(scratch != NULL);
+
+  /* マルチブロックデコードの単位ごとに作業領域へデコードし、変換しながら書き出す */
+  blk = 0;
+  progress = 0;
+  read_offset = 0;
+  while ((blk < num_blocks) && ((offset + progress) < output->num_samples) && (read_offset < data_size)) {
+    num_group_blocks = (uint32_t)AAD_MIN_VAL(num_blocks - blk, AAD_DECODER_NUM_AVX2_LANES);
+    if ((ret = AADDecoder_DecodeBlocks(decoder,
+            &data[read_offset], data_size - read_offset, num_group_blocks,
+            scratch, header->num_channels,
+            AAD_MIN_VAL(num_group_blocks * header->num_samples_per_block, output->num_samples - offset - progress),
+            &num_group_samples)) != AAD_APIRESULT_OK) {
+      return ret;
+    }
+    for (ch = 0; ch < header->num_channels; ch++) {
+      AADSampleBuffer_WriteChannel(output, ch, offset + progress, (uint32_t)num_group_samples, scratch[ch]);
+    }
+    /* 進捗更新 */
+    blk         += num_group_blocks;
+    read_offset += (uint64_t)num_group_blocks * header->block_size;
+    progress    += num_group_samples;
+  }
+
+  (*num_decode_samples) = progress;
+  return AAD_APIRESULT_OK;
+}
+
+/* 記述子への書き出しに必要な作業領域を確保 */
+static int32_t *AADDecoder_AllocateScratch(
+    const struct AADHeaderInfo *header, const struct AADSampleBuffer *output, uint32_t num_scratches)
+{
+  AAD_ASSERT((header != NULL) && (output != NULL));
+
+  if (AADSampleBuffer_IsPlanarInt32(output)) {
+    return NULL;
+  }
+
+  return (int32_t *)malloc(sizeof(int32_t)
+      * num_scratches * header->num_channels * AAD_DECODER_NUM_AVX2_LANES * header->num_samples_per_block);
+}
+
 /* ヘッダ含めファイル全体をデコード */
 AADApiResult AADDecoder_DecodeWhole(
-    struct AADDecoder *decoder, const uint8_t *data, uint32_t data_size,
-    int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples)
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples)
+{
+  struct AADSampleBuffer output;
+
+  /* 引数チェック */
+  if ((decoder == NULL) || (data == NULL) || (buffer == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  AADSampleBuffer_SetPlanarInt32(&output, buffer,
+      AAD_MIN_VAL(buffer_num_channels, AAD_MAX_NUM_CHANNELS), buffer_num_samples);
+  return AADDecoder_DecodeWholeToBuffer(decoder, data, data_size, &output);
+}
+
+/* ヘッダ含めファイル全体をサンプルバッファ記述子にデコード */
+AADApiResult AADDecoder_DecodeWholeToBuffer(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    const struct AADSampleBuffer *output)
 {
   AADApiResult ret;
-  uint32_t progress, ch, read_offset, read_block_size, num_decode_samples;
+  AADError err;
+  uint32_t ch;
+  uint64_t num_samples, num_blocks, num_decode_samples;
+  struct AADHeaderInfo tmp_header;
+  const struct AADHeaderInfo *header;
+  int32_t *scratch_work;
+  int32_t *scratch[AAD_MAX_NUM_CHANNELS];
+
+  /* 引数チェック */
+  if ((decoder == NULL) || (data == NULL) || (output == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダデコードとデコーダへのセット */
+  if ((ret = AADDecoder_DecodeHeader(data, data_size, &tmp_header)) 
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  if ((ret = AADDecoder_SetHeader(decoder, &tmp_header))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  header = &(decoder->header);
+  if ((ret = AADDecoder_CalculateNumSamples(header, data_size, &num_samples))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* バッファチェック */
+  if ((err = AADSampleBuffer_Check(output, header->num_channels, num_samples)) != AAD_ERROR_OK) {
+    return (err == AAD_ERROR_INSUFFICIENT_BUFFER)
+      ? AAD_APIRESULT_INSUFFICIENT_BUFFER : AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 変換用の作業領域確保 */
+  scratch_work = AADDecoder_AllocateScratch(header, output, 1);
+  if ((scratch_work == NULL) && !AADSampleBuffer_IsPlanarInt32(output)) {
+    return AAD_APIRESULT_NG;
+  }
+  for (ch = 0; ch < header->num_channels; ch++) {
+    scratch[ch] = (scratch_work != NULL)
+      ? &scratch_work[ch * AAD_DECODER_NUM_AVX2_LANES * header->num_samples_per_block] : NULL;
+  }
+
+  /* 全ブロックをデコード */
+  num_blocks = (num_samples + header->num_samples_per_block - 1) / header->num_samples_per_block;
+  ret = AADDecoder_DecodeBlocksToBuffer(decoder,
+      data + AAD_HEADER_SIZE, data_size - AAD_HEADER_SIZE, num_blocks,
+      output, 0, scratch, &num_decode_samples);
+
+  free(scratch_work);
+  return ret;
+}
+
+/* ワーカが担当するブロック範囲をデコード */
+static void *AADDecodeWorker_Run(void *arg)
+{
+  struct AADDecodeWorker *worker = (struct AADDecodeWorker *)arg;
+  const struct AADHeaderInfo *header = &(worker->decoder.header);
+  uint64_t progress, read_offset, num_decode_samples;
+
+  AAD_ASSERT(worker != NULL);
+
+  /* ブロックサイズとサンプル数は固定なので、読み出し位置と書き出し位置は直接計算できる */
+  progress = worker->start_block * header->num_samples_per_block;
+  read_offset = AAD_HEADER_SIZE + worker->start_block * header->block_size;
+  AAD_ASSERT(progress < worker->output.num_samples);
+  AAD_ASSERT(read_offset < worker->data_size);
+
+  /* 担当範囲のブロックをデコード */
+  worker->result = AADDecoder_DecodeBlocksToBuffer(&(worker->decoder),
+      &(worker->data[read_offset]), worker->data_size - read_offset, worker->end_block - worker->start_block,
+      &(worker->output), progress, worker->scratch, &num_decode_samples);
+
+  return NULL;
+}
+
+/* ヘッダ含めファイル全体を複数スレッドでデコード */
+AADApiResult AADDecoder_DecodeWholeParallel(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples,
+    uint32_t num_threads)
+{
+  struct AADSampleBuffer output;
+
+  /* 引数チェック */
+  if ((decoder == NULL) || (data == NULL) || (buffer == NULL) || (num_threads == 0)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  AADSampleBuffer_SetPlanarInt32(&output, buffer,
+      AAD_MIN_VAL(buffer_num_channels, AAD_MAX_NUM_CHANNELS), buffer_num_samples);
+  return AADDecoder_DecodeWholeParallelToBuffer(decoder, data, data_size, &output, num_threads);
+}
+
+/* ヘッダ含めファイル全体をサンプルバッファ記述子に複数スレッドでデコード */
+AADApiResult AADDecoder_DecodeWholeParallelToBuffer(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    const struct AADSampleBuffer *output, uint32_t num_threads)
+{
+  AADApiResult ret;
+  AADError err;
+  uint32_t i, ch, num_workers, scratch_size;
+  uint64_t num_samples, num_blocks, num_data_blocks;
+  struct AADHeaderInfo tmp_header;
+  const struct AADHeaderInfo *header;
+  struct AADDecodeWorker *workers;
+  pthread_t *threads;
+  uint8_t *thread_created;
+  int32_t *scratch_work;
+
+  /* 引数チェック */
+  if ((decoder == NULL) || (data == NULL) || (output == NULL) || (num_threads == 0)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダデコードとデコーダへのセット */
+  if ((ret = AADDecoder_DecodeHeader(data, data_size, &tmp_header))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  if ((ret = AADDecoder_SetHeader(decoder, &tmp_header))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  header = &(decoder->header);
+  if ((ret = AADDecoder_CalculateNumSamples(header, data_size, &num_samples))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* バッファチェック */
+  if ((err = AADSampleBuffer_Check(output, header->num_channels, num_samples)) != AAD_ERROR_OK) {
+    return (err == AAD_ERROR_INSUFFICIENT_BUFFER)
+      ? AAD_APIRESULT_INSUFFICIENT_BUFFER : AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* デコードするブロック数: サンプル数とデータサイズのうち先に尽きる方で決まる */
+  num_blocks = (num_samples + header->num_samples_per_block - 1) / header->num_samples_per_block;
+  num_data_blocks = (data_size - AAD_HEADER_SIZE + header->block_size - 1) / header->block_size;
+  num_blocks = AAD_MIN_VAL(num_blocks, num_data_blocks);
+
+  /* 並列化の余地がなければ逐次処理 */
+  num_workers = (uint32_t)AAD_MIN_VAL(num_threads, num_blocks);
+  if (num_workers <= 1) {
+    return AADDecoder_DecodeWholeToBuffer(decoder, data, data_size, output);
+  }
+
+  /* ワーカ領域確保 */
+  workers = (struct AADDecodeWorker *)malloc(sizeof(struct AADDecodeWorker) * num_workers);
+  threads = (pthread_t *)malloc(sizeof(pthread_t) * num_workers);
+  thread_created = (uint8_t *)malloc(sizeof(uint8_t) * num_workers);
+  scratch_work = AADDecoder_AllocateScratch(header, output, num_workers);
+  if ((workers == NULL) || (threads == NULL) || (thread_created == NULL)
+      || ((scratch_work == NULL) && !AADSampleBuffer_IsPlanarInt32(output))) {
+    free(workers);
+    free(threads);
+    free(thread_created);
+    free(scratch_work);
+    return AAD_APIRESULT_NG;
+  }
+  scratch_size = AAD_DECODER_NUM_AVX2_LANES * header->num_samples_per_block;
+
+  /* ブロックはヘッダに状態を全て持っており独立にデコードできるため、連続したブロック範囲ごとに分割 */
+  for (i = 0; i < num_workers; i++) {
+    struct AADDecodeWorker *worker = &workers[i];
+    worker->decoder             = (*decoder);
+    worker->data                = data;
+    worker->data_size           = data_size;
+    worker->output              = (*output);
+    for (ch = 0; ch < header->num_channels; ch++) {
+      worker->scratch[ch] = (scratch_work != NULL)
+        ? &scratch_work[(i * header->num_channels + ch) * scratch_size] : NULL;
+    }
+    worker->start_block         = (num_blocks * i) / num_workers;
+    worker->end_block           = (num_blocks * (i + 1)) / num_workers;
+    worker->result              = AAD_APIRESULT_OK;
+  }
+
+  /* 先頭以外のワーカをスレッドで起動 先頭は呼び出しスレッドで処理 */
+  /* スレッドが作れなかった場合は呼び出しスレッドで処理 */
+  for (i = 1; i < num_workers; i++) {
+    thread_created[i] = (pthread_create(&threads[i], NULL, AADDecodeWorker_Run, &workers[i]) == 0) ? 1 : 0;
+  }
+  AADDecodeWorker_Run(&workers[0]);
+  for (i = 1; i < num_workers; i++) {
+    if (thread_created[i] == 1) {
+      pthread_join(threads[i], NULL);
+    } else {
+      AADDecodeWorker_Run(&workers[i]);
+    }
+  }
+
+  /* 結果集約: 逐次処理と同じく先頭側のエラーを優先 */
+  ret = AAD_APIRESULT_OK;
+  for (i = 0; i < num_workers; i++) {
+    if (workers[i].result != AAD_APIRESULT_OK) {
+      ret = workers[i].result;
+      break;
+    }
+  }
+
+  free(workers);
+  free(threads);
+  free(thread_created);
+  free(scratch_work);
+
+  return ret;
+}
+
+/* ヘッダ取得 */
+AADApiResult AADDecoder_GetHeader(
+    const struct AADDecoder *decoder, struct AADHeaderInfo *header)
+{
+  /* 引数チェック */
+  if ((decoder == NULL) || (header == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダがまだセットされていない */
+  if (decoder->set_header != 1) {
+    return AAD_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  (*header) = decoder->header;
+  return AAD_APIRESULT_OK;
+}
+
+/* ストリーミングデコードの開始 */
+AADApiResult AADDecoder_BeginDecodeStream(struct AADDecoder *decoder)
+{
+  /* 引数チェック */
+  if (decoder == NULL) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ファイルヘッダ待ちから開始 */
+  decoder->set_header = 0;
+  decoder->stream_state = AAD_DECODE_STREAM_STATE_FILE_HEADER;
+  decoder->stream_num_pending_bytes = 0;
+  decoder->stream_num_samples = 0;
+  decoder->stream_block_num_samples = 0;
+  decoder->stream_block_offset = 0;
+  decoder->stream_num_output_samples = 0;
+  decoder->stream_output_offset = 0;
+
+  return AAD_APIRESULT_OK;
+}
+
+/* ストリーミングデコード */
+AADApiResult AADDecoder_DecodeStream(
+    struct AADDecoder *decoder,
+    const uint8_t *data, uint32_t data_size, uint32_t *num_consumed_bytes,
+    int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples,
+    uint32_t *num_decode_samples)
+{
+  AADApiResult ret;
+  uint32_t ch, smpl, read_offset, write_offset;
+  const struct AADHeaderInfo *header;
+
+  /* 引数チェック */
+  if ((decoder == NULL) || (data == NULL) || (num_consumed_bytes == NULL)
+      || (buffer == NULL) || (num_decode_samples == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  header = &(decoder->header);
+
+  read_offset = 0;
+  write_offset = 0;
+  while (1) {
+    uint32_t num_required_bytes, num_copy_bytes, num_block_samples;
+
+    /* デコード済みで未出力のサンプルを出力 */
+    if (decoder->stream_output_offset < decoder->stream_num_output_samples) {
+      const uint32_t num_write_samples
+        = AAD_MIN_VAL(decoder->stream_num_output_samples - decoder->stream_output_offset,
+            buffer_num_samples - write_offset);
+      for (ch = 0; ch < header->num_channels; ch++) {
+        memcpy(&buffer[ch][write_offset], &(decoder->stream_output[ch][decoder->stream_output_offset]),
+            sizeof(int32_t) * num_write_samples);
+      }
+      write_offset += num_write_samples;
+      decoder->stream_output_offset += num_write_samples;
+      /* 出力バッファが埋まった */
+      if (decoder->stream_output_offset < decoder->stream_num_output_samples) {
+        break;
+      }
+    }
+
+    /* 全サンプル出力済み or 入力を使い切った */
+    if ((decoder->stream_state == AAD_DECODE_STREAM_STATE_END) || (read_offset >= data_size)) {
+      break;
+    }
+
+    /* 現在ブロックに含まれるサンプル数（最終ブロックでは少なくなる） */
+    num_block_samples = 0;
+    if (decoder->set_header == 1) {
+      num_block_samples = (uint32_t)AAD_MIN_VAL(header->num_samples_per_block,
+          header->num_samples - (decoder->stream_num_samples - decoder->stream_block_num_samples));
+    }
+
+    /* 次の処理単位に必要なデータサイズ */
+    switch (decoder->stream_state) {
+      case AAD_DECODE_STREAM_STATE_FILE_HEADER:
+        num_required_bytes = AAD_HEADER_SIZE;
+        break;
+      case AAD_DECODE_STREAM_STATE_BLOCK_HEADER:
+        num_required_bytes = AAD_BLOCK_HEADER_SIZE(header->num_channels);
+        break;
+      case AAD_DECODE_STREAM_STATE_BLOCK_DATA:
+        /* 全チャンネル分のデータ単位 */
+        num_required_bytes = ((header->bits_per_sample == 3) ? 3U : 1U) * header->num_channels;
+        break;
+      case AAD_DECODE_STREAM_STATE_BLOCK_PADDING:
+        num_required_bytes = header->block_size - decoder->stream_block_offset;
+        break;
+      default:
+        return AAD_APIRESULT_NG;
+    }
+
+    num_copy_bytes = AAD_MIN_VAL(num_required_bytes - decoder->stream_num_pending_bytes, data_size - read_offset);
+
+    /* 未使用領域は読み捨てる */
+    if (decoder->stream_state == AAD_DECODE_STREAM_STATE_BLOCK_PADDING) {
+      read_offset += num_copy_bytes;
+      decoder->stream_block_offset += num_copy_bytes;
+      if (decoder->stream_block_offset == header->block_size) {
+        decoder->stream_block_offset = 0;
+        decoder->stream_block_num_samples = 0;
+        decoder->stream_state = AAD_DECODE_STREAM_STATE_BLOCK_HEADER;
+      }
+      continue;
+    }
+
+    /* 入力を溜める */
+    memcpy(&(decoder->stream_pending[decoder->stream_num_pending_bytes]), &data[read_offset], num_copy_bytes);
+    decoder->stream_num_pending_bytes += num_copy_bytes;
+    read_offset += num_copy_bytes;
+    if (decoder->stream_num_pending_bytes < num_required_bytes) {
+      AAD_ASSERT(read_offset == data_size);
+      break;
+    }
+    decoder->stream_num_pending_bytes = 0;
+
+    /* 揃った処理単位をデコード */
+    decoder->stream_output_offset = 0;
+    switch (decoder->stream_state) {
+      case AAD_DECODE_STREAM_STATE_FILE_HEADER:
+        {
+          struct AADHeaderInfo tmp_header;
+          if ((ret = AADDecoder_DecodeHeader(decoder->stream_pending, AAD_HEADER_SIZE, &tmp_header))
+              != AAD_APIRESULT_OK) {
+            return ret;
+          }
+          /* バッファサイズチェック */
+          if (buffer_num_channels < tmp_header.num_channels) {
+            return AAD_APIRESULT_INSUFFICIENT_BUFFER;
+          }
+          if ((ret = AADDecoder_SetHeader(decoder, &tmp_header)) != AAD_APIRESULT_OK) {
+            return ret;
+          }
+          decoder->stream_num_output_samples = 0;
+          decoder->stream_state = AAD_DECODE_STREAM_STATE_BLOCK_HEADER;
+        }
+        continue;
+      case AAD_DECODE_STREAM_STATE_BLOCK_HEADER:
+        /* 先頭サンプルはヘッダに入っている */
+        AADDecoder_DecodeBlockHeader(decoder, decoder->stream_pending);
+        decoder->stream_num_output_samples = AAD_MIN_VAL(AAD_FILTER_ORDER, num_block_samples);
+        for (ch = 0; ch < header->num_channels; ch++) {
+          for (smpl = 0; smpl < decoder->stream_num_output_samples; smpl++) {
+            decoder->stream_output[ch][smpl] = decoder->processor[ch].history[AAD_FILTER_ORDER - smpl - 1];
+          }
+        }
+        break;
+      case AAD_DECODE_STREAM_STATE_BLOCK_DATA:
+        for (ch = 0; ch < header->num_channels; ch++) {
+          const uint32_t unit_size = num_required_bytes / header->num_channels;
+          AADDecodeProcessor_DecodeUnit(&(decoder->processor[ch]),
+              &(decoder->stream_pending[ch * unit_size]), (uint8_t)header->bits_per_sample,
+              decoder->stream_output[ch]);
+        }
+        /* データ単位のサンプル数（ブロック末尾では切り詰める） */
+        decoder->stream_num_output_samples
+          = AAD_MIN_VAL((header->bits_per_sample == 3) ? 8U : (8U / header->bits_per_sample),
+              num_block_samples - decoder->stream_block_num_samples);
+        break;
+      default:
+        return AAD_APIRESULT_NG;
+    }
+
+    /* MS -> LR */
+    if (header->ch_process_method == AAD_CH_PROCESS_METHOD_MS) {
+      int32_t mid, side;
+      for (smpl = 0; smpl < decoder->stream_num_output_samples; smpl++) {
+        mid   = decoder->stream_output[0][smpl];
+        side  = decoder->stream_output[1][smpl];
+        decoder->stream_output[0][smpl] = AAD_INNER_VAL(mid + side, INT16_MIN, INT16_MAX);
+        decoder->stream_output[1][smpl] = AAD_INNER_VAL(mid - side, INT16_MIN, INT16_MAX);
+      }
+    }
+
+    /* 進捗更新 */
+    decoder->stream_num_samples += decoder->stream_num_output_samples;
+    decoder->stream_block_num_samples += decoder->stream_num_output_samples;
+    decoder->stream_block_offset += num_required_bytes;
+
+    /* 次の状態へ遷移 */
+    if (decoder->stream_num_samples >= header->num_samples) {
+      decoder->stream_state = AAD_DECODE_STREAM_STATE_END;
+    } else if (decoder->stream_block_num_samples < num_block_samples) {
+      decoder->stream_state = AAD_DECODE_STREAM_STATE_BLOCK_DATA;
+    } else if (decoder->stream_block_offset < header->block_size) {
+      decoder->stream_state = AAD_DECODE_STREAM_STATE_BLOCK_PADDING;
+    } else {
+      decoder->stream_block_offset = 0;
+      decoder->stream_block_num_samples = 0;
+      decoder->stream_state = AAD_DECODE_STREAM_STATE_BLOCK_HEADER;
+    }
+  }
+
+  /* 成功終了 */
+  (*num_consumed_bytes) = read_offset;
+  (*num_decode_samples) = write_offset;
+  return AAD_APIRESULT_OK;
+}
+
+/* サンプル位置を含むブロックの位置を計算 */
+AADApiResult AADDecoder_CalculateSeekPosition(
+    const struct AADHeaderInfo *header, uint64_t sample_position,
+    uint64_t *block_byte_offset, uint64_t *block_start_sample)
+{
+  uint64_t block_index;
+
+  /* 引数チェック */
+  if ((header == NULL) || (block_byte_offset == NULL) || (block_start_sample == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 範囲外のサンプル位置 */
+  if (sample_position >= header->num_samples) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダの内容が不正 */
+  if (AADDecoder_CheckHeaderFormat(header) != AAD_ERROR_OK) {
+    return AAD_APIRESULT_INVALID_FORMAT;
+  }
+
+  /* ブロックはサイズ・サンプル数ともに固定なので直接計算できる */
+  block_index = sample_position / header->num_samples_per_block;
+  (*block_byte_offset) = AAD_HEADER_SIZE + block_index * header->block_size;
+  (*block_start_sample) = block_index * header->num_samples_per_block;
+
+  return AAD_APIRESULT_OK;
+}
+
+/* ヘッダ含むファイルに含まれる1チャンネルあたりのサンプル数を計算 */
+AADApiResult AADDecoder_CalculateNumSamples(
+    const struct AADHeaderInfo *header, uint64_t data_size, uint64_t *num_samples)
+{
+  uint32_t unit_size, num_unit_samples, last_block_size, num_last_block_samples;
+  uint64_t num_full_blocks;
+
+  /* 引数チェック */
+  if ((header == NULL) || (num_samples == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* ヘッダの内容が不正 */
+  if (AADDecoder_CheckHeaderFormat(header) != AAD_ERROR_OK) {
+    return AAD_APIRESULT_INVALID_FORMAT;
+  }
+
+  /* 総サンプル数が分かっていればそのまま */
+  if (header->num_samples != AAD_NUM_SAMPLES_UNKNOWN) {
+    (*num_samples) = header->num_samples;
+    return AAD_APIRESULT_OK;
+  }
+
+  /* ヘッダのサイズに満たない */
+  if (data_size < AAD_HEADER_SIZE) {
+    return AAD_APIRESULT_INSUFFICIENT_DATA;
+  }
+
+  /* 全チャンネル分のデータ単位のサイズ・サンプル数 */
+  unit_size = ((header->bits_per_sample == 3) ? 3U : 1U) * header->num_channels;
+  num_unit_samples = (header->bits_per_sample == 3) ? 8U : (8U / header->bits_per_sample);
+
+  /* 揃ったブロックは全サンプルを含む */
+  num_full_blocks = (data_size - AAD_HEADER_SIZE) / header->block_size;
+  last_block_size = (uint32_t)((data_size - AAD_HEADER_SIZE) % header->block_size);
+
+  /* 最終ブロックはブロックヘッダと揃ったデータ単位の分だけ */
+  num_last_block_samples = 0;
+  if (last_block_size >= AAD_BLOCK_HEADER_SIZE(header->num_channels)) {
+    num_last_block_samples = AAD_FILTER_ORDER
+      + ((last_block_size - AAD_BLOCK_HEADER_SIZE(header->num_channels)) / unit_size) * num_unit_samples;
+    num_last_block_samples = AAD_MIN_VAL(num_last_block_samples, header->num_samples_per_block);
+  }
+
+  (*num_samples) = num_full_blocks * header->num_samples_per_block + num_last_block_samples;
+  return AAD_APIRESULT_OK;
+}
+
+/* ブロック内の指定サンプル位置以降をデコード */
+static AADApiResult AADDecoder_DecodeBlockFrom(
+    struct AADDecoder *decoder,
+    const uint8_t *data, uint32_t data_size, uint32_t start_sample,
+    int32_t **buffer, uint32_t buffer_num_samples, uint32_t *num_decode_samples)
+{
+  uint32_t ch, smpl, progress, unit_size, num_unit_samples, num_block_samples, write_offset;
+  int32_t outbuf[AAD_MAX_NUM_CHANNELS][8];
   const uint8_t *read_pos;
+  const struct AADHeaderInfo *header;
+
+  AAD_ASSERT((decoder != NULL) && (data != NULL) && (buffer != NULL) && (num_decode_samples != NULL));
+  AAD_ASSERT(decoder->set_header == 1);
+
+  header = &(decoder->header);
+
+  /* チャンネルあたりのデータ単位のサイズ・サンプル数 */
+  switch (header->bits_per_sample) {
+    case 4: unit_size = 1; num_unit_samples = 2; break;
+    case 3: unit_size = 3; num_unit_samples = 8; break;
+    case 2: unit_size = 1; num_unit_samples = 4; break;
+    default: return AAD_APIRESULT_INVALID_FORMAT;
+  }
+
+  /* ブロックヘッダのサイズに満たない */
+  if (data_size < AAD_BLOCK_HEADER_SIZE(header->num_channels)) {
+    return AAD_APIRESULT_INSUFFICIENT_DATA;
+  }
+
+  /* デコードが必要なサンプル数（ブロック内の開始位置からバッファが埋まるまで） */
+  AAD_ASSERT(start_sample < header->num_samples_per_block);
+  num_block_samples = AAD_MIN_VAL(header->num_samples_per_block, start_sample + buffer_num_samples);
+
+  /* ブロックヘッダデコード */
+  AADDecoder_DecodeBlockHeader(decoder, data);
+  read_pos = data + AAD_BLOCK_HEADER_SIZE(header->num_channels);
+  for (ch = 0; ch < header->num_channels; ch++) {
+    for (smpl = 0; smpl < AAD_FILTER_ORDER; smpl++) {
+      outbuf[ch][smpl] = decoder->processor[ch].history[AAD_FILTER_ORDER - smpl - 1];
+    }
+  }
+
+  write_offset = 0;
+  progress = 0;
+  while (progress < num_block_samples) {
+    uint32_t num_samples, begin;
+    /* 先頭はヘッダのサンプル、以降はデータ単位ごとにデコード */
+    if (progress == 0) {
+      num_samples = AAD_FILTER_ORDER;
+    } else {
+      if ((uint32_t)(read_pos - data) + unit_size * header->num_channels > data_size) {
+        return AAD_APIRESULT_INSUFFICIENT_DATA;
+      }
+      for (ch = 0; ch < header->num_channels; ch++) {
+        AADDecodeProcessor_DecodeUnit(&(decoder->processor[ch]),
+            read_pos, (uint8_t)header->bits_per_sample, outbuf[ch]);
+        read_pos += unit_size;
+      }
+      num_samples = num_unit_samples;
+    }
+    num_samples = AAD_MIN_VAL(num_samples, num_block_samples - progress);
+    /* 開始位置より前のサンプルは捨てる */
+    if (progress + num_samples > start_sample) {
+      begin = (progress < start_sample) ? (start_sample - progress) : 0;
+      for (ch = 0; ch < header->num_channels; ch++) {
+        memcpy(&buffer[ch][write_offset], &outbuf[ch][begin], sizeof(int32_t) * (num_samples - begin));
+      }
+      /* MS -> LR */
+      if (header->ch_process_method == AAD_CH_PROCESS_METHOD_MS) {
+        int32_t mid, side;
+        for (smpl = write_offset; smpl < write_offset + num_samples - begin; smpl++) {
+          mid   = buffer[0][smpl];
+          side  = buffer[1][smpl];
+          buffer[0][smpl] = AAD_INNER_VAL(mid + side, INT16_MIN, INT16_MAX);
+          buffer[1][smpl] = AAD_INNER_VAL(mid - side, INT16_MIN, INT16_MAX);
+        }
+      }
+      write_offset += num_samples - begin;
+    }
+    progress += num_samples;
+  }
+
+  (*num_decode_samples) = write_offset;
+  return AAD_APIRESULT_OK;
+}
+
+/* 指定したサンプル範囲をデコード */
+AADApiResult AADDecoder_DecodeRange(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    uint64_t start_sample, uint64_t num_samples,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples,
+    uint64_t *num_decode_samples)
+{
+  AADApiResult ret;
+  uint32_t ch, num_first_block_samples;
+  uint64_t progress, read_offset, block_start_sample, num_total_samples, num_range_samples, num_block_decode_samples;
   int32_t *buffer_ptr[AAD_MAX_NUM_CHANNELS];
   struct AADHeaderInfo tmp_header;
   const struct AADHeaderInfo *header;
 
   /* 引数チェック */
-  if ((decoder == NULL) || (data == NULL) || (buffer == NULL)) {
+  if ((decoder == NULL) || (data == NULL)
+      || (buffer == NULL) || (num_decode_samples == NULL)) {
     return AAD_APIRESULT_INVALID_ARGUMENT;
   }
 
   /* ヘッダデコードとデコーダへのセット */
-  if ((ret = AADDecoder_DecodeHeader(data, data_size, &tmp_header)) 
+  if ((ret = AADDecoder_DecodeHeader(data, data_size, &tmp_header))
       != AAD_APIRESULT_OK) {
     return ret;
   }
@@ -502,37 +1685,62 @@ AADApiResult AADDecoder_DecodeWhole(
   }
   header = &(decoder->header);
 
+  /* 開始位置を含むブロックの位置を計算 */
+  if ((ret = AADDecoder_CalculateSeekPosition(header, start_sample,
+          &read_offset, &block_start_sample)) != AAD_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* デコードするサンプル数（末尾を超える分は切り詰める） */
+  if ((ret = AADDecoder_CalculateNumSamples(header, data_size, &num_total_samples))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  /* 総サンプル数が不明のときは開始位置のデータがない場合がある */
+  if (start_sample >= num_total_samples) {
+    return AAD_APIRESULT_INSUFFICIENT_DATA;
+  }
+  num_range_samples = AAD_MIN_VAL(num_samples, num_total_samples - start_sample);
+
   /* バッファサイズチェック */
   if ((buffer_num_channels < header->num_channels)
-      || (buffer_num_samples < header->num_samples)) {
+      || (buffer_num_samples < num_range_samples)) {
     return AAD_APIRESULT_INSUFFICIENT_BUFFER;
   }
 
-  progress = 0;
-  read_offset = AAD_HEADER_SIZE;
-  read_pos = data + AAD_HEADER_SIZE;
-  while ((progress < header->num_samples) && (read_offset < data_size)) {
-    /* 読み出しサイズの確定 */
-    read_block_size = AAD_MIN_VAL(data_size - read_offset, header->block_size);
-    /* サンプル書き出し位置のセット */
+  /* 開始ブロックのデータがない */
+  if (read_offset >= data_size) {
+    return AAD_APIRESULT_INSUFFICIENT_DATA;
+  }
+
+  /* 開始ブロックは途中からデコード */
+  if ((ret = AADDecoder_DecodeBlockFrom(decoder,
+          data + read_offset, (uint32_t)AAD_MIN_VAL(data_size - read_offset, header->block_size),
+          (uint32_t)(start_sample - block_start_sample),
+          buffer, (uint32_t)AAD_MIN_VAL(num_range_samples, header->num_samples_per_block),
+          &num_first_block_samples)) != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  progress = num_first_block_samples;
+  read_offset += header->block_size;
+
+  /* 後続ブロックはそのままデコード */
+  if ((progress < num_range_samples) && (read_offset < data_size)) {
+    const uint64_t num_blocks
+      = (num_range_samples - progress + header->num_samples_per_block - 1) / header->num_samples_per_block;
     for (ch = 0; ch < header->num_channels; ch++) {
       buffer_ptr[ch] = &buffer[ch][progress];
     }
-    /* ブロックデコード */
-    if ((ret = AADDecoder_DecodeBlock(decoder,
-          read_pos, read_block_size,
-          buffer_ptr, buffer_num_channels, buffer_num_samples - progress, 
-          &num_decode_samples)) != AAD_APIRESULT_OK) {
+    if ((ret = AADDecoder_DecodeBlocks(decoder,
+            data + read_offset, data_size - read_offset, num_blocks,
+            buffer_ptr, buffer_num_channels, num_range_samples - progress,
+            &num_block_decode_samples)) != AAD_APIRESULT_OK) {
       return ret;
     }
-    /* 進捗更新 */
-    read_pos    += read_block_size;
-    read_offset += read_block_size;
-    progress    += num_decode_samples;
-    AAD_ASSERT(progress <= buffer_num_samples);
-    AAD_ASSERT(read_offset <= data_size);
+    progress += num_block_decode_samples;
   }
 
   /* 成功終了 */
+  (*num_decode_samples) = progress;
   return AAD_APIRESULT_OK;
 }
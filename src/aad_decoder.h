@@ -13,7 +13,7 @@ extern "C" {
 
 /* ヘッダデコード */
 AADApiResult AADDecoder_DecodeHeader(
-    const uint8_t *data, uint32_t data_size, struct AADHeaderInfo *header_info);
+    const uint8_t *data, uint64_t data_size, struct AADHeaderInfo *header_info);
 
 /* デコーダワークサイズ計算 */
 int32_t AADDecoder_CalculateWorkSize(void);
@@ -38,8 +38,68 @@ AADApiResult AADDecoder_DecodeBlock(
 /* ヘッダ含めファイル全体をデコード */
 AADApiResult AADDecoder_DecodeWhole(
     struct AADDecoder *decoder,
-    const uint8_t *data, uint32_t data_size,
-    int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples);
+    const uint8_t *data, uint64_t data_size,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples);
+
+/* ヘッダ含めファイル全体をサンプルバッファ記述子にデコード */
+/* 補足）チャンネル処理の逆変換まで済ませたサンプルを記述子の型・並びに変換して書き出す */
+AADApiResult AADDecoder_DecodeWholeToBuffer(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    const struct AADSampleBuffer *output);
+
+/* ヘッダ含めファイル全体を複数スレッドでデコード */
+/* 補足）ブロック単位で分割して並列処理する。結果はAADDecoder_DecodeWholeと一致 */
+AADApiResult AADDecoder_DecodeWholeParallel(
+    struct AADDecoder *decoder,
+    const uint8_t *data, uint64_t data_size,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples,
+    uint32_t num_threads);
+
+/* ヘッダ含めファイル全体をサンプルバッファ記述子に複数スレッドでデコード */
+AADApiResult AADDecoder_DecodeWholeParallelToBuffer(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    const struct AADSampleBuffer *output, uint32_t num_threads);
+
+/* サンプル位置を含むブロックの位置を計算 */
+/* 補足）block_byte_offsetはファイル先頭からのバイト位置、block_start_sampleはブロック先頭のサンプル位置 */
+AADApiResult AADDecoder_CalculateSeekPosition(
+    const struct AADHeaderInfo *header, uint64_t sample_position,
+    uint64_t *block_byte_offset, uint64_t *block_start_sample);
+
+/* ヘッダ含むファイルに含まれる1チャンネルあたりのサンプル数を計算 */
+/* 補足）総サンプル数が不明（AAD_NUM_SAMPLES_UNKNOWN）のヘッダではデータサイズから求める。 */
+/*       最終ブロックが途中で切れている場合は揃っているデータ単位までを数える */
+AADApiResult AADDecoder_CalculateNumSamples(
+    const struct AADHeaderInfo *header, uint64_t data_size, uint64_t *num_samples);
+
+/* ヘッダ含むファイルから指定したサンプル範囲をデコード */
+/* 補足）開始位置を含むブロック以降のみをデコードし、開始位置より前のサンプルは捨てる。 */
+/*       ファイル末尾を超える範囲は切り詰め、実際にデコードしたサンプル数をnum_decode_samplesに返す */
+AADApiResult AADDecoder_DecodeRange(
+    struct AADDecoder *decoder, const uint8_t *data, uint64_t data_size,
+    uint64_t start_sample, uint64_t num_samples,
+    int32_t **buffer, uint32_t buffer_num_channels, uint64_t buffer_num_samples,
+    uint64_t *num_decode_samples);
+
+/* デコーダにセットされたヘッダの取得 */
+AADApiResult AADDecoder_GetHeader(
+    const struct AADDecoder *decoder, struct AADHeaderInfo *header);
+
+/* ストリーミングデコードの開始 */
+AADApiResult AADDecoder_BeginDecodeStream(struct AADDecoder *decoder);
+
+/* ストリーミングデコード */
+/* 補足）ヘッダを含むデータを任意の長さの断片で入力できる。揃わない入力はデコーダ内に保持し、 */
+/*       ブロックヘッダ・データ単位（4bit:1byte, 3bit:3byte, 2bit:1byteを全チャンネル分）が揃うたびにサンプルを出力する。 */
+/*       出力バッファが埋まると入力途中でも終了するので、消費されなかった分は再度入力すること。 */
+/*       （出力しきれなかったサンプルはデコーダ内に保持し、次の呼び出しで先に出力する） */
+/*       ヘッダはファイルヘッダを読んだ後にAADDecoder_GetHeaderで取得できる。 */
+/*       総サンプル数が不明のヘッダでは終端がないため、入力がある限りデコードを続ける */
+AADApiResult AADDecoder_DecodeStream(
+    struct AADDecoder *decoder,
+    const uint8_t *data, uint32_t data_size, uint32_t *num_consumed_bytes,
+    int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples,
+    uint32_t *num_decode_samples);
 
 #ifdef __cplusplus
 }
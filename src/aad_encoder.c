@@ -1,10 +1,27 @@
 #include "aad_encoder.h"
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
+#include <pthread.h>
+
+/* AVX2による試行の同時評価の利用可否（AAD_DISABLE_SIMDで無効化） */
+#if !defined(AAD_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AAD_ENCODER_USE_AVX2 1
+#include <immintrin.h>
+#else
+#define AAD_ENCODER_USE_AVX2 0
+#endif
+
+/* 同時に二乗誤差和を計測するレーン数（チャンネルごとに基準値計測と試行の2本） */
+#define AAD_ENCODER_NUM_LANES (2 * AAD_MAX_NUM_CHANNELS)
+/* ブロックエンコードで一度に詰める符号数 */
+/* 補足）2の冪にしてデータ単位・チャンネル数・バイト境界のいずれとも割り切れるようにする */
+#define AAD_ENCODER_CODE_BUFFER_SIZE 1024
+/* 独立探索で候補の初期ステップサイズインデックスをずらす幅 */
+#define AAD_ENCODER_SEARCH_STEPSIZE_INDEX_OFFSET AAD_TABLES_INDEX_TO_FLOAT(2)
 #include "aad_internal.h"
 #include "byte_array.h"
 #include "aad_tables.h"
+#include "aad_sample_buffer.h"
 
 /* エンコード処理ハンドル */
 struct AADEncodeProcessor {
@@ -21,11 +38,57 @@ struct AADEncoder {
   struct AADEncodeProcessor processor[AAD_MAX_NUM_CHANNELS];
   uint8_t                   alloced_by_own;
   uint8_t                   num_encode_trials;
-  int32_t                   *input_buffer[AAD_MAX_NUM_CHANNELS];
-  int32_t                   *work_buffer[AAD_MAX_NUM_CHANNELS];   /* 作業領域 */
+  AADSearchMethod           search_method;
+  int32_t                   *input_buffer[AAD_MAX_NUM_CHANNELS];        /* 現在ブロックの変換済み入力 */
+  int32_t                   *prev_input_buffer[AAD_MAX_NUM_CHANNELS];   /* 直前ブロックの変換済み入力 */
+  uint8_t                   prev_input_buffered;  /* 直前ブロックの変換済み入力を保持しているか */
+  int32_t                   *stream_buffer[AAD_MAX_NUM_CHANNELS];       /* ストリーミング時の現在ブロック入力 */
+  uint32_t                  stream_num_buffered_samples;  /* 現在ブロックに溜まっているサンプル数 */
+  uint64_t                  stream_num_samples;           /* ストリーミングで入力された総サンプル数 */
+  uint8_t                   stream_begun;                 /* ストリーミング開始済みフラグ */
   void                      *work;
 };
 
+/* 並列エンコードのワーカ */
+struct AADEncodeWorker {
+  struct AADEncoder     *encoder;       /* ワーカ専用のエンコーダ                 */
+  struct AADSampleBuffer input;         /* 入力信号                               */
+  uint8_t               *data;          /* 出力先頭（ファイルヘッダを含む）       */
+  uint64_t              data_size;      /* 出力サイズ                             */
+  uint8_t               *scratch;       /* ウォームアップ時の出力捨て場           */
+  uint64_t              warmup_block;   /* ウォームアップを開始するブロック番号   */
+  uint64_t              start_block;    /* 担当する先頭ブロック番号               */
+  uint64_t              end_block;      /* 担当する末尾ブロック番号（含まない）   */
+  AADApiResult          result;         /* 処理結果                               */
+};
+
+/* 二乗誤差和計測の単位（レーン） */
+struct AADEncodeLane {
+  struct AADEncodeProcessor *processor;             /* 計測に使うプロセッサ（状態は更新される） */
+  const int32_t             *input;                 /* 入力信号                                 */
+  uint32_t                  num_samples;            /* 入力サンプル数                           */
+  uint64_t                  max_sum_squared_error;  /* 打ち切る二乗誤差和                       */
+  uint64_t                  sum_squared_error;      /* 計測結果                                 */
+};
+
+#if AAD_ENCODER_USE_AVX2
+/* AVX2で各レーンのエンコードに使うテーブル（ギャザー用に32bit幅へ展開） */
+struct AADEncodeLaneTablesAVX2 {
+  int32_t       stepsize_table[AAD_STEPSIZE_TABLE_SIZE];  /* ステップサイズテーブル */
+  int32_t       index_table[AAD_MAX_CODE_VALUE + 1];      /* インデックス変動テーブル */
+  const int32_t *qdiff_table;                             /* 量子化差分テーブル */
+  uint8_t       bits_per_sample;                          /* サンプルあたりビット数 */
+};
+
+/* AVX2での各レーンのエンコード状態 レーンiはプロセッサiに対応 */
+struct AADEncodeLaneStateAVX2 {
+  __m128i index;                      /* ステップサイズインデックス */
+  __m128i quantize_error;             /* 量子化誤差 */
+  __m128i weight[AAD_FILTER_ORDER];   /* フィルタ係数 */
+  __m128i history[AAD_FILTER_ORDER];  /* 入力データ履歴 */
+};
+#endif
+
 /* 最大公約数の計算 */
 static uint32_t AADEncoder_CalculateGCD(uint32_t a, uint32_t b);
 
@@ -35,35 +98,132 @@ static uint32_t AADEncoder_CalculateLCM(uint32_t a, uint32_t b);
 /* エンコード処理ハンドルのリセット */
 static void AADEncodeProcessor_Reset(struct AADEncodeProcessor *processor);
 
-/* 1サンプルエンコード */
-static uint8_t AADEncodeProcessor_EncodeSample(
-    struct AADEncodeProcessor *processor, int32_t sample, uint8_t bits_per_sample);
+/* 1サンプルエンコード（サンプルあたりビット数ごとに特殊化） */
+static uint8_t AADEncodeProcessor_EncodeSample4bit(struct AADEncodeProcessor *processor, int32_t sample);
+static uint8_t AADEncodeProcessor_EncodeSample3bit(struct AADEncodeProcessor *processor, int32_t sample);
+static uint8_t AADEncodeProcessor_EncodeSample2bit(struct AADEncodeProcessor *processor, int32_t sample);
+
+/* 1チャンネル分のデータ単位をエンコード（サンプルあたりビット数ごとに特殊化） */
+static void AADEncodeProcessor_EncodeUnit4bit(struct AADEncodeProcessor *processor, const int32_t *input, uint8_t *code);
+static void AADEncodeProcessor_EncodeUnit3bit(struct AADEncodeProcessor *processor, const int32_t *input, uint8_t *code);
+static void AADEncodeProcessor_EncodeUnit2bit(struct AADEncodeProcessor *processor, const int32_t *input, uint8_t *code);
 
 /* LR -> MS 変換（インターリーブ） */
 static void AADEncoder_LRtoMSInterleave(int32_t **buffer, uint32_t num_samples);
 
+/* 入力の指定位置から読み出して16bit幅に変換し、チャンネル処理を適用 */
+/* 補足）バッファはブロックあたりサンプル数まで0埋めする */
+static AADError AADEncoder_ConvertInput(
+    const struct AADHeaderInfo *header,
+    const struct AADSampleBuffer *input, uint64_t offset, uint32_t num_samples, int32_t **buffer);
+
 /* 単一ブロックのエンコードを試行し、RMSEを計測 */
-static AADError AADEncodeProcessor_CalculateRMSError(
+/* 補足）二乗誤差和がmax_sum_squared_errorを超えた時点で打ち切り、途中までの値を返す */
+static AADError AADEncodeProcessor_CalculateSumSquaredError(
     struct AADEncodeProcessor *processor, 
-    const int32_t *input, uint32_t num_samples, uint8_t bits_per_sample, double *rmse);
+    const int32_t *input, uint32_t num_samples, uint8_t bits_per_sample,
+    uint64_t max_sum_squared_error, uint64_t *sum_squared_error);
+
+/* 複数レーンの二乗誤差和を計測 */
+/* 補足）レーン間は独立。打ち切った場合の誤差和は打ち切り値を超えることのみ保証する */
+static AADError AADEncoder_CalculateSumSquaredErrorLanes(
+    struct AADEncodeLane *lanes, uint32_t num_lanes, uint8_t bits_per_sample);
+
+#if AAD_ENCODER_USE_AVX2
+/* AVX2で使うテーブルの準備 */
+static void AADEncoder_InitializeLaneTablesAVX2(
+    struct AADEncodeLaneTablesAVX2 *tables, const struct AADTable *table, uint8_t bits_per_sample);
+
+/* プロセッサの状態を各レーンに読み込み 余ったレーンは先頭のプロセッサを複製 */
+static void AADEncoder_LoadLaneStateAVX2(
+    struct AADEncodeLaneStateAVX2 *state, const struct AADEncodeProcessor *processors, uint32_t num_processors);
+
+/* 各レーンの状態をプロセッサに書き戻し */
+static void AADEncoder_StoreLaneStateAVX2(
+    const struct AADEncodeLaneStateAVX2 *state, struct AADEncodeProcessor *processors, uint32_t num_processors);
+
+/* 各レーンで1サンプルずつエンコードし符号を返す（量子化誤差は状態に記録） */
+static __m128i AADEncoder_EncodeSampleLanesAVX2(
+    struct AADEncodeLaneStateAVX2 *state, const struct AADEncodeLaneTablesAVX2 *tables, __m128i vsample);
+
+/* 各チャンネルをレーンに割り当て、データ単位のサンプルをAVX2で同時にエンコード */
+static void AADEncoder_EncodeUnitLanesAVX2(
+    struct AADEncodeLaneStateAVX2 *state, const struct AADEncodeLaneTablesAVX2 *tables,
+    const int32_t *const *input, uint32_t num_channels, uint32_t start_sample, uint32_t num_unit_samples,
+    uint8_t *codes);
+
+/* 複数レーンの二乗誤差和をAVX2で同時に計測 */
+static void AADEncoder_CalculateSumSquaredErrorLanesAVX2(
+    struct AADEncodeLane *lanes, uint32_t num_lanes, uint8_t bits_per_sample);
+#endif
 
 /* 最大性能をもつエンコードプロセッサの探索 */
+/* 補足）inputはエンコード対象ブロック、prev_inputは直前ブロック（先頭ブロックではNULL）の変換済み入力 */
 static AADError AADEncoder_SearchBestProcessor(
-    const struct AADEncoder *encoder, 
-    const int32_t *const *input, uint32_t progress, uint32_t num_encode_samples,
+    const struct AADEncoder *encoder,
+    const int32_t *const *input, const int32_t *const *prev_input, uint32_t num_encode_samples,
+    struct AADEncodeProcessor *best_processor);
+
+/* 独立探索のcandidate番目の候補（初期状態）を作成 */
+/* 補足）adaptedは直前ブロックで1回適応したプロセッサ（直前ブロックがなければNULL） */
+/*       候補は係数の起点（現在・適応後）とステップサイズインデックスのずらし幅の組 */
+static void AADEncoder_MakeSearchCandidate(
+    const struct AADEncodeProcessor *current, const struct AADEncodeProcessor *adapted,
+    uint32_t candidate, struct AADEncodeProcessor *processor);
+
+/* 初期状態の異なる独立な候補をレーンで同時に計測し、最大性能をもつエンコードプロセッサを探索 */
+static AADError AADEncoder_SearchBestProcessorIndependent(
+    const struct AADEncoder *encoder,
+    const int32_t *const *input, const int32_t *const *prev_input, uint32_t num_encode_samples,
     struct AADEncodeProcessor *best_processor);
 
+/* 符号配列を1符号ずつ符号列に詰める */
+/* 補足）符号はMSBから詰める。num_codes * bits_per_sample は8の倍数であること */
+static void AADEncoder_PackCodesScalar(
+    const uint8_t *codes, uint32_t num_codes, uint8_t bits_per_sample, uint8_t *data);
+
+#if AAD_ENCODER_USE_AVX2
+/* SSSE3で符号配列を符号列に詰める 詰めた符号数を返す */
+static uint32_t AADEncoder_PackCodesSSSE3(
+    const uint8_t *codes, uint32_t num_codes, uint8_t bits_per_sample, uint8_t *data);
+#endif
+
+/* 符号配列を符号列に詰める */
+static void AADEncoder_PackCodes(
+    const uint8_t *codes, uint32_t num_codes, uint8_t bits_per_sample, uint8_t *data);
+
 /* 単一データブロックエンコード */
+/* 補足）inputは変換済み入力 */
 static AADApiResult AADEncoder_EncodeBlock(
     struct AADEncoder *encoder,
     const int32_t *const *input, uint32_t num_samples, 
     uint8_t *data, uint32_t data_size, uint32_t *output_size);
 
+/* プロセッサを探索した上で単一データブロックをエンコード */
+/* 補足）inputのinput_offsetからが現在ブロック、prev_inputのprev_offsetからが直前ブロック（先頭ブロックではNULL） */
+static AADApiResult AADEncoder_SearchAndEncodeBlock(
+    struct AADEncoder *encoder,
+    const struct AADSampleBuffer *input, uint64_t input_offset,
+    const struct AADSampleBuffer *prev_input, uint64_t prev_offset, uint32_t num_encode_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size);
+
+/* 入力信号の指定位置のブロックをエンコード */
+static AADApiResult AADEncoder_SearchAndEncodeBlockAt(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input, uint64_t progress,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size);
+
 /* エンコードパラメータをヘッダに変換 */
 static AADError AADEncoder_ConvertParameterToHeader(
-    const struct AADEncodeParameter *enc_param, uint32_t num_samples,
+    const struct AADEncodeParameter *enc_param, uint64_t num_samples,
     struct AADHeaderInfo *header_info);
 
+/* エンコード後のデータサイズ（ファイルヘッダを含む）を計算 */
+static uint64_t AADEncoder_CalculateEncodedDataSize(
+    const struct AADHeaderInfo *header, uint64_t num_samples);
+
+/* ワーカが担当するブロック範囲をエンコード */
+static void *AADEncodeWorker_Run(void *arg);
+
 /* 最大公約数の計算 */
 static uint32_t AADEncoder_CalculateGCD(uint32_t a, uint32_t b)
 {
@@ -83,8 +243,8 @@ static uint32_t AADEncoder_CalculateLCM(uint32_t a, uint32_t b)
 
 /* ブロックサイズとブロックあたりサンプル数の計算 */
 AADApiResult AADEncoder_CalculateBlockSize(
-    uint16_t max_block_size, uint16_t num_channels, uint32_t bits_per_sample,
-    uint16_t *block_size, uint32_t *num_samples_per_block)
+    uint32_t max_block_size, uint16_t num_channels, uint32_t bits_per_sample,
+    uint32_t *block_size, uint32_t *num_samples_per_block)
 {
   uint32_t block_data_size;
   uint32_t num_samples_in_block_data;
@@ -117,12 +277,16 @@ AADApiResult AADEncoder_CalculateBlockSize(
   block_data_size = interleave_data_unit_size * (block_data_size / interleave_data_unit_size);
 
   /* ブロックデータ内に入れられるサンプル数を計算 */
+  /* 補足）ブロックあたりサンプル数が32bitに収まらないブロックサイズは扱わない */
+  if ((uint64_t)num_samples_per_interleave_data_unit * (block_data_size / interleave_data_unit_size)
+      > (uint64_t)(UINT32_MAX - AAD_FILTER_ORDER)) {
+    return AAD_APIRESULT_INVALID_FORMAT;
+  }
   num_samples_in_block_data
     = num_samples_per_interleave_data_unit * (block_data_size / interleave_data_unit_size);
   
   /* ブロックサイズの確定 */
-  AAD_ASSERT((uint32_t)AAD_BLOCK_HEADER_SIZE(num_channels) + block_data_size <= UINT16_MAX);
-  (*block_size) = (uint16_t)((uint16_t)AAD_BLOCK_HEADER_SIZE(num_channels) + block_data_size);
+  (*block_size) = (uint32_t)AAD_BLOCK_HEADER_SIZE(num_channels) + block_data_size;
   /* ヘッダに入っている分を加算する */
   if (num_samples_per_block != NULL) {
     (*num_samples_per_block) = num_samples_in_block_data + AAD_FILTER_ORDER;
@@ -132,7 +296,7 @@ AADApiResult AADEncoder_CalculateBlockSize(
 
 /* ヘッダエンコード */
 AADApiResult AADEncoder_EncodeHeader(
-    const struct AADHeaderInfo *header_info, uint8_t *data, uint32_t data_size)
+    const struct AADHeaderInfo *header_info, uint8_t *data, uint64_t data_size)
 {
   uint8_t *data_pos;
 
@@ -201,13 +365,13 @@ AADApiResult AADEncoder_EncodeHeader(
   /* チャンネル数 */
   ByteArray_PutUint16BE(data_pos, header_info->num_channels);
   /* サンプル数 */
-  ByteArray_PutUint32BE(data_pos, header_info->num_samples);
+  ByteArray_PutUint64BE(data_pos, header_info->num_samples);
   /* サンプリングレート */
   ByteArray_PutUint32BE(data_pos, header_info->sampling_rate);
   /* サンプルあたりビット数 */
   ByteArray_PutUint16BE(data_pos, header_info->bits_per_sample);
   /* ブロックサイズ */
-  ByteArray_PutUint16BE(data_pos, header_info->block_size);
+  ByteArray_PutUint32BE(data_pos, header_info->block_size);
   /* ブロックあたりサンプル数 */
   ByteArray_PutUint32BE(data_pos, header_info->num_samples_per_block);
   /* マルチチャンネル処理法 */
@@ -221,11 +385,11 @@ AADApiResult AADEncoder_EncodeHeader(
 }
 
 /* エンコーダワークサイズ計算 */
-int32_t AADEncoder_CalculateWorkSize(uint16_t max_block_size)
+int32_t AADEncoder_CalculateWorkSize(uint32_t max_block_size)
 {
-  int32_t work_size;
+  uint64_t work_size;
   uint32_t num_samples_per_block;
-  uint16_t block_size;
+  uint32_t block_size;
 
   /* 最大ブロックサイズから最大のブロックあたりのサンプル数を計算 */
   /* note:最もサンプル数が入るケースとして、ビット数は最小かつチャンネル数は1とする */
@@ -238,20 +402,25 @@ int32_t AADEncoder_CalculateWorkSize(uint16_t max_block_size)
   /* 構造体サイズ */
   work_size = AAD_ALIGNMENT + sizeof(struct AADEncoder);
 
-  /* バッファサイズ: 作業領域用に2倍確保 */
-  work_size += 2 * AAD_MAX_NUM_CHANNELS * (int32_t)(sizeof(int32_t) * num_samples_per_block + AAD_ALIGNMENT);
+  /* バッファサイズ: 変換済みの現在・直前ブロック用に2倍、ストリーミングの現在ブロック用に1倍確保 */
+  work_size += 3 * AAD_MAX_NUM_CHANNELS * ((uint64_t)sizeof(int32_t) * num_samples_per_block + AAD_ALIGNMENT);
 
-  return work_size;
+  /* ワークサイズが表現できない */
+  if (work_size > INT32_MAX) {
+    return -1;
+  }
+
+  return (int32_t)work_size;
 }
 
 /* エンコーダハンドル作成 */
-struct AADEncoder *AADEncoder_Create(uint16_t max_block_size, void *work, int32_t work_size)
+struct AADEncoder *AADEncoder_Create(uint32_t max_block_size, void *work, int32_t work_size)
 {
   uint32_t ch;
   struct AADEncoder *encoder;
   uint8_t *work_ptr;
   uint8_t tmp_alloced_by_own = 0;
-  uint16_t block_size;
+  uint32_t block_size;
   uint32_t num_samples_per_block;
 
   /* ブロックあたりサンプル数の計算 */
@@ -272,7 +441,8 @@ struct AADEncoder *AADEncoder_Create(uint16_t max_block_size, void *work, int32_
   }
 
   /* 引数チェック */
-  if ((work == NULL) || (work_size < AADEncoder_CalculateWorkSize(max_block_size))) {
+  if ((work == NULL) || (AADEncoder_CalculateWorkSize(max_block_size) < 0)
+      || (work_size < AADEncoder_CalculateWorkSize(max_block_size))) {
     return NULL;
   }
 
@@ -291,7 +461,12 @@ struct AADEncoder *AADEncoder_Create(uint16_t max_block_size, void *work, int32_
   }
   for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
     work_ptr = (uint8_t *)AAD_ROUND_UP((uintptr_t)work_ptr, AAD_ALIGNMENT);
-    encoder->work_buffer[ch] = (int32_t *)work_ptr;
+    encoder->prev_input_buffer[ch] = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * num_samples_per_block;
+  }
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    work_ptr = (uint8_t *)AAD_ROUND_UP((uintptr_t)work_ptr, AAD_ALIGNMENT);
+    encoder->stream_buffer[ch] = (int32_t *)work_ptr;
     work_ptr += sizeof(int32_t) * num_samples_per_block;
   }
 
@@ -303,6 +478,14 @@ struct AADEncoder *AADEncoder_Create(uint16_t max_block_size, void *work, int32_
   /* パラメータは未セット状態に */
   encoder->set_parameter = 0;
 
+  /* 直前ブロックは未変換状態に */
+  encoder->prev_input_buffered = 0;
+
+  /* ストリーミングは未開始状態に */
+  encoder->stream_begun = 0;
+  encoder->stream_num_buffered_samples = 0;
+  encoder->stream_num_samples = 0;
+
   /* メモリ先頭アドレスを記録 */
   encoder->work = work;
 
@@ -339,75 +522,98 @@ static void AADEncodeProcessor_Reset(struct AADEncodeProcessor *processor)
   }
 }
 
-/* 1サンプルエンコード */
-static uint8_t AADEncodeProcessor_EncodeSample(
-    struct AADEncodeProcessor *processor, int32_t sample, uint8_t bits_per_sample)
-{
-  uint8_t code;
-  int32_t predict, diff, qdiff, delta, stepsize, diffabs, sign;
-  int32_t quantize_sample, ord;
-  const uint8_t signbit = (uint8_t)(1U << (bits_per_sample - 1));
-  const uint8_t absmask = (uint8_t)(signbit - 1);
-
-  AAD_ASSERT(processor != NULL);
-  AAD_ASSERT((bits_per_sample >= AAD_MIN_BITS_PER_SAMPLE) && (bits_per_sample <= AAD_MAX_BITS_PER_SAMPLE));
-
-  /* ステップサイズの取得 */
-  stepsize = AADTable_GetStepSize(&(processor->table));
-
-  /* フィルタ予測 */
-  predict = AAD_FIXEDPOINT_0_5;
-  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
-    predict += processor->history[ord] * processor->weight[ord];
-  }
-  predict >>= AAD_FIXEDPOINT_DIGITS;
-
-  /* 差分 */
-  diff = sample - predict;
-  sign = diff < 0;
-  diffabs = sign ? -diff : diff;
-
-  /* 差分を符号表現に変換 */
-  /* code = sign(diff) * round(|diff| * 2**(bits_per_sample-2) / stepsize) */
-  code = (uint8_t)AAD_MIN_VAL((diffabs << (bits_per_sample - 2)) / stepsize, absmask);
-  /* codeの最上位ビットは符号ビット */
-  if (sign) {
-    code |= signbit;
-  }
-
-  /* 量子化した差分を計算 */
-  /* diff = stepsize * (delta + 0.5) / 2**(bits_per_sample-2) */
-  /* -> diff = stepsize * (delta * 2 + 1) / 2**(bits_per_sample-1) */
-  delta = code & absmask;
-  qdiff = (stepsize * ((delta << 1) + 1)) >> (bits_per_sample - 1);
-  qdiff = (sign) ? -qdiff : qdiff; /* 符号ビットの反映 */
-
-  /* インデックス更新 */
-  AADTable_UpdateIndex(&(processor->table), code);
-
-  /* 計算結果の反映 */
-  processor->quantize_error = qdiff;
-
-  /* 量子化後のサンプル値 */
-  quantize_sample = qdiff + predict;
-  /* 16bit幅にクリップ */
-  quantize_sample = AAD_INNER_VAL(quantize_sample, INT16_MIN, INT16_MAX);
+/* 1サンプルエンコード関数の定義マクロ */
+/* 補足）サンプルあたりビット数ごとに展開し、符号ビット・シフト量を定数化、テーブルはポインタを介さず直接参照する */
+#define AAD_ENCODER_DEFINE_ENCODE_SAMPLE(bits_per_sample)\
+static uint8_t AADEncodeProcessor_EncodeSample ## bits_per_sample ## bit(\
+    struct AADEncodeProcessor *processor, int32_t sample)\
+{\
+  uint8_t code;\
+  int32_t predict, diff, qdiff, diffabs, sign;\
+  int32_t quantize_sample, ord, index;\
+\
+  AAD_ASSERT(processor != NULL);\
+\
+  /* フィルタ予測 */\
+  predict = AAD_FIXEDPOINT_0_5;\
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {\
+    predict += processor->history[ord] * processor->weight[ord];\
+  }\
+  predict >>= AAD_FIXEDPOINT_DIGITS;\
+\
+  /* 差分 */\
+  diff = sample - predict;\
+  sign = diff < 0;\
+  diffabs = sign ? -diff : diff;\
+\
+  /* 差分を符号表現に変換 */\
+  /* code = sign(diff) * round(|diff| * 2**(bits_per_sample-2) / stepsize) */\
+  /* 除算は逆数乗算で行う。|diff|が2**16以上では常に絶対値の最大値に飽和するため、 */\
+  /* 被除数がAAD_TABLES_MAX_DIVIDEND以下になるよう先に制限しておく */\
+  AAD_STATIC_ASSERT(((1 << 16) << ((bits_per_sample) - 2)) <= AAD_TABLES_MAX_DIVIDEND);\
+  diffabs = AAD_MIN_VAL(diffabs, 1 << 16);\
+  index = AAD_TABLES_FLOAT_TO_INDEX(processor->table.stepsize_index);\
+  code = (uint8_t)AAD_MIN_VAL(\
+      (int32_t)(((uint64_t)(diffabs << ((bits_per_sample) - 2)) * AAD_stepsize_reciprocal_table[index])\
+        >> AAD_TABLES_RECIPROCAL_DIGITS), (1 << ((bits_per_sample) - 1)) - 1);\
+  /* codeの最上位ビットは符号ビット */\
+  if (sign) {\
+    code |= (1 << ((bits_per_sample) - 1));\
+  }\
+\
+  /* 量子化した差分をテーブル引き */\
+  qdiff = AAD_qdiff_table_ ## bits_per_sample ## bit[index][code];\
+\
+  /* インデックス更新 */\
+  AADTable_UpdateIndexNbit(processor->table.stepsize_index, code, bits_per_sample);\
+\
+  /* 計算結果の反映 */\
+  processor->quantize_error = qdiff;\
+\
+  /* 量子化後のサンプル値 */\
+  quantize_sample = qdiff + predict;\
+  /* 16bit幅にクリップ */\
+  quantize_sample = AAD_INNER_VAL(quantize_sample, INT16_MIN, INT16_MAX);\
+\
+  /* フィルタ係数更新 */\
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {\
+    processor->weight[ord]\
+      += (qdiff * processor->history[ord] + AAD_FIXEDPOINT_0_5) >> (AAD_FIXEDPOINT_DIGITS + AAD_LMSFILTER_SHIFT);\
+  }\
+\
+  /* 入力データ履歴更新 */\
+  for (ord = AAD_FILTER_ORDER - 1; ord > 0; ord--) {\
+    processor->history[ord] = processor->history[ord - 1];\
+  }\
+  processor->history[0] = (int16_t)quantize_sample;\
+\
+  AAD_ASSERT(code < (1 << (bits_per_sample)));\
+  return code;\
+}
 
-  /* フィルタ係数更新 */
-  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
-    processor->weight[ord]
-      += (qdiff * processor->history[ord] + AAD_FIXEDPOINT_0_5) >> (AAD_FIXEDPOINT_DIGITS + AAD_LMSFILTER_SHIFT);
-  }
+/* 1チャンネル分のデータ単位エンコード関数の定義マクロ */
+#define AAD_ENCODER_DEFINE_ENCODE_UNIT(bits_per_sample, num_unit_samples)\
+static void AADEncodeProcessor_EncodeUnit ## bits_per_sample ## bit(\
+    struct AADEncodeProcessor *processor, const int32_t *input, uint8_t *code)\
+{\
+  uint32_t k;\
+\
+  AAD_ASSERT((processor != NULL) && (input != NULL) && (code != NULL));\
+\
+  for (k = 0; k < (num_unit_samples); k++) {\
+    code[k] = AADEncodeProcessor_EncodeSample ## bits_per_sample ## bit(processor, input[k]);\
+  }\
+}
 
-  /* 入力データ履歴更新 */
-  for (ord = AAD_FILTER_ORDER - 1; ord > 0; ord--) {
-    processor->history[ord] = processor->history[ord - 1];
-  }
-  processor->history[0] = (int16_t)quantize_sample;
+/* 1サンプルエンコード（サンプルあたりビット数ごとに特殊化） */
+AAD_ENCODER_DEFINE_ENCODE_SAMPLE(4)
+AAD_ENCODER_DEFINE_ENCODE_SAMPLE(3)
+AAD_ENCODER_DEFINE_ENCODE_SAMPLE(2)
 
-  AAD_ASSERT(code <= AAD_MAX_CODE_VALUE);
-  return code;
-}
+/* 1チャンネル分のデータ単位をエンコード（サンプルあたりビット数ごとに特殊化） */
+AAD_ENCODER_DEFINE_ENCODE_UNIT(4, 2)
+AAD_ENCODER_DEFINE_ENCODE_UNIT(3, 8)
+AAD_ENCODER_DEFINE_ENCODE_UNIT(2, 4)
 
 /* LR -> MS 変換（インターリーブ） */
 static void AADEncoder_LRtoMSInterleave(int32_t **buffer, uint32_t num_samples)
@@ -427,22 +633,54 @@ static void AADEncoder_LRtoMSInterleave(int32_t **buffer, uint32_t num_samples)
   }
 }
 
+/* 入力の指定位置から読み出して16bit幅に変換し、チャンネル処理を適用 */
+static AADError AADEncoder_ConvertInput(
+    const struct AADHeaderInfo *header,
+    const struct AADSampleBuffer *input, uint64_t offset, uint32_t num_samples, int32_t **buffer)
+{
+  uint32_t ch;
+
+  AAD_ASSERT(header != NULL);
+  AAD_ASSERT(input != NULL);
+  AAD_ASSERT(buffer != NULL);
+  AAD_ASSERT(num_samples <= header->num_samples_per_block);
+
+  /* 入力を変換しながらバッファに読み出し */
+  for (ch = 0; ch < header->num_channels; ch++) {
+    AADSampleBuffer_ReadChannel(input, ch, offset, num_samples, buffer[ch]);
+    /* バッファの末尾に前回エンコードの残骸が残る場合があるので、ブロックの大きさまで0クリア */
+    memset(&buffer[ch][num_samples], 0, sizeof(int32_t) * (header->num_samples_per_block - num_samples));
+  }
+
+  /* LR -> MS */
+  if (header->ch_process_method == AAD_CH_PROCESS_METHOD_MS) {
+    /* チャンネル数チェック */
+    if (header->num_channels < 2) {
+      return AAD_ERROR_INVALID_FORMAT;
+    }
+    AADEncoder_LRtoMSInterleave(buffer, num_samples);
+  }
+
+  return AAD_ERROR_OK;
+}
+
 /* 単一ブロックのエンコードを試行し、RMSEを計測 */
-static AADError AADEncodeProcessor_CalculateRMSError(
+static AADError AADEncodeProcessor_CalculateSumSquaredError(
     struct AADEncodeProcessor *processor, 
-    const int32_t *input, uint32_t num_samples, uint8_t bits_per_sample, double *rmse)
+    const int32_t *input, uint32_t num_samples, uint8_t bits_per_sample,
+    uint64_t max_sum_squared_error, uint64_t *sum_squared_error)
 {
   uint32_t smpl;
-  double sum_squared_error;
+  uint64_t tmp_sum_squared_error;
 
   /* 引数チェック */
-  if ((processor == NULL) || (input == NULL) || (rmse == NULL)) {
+  if ((processor == NULL) || (input == NULL) || (sum_squared_error == NULL)) {
     return AAD_ERROR_INVALID_ARGUMENT;
   }
 
   /* サンプル数が少なすぎるときは誤差0とする（先頭サンプルで正確に予測できるから） */
   if (num_samples < AAD_FILTER_ORDER) {
-    (*rmse) = 0.0f;
+    (*sum_squared_error) = 0;
     return AAD_ERROR_OK;
   }
 
@@ -453,30 +691,359 @@ static AADError AADEncodeProcessor_CalculateRMSError(
   }
 
   /* 誤差計測 */
-  sum_squared_error = 0.0f;
-  for (smpl = AAD_FILTER_ORDER; smpl < num_samples; smpl++) {
+  /* 補足）サンプルあたりビット数での分岐はループの外で1回だけ行う */
+#define AAD_ENCODER_ACCUMULATE_SQUARED_ERROR(bits_per_sample)\
+  for (smpl = AAD_FILTER_ORDER; smpl < num_samples; smpl++) {\
+    /* サンプルエンコードを実行し状態更新 エンコード結果は捨てる */\
+    (void)AADEncodeProcessor_EncodeSample ## bits_per_sample ## bit(processor, input[smpl]);\
+    /* 量子化後の誤差を累積 */\
+    /* 補足）量子化誤差は16bitを超えうるため、二乗は64bitで計算する */\
+    tmp_sum_squared_error += (uint64_t)((int64_t)processor->quantize_error * processor->quantize_error);\
+    /* 上限を超えたら打ち切り: 誤差和は単調非減少なので、以降の結果で上限を下回ることはない */\
+    if (tmp_sum_squared_error > max_sum_squared_error) {\
+      break;\
+    }\
+  }
+  tmp_sum_squared_error = 0;
+  switch (bits_per_sample) {
+    case 4: AAD_ENCODER_ACCUMULATE_SQUARED_ERROR(4); break;
+    case 3: AAD_ENCODER_ACCUMULATE_SQUARED_ERROR(3); break;
+    case 2: AAD_ENCODER_ACCUMULATE_SQUARED_ERROR(2); break;
+    default: return AAD_ERROR_INVALID_ARGUMENT;
+  }
+#undef AAD_ENCODER_ACCUMULATE_SQUARED_ERROR
+
+  (*sum_squared_error) = tmp_sum_squared_error;
+  return AAD_ERROR_OK;
+}
+
+#if AAD_ENCODER_USE_AVX2
+/* AVX2で使うテーブルの準備 */
+static void AADEncoder_InitializeLaneTablesAVX2(
+    struct AADEncodeLaneTablesAVX2 *tables, const struct AADTable *table, uint8_t bits_per_sample)
+{
+  uint32_t k;
+
+  AAD_ASSERT((tables != NULL) && (table != NULL));
+
+  for (k = 0; k < AAD_STEPSIZE_TABLE_SIZE; k++) {
+    tables->stepsize_table[k] = table->stepsize_table[k];
+  }
+  for (k = 0; k < (uint32_t)table->index_table_size; k++) {
+    tables->index_table[k] = table->index_table[k];
+  }
+  tables->qdiff_table = table->qdiff_table;
+  tables->bits_per_sample = bits_per_sample;
+}
+
+/* プロセッサの状態を各レーンに読み込み 余ったレーンは先頭のプロセッサを複製 */
+__attribute__((target("avx2")))
+static void AADEncoder_LoadLaneStateAVX2(
+    struct AADEncodeLaneStateAVX2 *state, const struct AADEncodeProcessor *processors, uint32_t num_processors)
+{
+  uint32_t lane, ord;
+  int32_t index[AAD_ENCODER_NUM_LANES], quantize_error[AAD_ENCODER_NUM_LANES];
+  int32_t weight[AAD_FILTER_ORDER][AAD_ENCODER_NUM_LANES];
+  int32_t history[AAD_FILTER_ORDER][AAD_ENCODER_NUM_LANES];
+
+  AAD_ASSERT((state != NULL) && (processors != NULL));
+  AAD_ASSERT((num_processors > 0) && (num_processors <= AAD_ENCODER_NUM_LANES));
+
+  for (lane = 0; lane < AAD_ENCODER_NUM_LANES; lane++) {
+    const struct AADEncodeProcessor *processor = &processors[(lane < num_processors) ? lane : 0];
+    index[lane] = processor->table.stepsize_index;
+    quantize_error[lane] = processor->quantize_error;
+    for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+      weight[ord][lane] = processor->weight[ord];
+      history[ord][lane] = processor->history[ord];
+    }
+  }
+
+  state->index = _mm_loadu_si128((const __m128i *)index);
+  state->quantize_error = _mm_loadu_si128((const __m128i *)quantize_error);
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+    state->weight[ord] = _mm_loadu_si128((const __m128i *)weight[ord]);
+    state->history[ord] = _mm_loadu_si128((const __m128i *)history[ord]);
+  }
+}
+
+/* 各レーンの状態をプロセッサに書き戻し */
+__attribute__((target("avx2")))
+static void AADEncoder_StoreLaneStateAVX2(
+    const struct AADEncodeLaneStateAVX2 *state, struct AADEncodeProcessor *processors, uint32_t num_processors)
+{
+  uint32_t lane, ord;
+  int32_t index[AAD_ENCODER_NUM_LANES], quantize_error[AAD_ENCODER_NUM_LANES];
+  int32_t weight[AAD_FILTER_ORDER][AAD_ENCODER_NUM_LANES];
+  int32_t history[AAD_FILTER_ORDER][AAD_ENCODER_NUM_LANES];
+
+  AAD_ASSERT((state != NULL) && (processors != NULL));
+  AAD_ASSERT(num_processors <= AAD_ENCODER_NUM_LANES);
+
+  _mm_storeu_si128((__m128i *)index, state->index);
+  _mm_storeu_si128((__m128i *)quantize_error, state->quantize_error);
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+    _mm_storeu_si128((__m128i *)weight[ord], state->weight[ord]);
+    _mm_storeu_si128((__m128i *)history[ord], state->history[ord]);
+  }
+
+  for (lane = 0; lane < num_processors; lane++) {
+    struct AADEncodeProcessor *processor = &processors[lane];
+    processor->table.stepsize_index = (int16_t)index[lane];
+    processor->quantize_error = quantize_error[lane];
+    for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+      processor->weight[ord] = weight[ord][lane];
+      processor->history[ord] = (int16_t)history[ord][lane];
+    }
+  }
+}
+
+/* 各レーンで1サンプルずつエンコードし符号を返す（量子化誤差は状態に記録） */
+/* 補足）AADEncodeProcessor_EncodeSample4bit等と同じ計算をレーンごとに行う。 */
+/*       ステップサイズによる除算は閾値との比較で求める */
+__attribute__((target("avx2")))
+static __m128i AADEncoder_EncodeSampleLanesAVX2(
+    struct AADEncodeLaneStateAVX2 *state, const struct AADEncodeLaneTablesAVX2 *tables, __m128i vsample)
+{
+  uint32_t ord, k;
+  const int32_t absmask = (1 << (tables->bits_per_sample - 1)) - 1;
+  const __m128i vcode_bits = _mm_cvtsi32_si128((int)tables->bits_per_sample);
+  const __m128i vdividend_shift = _mm_cvtsi32_si128((int)tables->bits_per_sample - 2);
+  const __m128i vhalf = _mm_set1_epi32(AAD_FIXEDPOINT_0_5);
+  const __m128i vtable_half = _mm_set1_epi32(AAD_TABLES_FLOAT_0_5);
+  const __m128i vmax_index = _mm_set1_epi32(AAD_TABLES_INDEX_TO_FLOAT(AAD_STEPSIZE_TABLE_SIZE - 1));
+  __m128i vpredict, vdiff, vdividend, vstep_index, vstepsize, vthreshold, vcode, vqdiff;
+
+  /* フィルタ予測 */
+  vpredict = vhalf;
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+    vpredict = _mm_add_epi32(vpredict, _mm_mullo_epi32(state->history[ord], state->weight[ord]));
+  }
+  vpredict = _mm_srai_epi32(vpredict, AAD_FIXEDPOINT_DIGITS);
+
+  /* 差分 */
+  vdiff = _mm_sub_epi32(vsample, vpredict);
+  vdividend = _mm_sll_epi32(_mm_min_epi32(_mm_abs_epi32(vdiff), _mm_set1_epi32(1 << 16)), vdividend_shift);
+
+  /* 符号化: |差分|がステップサイズのk倍以上となるkを数える（absmaskで飽和） */
+  vstep_index = _mm_srai_epi32(_mm_add_epi32(state->index, vtable_half), AAD_TABLES_FLOAT_DIGITS);
+  vstepsize = _mm_i32gather_epi32((const int *)tables->stepsize_table, vstep_index, 4);
+  vthreshold = vstepsize;
+  vcode = _mm_set1_epi32(absmask);
+  for (k = 0; k < (uint32_t)absmask; k++) {
+    vcode = _mm_add_epi32(vcode, _mm_cmpgt_epi32(vthreshold, vdividend));
+    vthreshold = _mm_add_epi32(vthreshold, vstepsize);
+  }
+  /* codeの最上位ビットは符号ビット */
+  vcode = _mm_or_si128(vcode,
+      _mm_and_si128(_mm_set1_epi32(absmask + 1), _mm_cmpgt_epi32(_mm_setzero_si128(), vdiff)));
+
+  /* 量子化した差分をテーブル引き */
+  vqdiff = _mm_add_epi32(_mm_sll_epi32(vstep_index, vcode_bits), vcode);
+  vqdiff = _mm_i32gather_epi32((const int *)tables->qdiff_table, vqdiff, 4);
+  state->quantize_error = vqdiff;
+
+  /* インデックス更新 */
+  state->index = _mm_add_epi32(state->index, _mm_i32gather_epi32((const int *)tables->index_table, vcode, 4));
+  state->index = _mm_max_epi32(_mm_setzero_si128(), _mm_min_epi32(vmax_index, state->index));
+
+  /* フィルタ係数更新 */
+  for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+    state->weight[ord] = _mm_add_epi32(state->weight[ord],
+        _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(vqdiff, state->history[ord]), vhalf),
+          AAD_FIXEDPOINT_DIGITS + AAD_LMSFILTER_SHIFT));
+  }
+
+  /* 入力データ履歴更新 量子化後のサンプル値は16bit幅にクリップ */
+  for (ord = AAD_FILTER_ORDER - 1; ord > 0; ord--) {
+    state->history[ord] = state->history[ord - 1];
+  }
+  state->history[0] = _mm_max_epi32(_mm_set1_epi32(INT16_MIN),
+      _mm_min_epi32(_mm_set1_epi32(INT16_MAX), _mm_add_epi32(vqdiff, vpredict)));
+
+  return vcode;
+}
+
+/* 各チャンネルをレーンに割り当て、データ単位のサンプルをAVX2で同時にエンコード */
+__attribute__((target("avx2")))
+static void AADEncoder_EncodeUnitLanesAVX2(
+    struct AADEncodeLaneStateAVX2 *state, const struct AADEncodeLaneTablesAVX2 *tables,
+    const int32_t *const *input, uint32_t num_channels, uint32_t start_sample, uint32_t num_unit_samples,
+    uint8_t *codes)
+{
+  uint32_t ch, k;
+  int32_t sample[AAD_ENCODER_NUM_LANES] = { 0, };
+  int32_t lane_code[AAD_ENCODER_NUM_LANES];
+
+  AAD_ASSERT((state != NULL) && (tables != NULL) && (input != NULL));
+  AAD_ASSERT((num_channels > 0) && (num_channels <= AAD_MAX_NUM_CHANNELS));
+  AAD_ASSERT(num_unit_samples <= 8);
+
+  for (k = 0; k < num_unit_samples; k++) {
+    /* 余ったレーンは0を入力し結果を捨てる */
+    for (ch = 0; ch < num_channels; ch++) {
+      sample[ch] = input[ch][start_sample + k];
+    }
+    _mm_storeu_si128((__m128i *)lane_code,
+        AADEncoder_EncodeSampleLanesAVX2(state, tables, _mm_loadu_si128((const __m128i *)sample)));
+    for (ch = 0; ch < num_channels; ch++) {
+      codes[ch * num_unit_samples + k] = (uint8_t)lane_code[ch];
+    }
+  }
+}
+
+/* 複数レーンの二乗誤差和をAVX2で同時に計測 */
+/* 補足）各レーンのエンコードは逐次的だがレーン間は独立なので、予測・量子化・係数更新を揃えて実行する。 */
+/*       サンプル数が揃わないレーンは終了後の状態を保持する */
+__attribute__((target("avx2")))
+static void AADEncoder_CalculateSumSquaredErrorLanesAVX2(
+    struct AADEncodeLane *lanes, uint32_t num_lanes, uint8_t bits_per_sample)
+{
+  uint32_t lane, ord, smpl, min_num_samples, max_num_samples;
+  uint8_t has_limit;
+  struct AADEncodeLaneTablesAVX2 tables;
+  struct AADEncodeLaneStateAVX2 state, prev_state;
+  struct AADEncodeProcessor processors[AAD_ENCODER_NUM_LANES];
+  int32_t num_samples[AAD_ENCODER_NUM_LANES], sample[AAD_ENCODER_NUM_LANES];
+  int64_t max_sum[AAD_ENCODER_NUM_LANES], sum[AAD_ENCODER_NUM_LANES];
+  const int32_t *input[AAD_ENCODER_NUM_LANES];
+  __m128i vnum_samples, vsum_even, vsum_odd, vmax_even, vmax_odd;
+
+  AAD_STATIC_ASSERT(AAD_ENCODER_NUM_LANES == 4);
+  AAD_ASSERT((lanes != NULL) && (num_lanes > 0) && (num_lanes <= AAD_ENCODER_NUM_LANES));
+
+  AADEncoder_InitializeLaneTablesAVX2(&tables, &(lanes[0].processor->table), bits_per_sample);
+
+  /* 各レーンの状態を取得 余ったレーンは先頭レーンを複製して結果を捨てる */
+  has_limit = 0;
+  min_num_samples = UINT32_MAX;
+  max_num_samples = 0;
+  for (lane = 0; lane < AAD_ENCODER_NUM_LANES; lane++) {
+    const struct AADEncodeLane *src = &lanes[(lane < num_lanes) ? lane : 0];
+    processors[lane] = *(src->processor);
+    /* EncodeBlockに倣い、フィルタに先頭サンプルをセット */
+    /* 補足）サンプル数が少なすぎるときは状態を変えない */
+    if (src->num_samples >= AAD_FILTER_ORDER) {
+      for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+        processors[lane].history[ord] = (int16_t)src->input[AAD_FILTER_ORDER - ord - 1];
+      }
+    }
+    input[lane] = src->input;
+    num_samples[lane] = (int32_t)AAD_MAX_VAL(src->num_samples, AAD_FILTER_ORDER);
+    max_sum[lane] = (int64_t)AAD_MIN_VAL(src->max_sum_squared_error, (uint64_t)INT64_MAX);
+    min_num_samples = AAD_MIN_VAL(min_num_samples, (uint32_t)num_samples[lane]);
+    max_num_samples = AAD_MAX_VAL(max_num_samples, (uint32_t)num_samples[lane]);
+    if (max_sum[lane] < INT64_MAX) {
+      has_limit = 1;
+    }
+  }
+  AADEncoder_LoadLaneStateAVX2(&state, processors, AAD_ENCODER_NUM_LANES);
+
+  vnum_samples = _mm_loadu_si128((const __m128i *)num_samples);
+  /* 64bitの誤差和は偶数レーンと奇数レーンに分けて保持 */
+  vsum_even = vsum_odd = _mm_setzero_si128();
+  vmax_even = _mm_set_epi64x(max_sum[2], max_sum[0]);
+  vmax_odd = _mm_set_epi64x(max_sum[3], max_sum[1]);
+
+  for (smpl = AAD_FILTER_ORDER; smpl < max_num_samples; smpl++) {
+    __m128i vqdiff, vtmp;
+
+    /* 各レーンの入力を取得 */
+    for (lane = 0; lane < AAD_ENCODER_NUM_LANES; lane++) {
+      sample[lane] = (smpl < (uint32_t)num_samples[lane]) ? input[lane][smpl] : 0;
+    }
+
     /* サンプルエンコードを実行し状態更新 エンコード結果は捨てる */
-    AADEncodeProcessor_EncodeSample(processor, input[smpl], bits_per_sample); 
-    /* 量子化後の誤差を累積 */
-    sum_squared_error += processor->quantize_error * processor->quantize_error;
+    if (smpl < min_num_samples) {
+      AADEncoder_EncodeSampleLanesAVX2(&state, &tables, _mm_loadu_si128((const __m128i *)sample));
+      vqdiff = state.quantize_error;
+    } else {
+      /* サンプル数を超えたレーンは状態を保持 */
+      const __m128i vactive = _mm_cmpgt_epi32(vnum_samples, _mm_set1_epi32((int32_t)smpl));
+      prev_state = state;
+      AADEncoder_EncodeSampleLanesAVX2(&state, &tables, _mm_loadu_si128((const __m128i *)sample));
+      vqdiff = _mm_and_si128(state.quantize_error, vactive);
+      state.index = _mm_blendv_epi8(prev_state.index, state.index, vactive);
+      state.quantize_error = _mm_blendv_epi8(prev_state.quantize_error, state.quantize_error, vactive);
+      for (ord = 0; ord < AAD_FILTER_ORDER; ord++) {
+        state.weight[ord] = _mm_blendv_epi8(prev_state.weight[ord], state.weight[ord], vactive);
+        state.history[ord] = _mm_blendv_epi8(prev_state.history[ord], state.history[ord], vactive);
+      }
+    }
+
+    /* 量子化後の誤差を64bitで累積 */
+    vsum_even = _mm_add_epi64(vsum_even, _mm_mul_epi32(vqdiff, vqdiff));
+    vtmp = _mm_srli_epi64(vqdiff, 32);
+    vsum_odd = _mm_add_epi64(vsum_odd, _mm_mul_epi32(vtmp, vtmp));
+
+    /* 全レーンが打ち切り値を超えたら終了 */
+    if (has_limit
+        && (_mm_movemask_epi8(_mm_and_si128(
+              _mm_cmpgt_epi64(vsum_even, vmax_even), _mm_cmpgt_epi64(vsum_odd, vmax_odd))) == 0xFFFF)) {
+      break;
+    }
+  }
+
+  /* 結果を各レーンに反映 */
+  AADEncoder_StoreLaneStateAVX2(&state, processors, num_lanes);
+  _mm_storeu_si128((__m128i *)&sum[0], _mm_unpacklo_epi64(vsum_even, vsum_odd));
+  _mm_storeu_si128((__m128i *)&sum[2], _mm_unpackhi_epi64(vsum_even, vsum_odd));
+  for (lane = 0; lane < num_lanes; lane++) {
+    *(lanes[lane].processor) = processors[lane];
+    lanes[lane].sum_squared_error = (uint64_t)sum[lane];
+  }
+}
+#endif /* AAD_ENCODER_USE_AVX2 */
+
+/* 複数レーンの二乗誤差和を計測 */
+static AADError AADEncoder_CalculateSumSquaredErrorLanes(
+    struct AADEncodeLane *lanes, uint32_t num_lanes, uint8_t bits_per_sample)
+{
+  uint32_t lane;
+  AADError err;
+
+  /* 引数チェック */
+  if ((lanes == NULL) || (num_lanes > AAD_ENCODER_NUM_LANES)) {
+    return AAD_ERROR_INVALID_ARGUMENT;
+  }
+  for (lane = 0; lane < num_lanes; lane++) {
+    if ((lanes[lane].processor == NULL) || (lanes[lane].input == NULL)) {
+      return AAD_ERROR_INVALID_ARGUMENT;
+    }
+  }
+
+#if AAD_ENCODER_USE_AVX2
+  /* 2レーン以上あればまとめて計測 */
+  if ((num_lanes >= 2) && __builtin_cpu_supports("avx2")) {
+    AADEncoder_CalculateSumSquaredErrorLanesAVX2(lanes, num_lanes, bits_per_sample);
+    return AAD_ERROR_OK;
+  }
+#endif
+
+  /* レーンごとに計測 */
+  for (lane = 0; lane < num_lanes; lane++) {
+    if ((err = AADEncodeProcessor_CalculateSumSquaredError(
+            lanes[lane].processor, lanes[lane].input, lanes[lane].num_samples, bits_per_sample,
+            lanes[lane].max_sum_squared_error, &lanes[lane].sum_squared_error)) != AAD_ERROR_OK) {
+      return err;
+    }
   }
 
-  /* RMSEに変換 */
-  (*rmse) = sqrt(sum_squared_error / num_samples);
   return AAD_ERROR_OK;
 }
 
 /* 最大性能をもつエンコードプロセッサの探索 */
 static AADError AADEncoder_SearchBestProcessor(
-    const struct AADEncoder *encoder, 
-    const int32_t *const *input, uint32_t progress, uint32_t num_encode_samples,
+    const struct AADEncoder *encoder,
+    const int32_t *const *input, const int32_t *const *prev_input, uint32_t num_encode_samples,
     struct AADEncodeProcessor *best_processor)
 {
-  uint32_t ch, trial;
-  double min_rmse[AAD_MAX_NUM_CHANNELS];
+  uint32_t ch, trial, num_lanes;
+  uint64_t min_sum_squared_error[AAD_MAX_NUM_CHANNELS];
   struct AADEncodeProcessor tmp_best[AAD_MAX_NUM_CHANNELS];
-  int32_t *buffer[AAD_MAX_NUM_CHANNELS];
-  int32_t *prev_buffer[AAD_MAX_NUM_CHANNELS];
+  struct AADEncodeProcessor baseline[AAD_MAX_NUM_CHANNELS];
+  struct AADEncodeProcessor tmp_processor[AAD_MAX_NUM_CHANNELS];
+  struct AADEncodeLane lanes[AAD_ENCODER_NUM_LANES];
   const struct AADHeaderInfo *header;
   AADError err;
 
@@ -486,72 +1053,83 @@ static AADError AADEncoder_SearchBestProcessor(
   }
   header = &(encoder->header);
 
-  /* 入力をバッファにコピー */
+  /* プロセッサを取得 */
+  memcpy(&tmp_best, encoder->processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
+  memcpy(&baseline, encoder->processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
+  memcpy(&tmp_processor, encoder->processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
+
+  /* 何もしないときの基準値と、先頭の試行の直前ブロックを同時に計測 */
+  num_lanes = 0;
   for (ch = 0; ch < header->num_channels; ch++) {
-    /* ポインタ取得 */
-    buffer[ch] = encoder->input_buffer[ch];
-    memcpy(buffer[ch], &input[ch][progress], sizeof(int32_t) * num_encode_samples);
+    struct AADEncodeLane *lane = &lanes[num_lanes++];
+    lane->processor = &baseline[ch];
+    lane->input = input[ch];
+    lane->num_samples = num_encode_samples;
+    lane->max_sum_squared_error = UINT64_MAX;
+    if (prev_input != NULL) {
+      lane = &lanes[num_lanes++];
+      lane->processor = &tmp_processor[ch];
+      lane->input = prev_input[ch];
+      lane->num_samples = header->num_samples_per_block;
+      lane->max_sum_squared_error = UINT64_MAX;
+    }
   }
-
-  /* LR -> MS */
-  if ((header->num_channels >= 2)
-      && (header->ch_process_method == AAD_CH_PROCESS_METHOD_MS)) {
-    AADEncoder_LRtoMSInterleave(buffer, num_encode_samples);
+  if ((err = AADEncoder_CalculateSumSquaredErrorLanes(
+          lanes, num_lanes, (uint8_t)header->bits_per_sample)) != AAD_ERROR_OK) {
+    return err;
   }
-
-  /* 直前のブロックのデータを準備 */
-  if (progress >= header->num_samples_per_block) {
-    for (ch = 0; ch < header->num_channels; ch++) {
-      prev_buffer[ch] = encoder->work_buffer[ch];
-      memcpy(prev_buffer[ch], &input[ch][progress - header->num_samples_per_block], sizeof(int32_t) * header->num_samples_per_block);
-    }
-    if ((header->num_channels >= 2)
-        && (header->ch_process_method == AAD_CH_PROCESS_METHOD_MS)) {
-      AADEncoder_LRtoMSInterleave(prev_buffer, header->num_samples_per_block);
-    }
+  for (ch = 0; ch < header->num_channels; ch++) {
+    min_sum_squared_error[ch] = lanes[(prev_input != NULL) ? (2 * ch) : ch].sum_squared_error;
   }
 
-  /* プロセッサを取得 */
-  memcpy(&tmp_best, encoder->processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
-
-  /* 何もしないときの基準値を計測 */
-  for (ch = 0; ch < header->num_channels; ch++) { 
-    struct AADEncodeProcessor tmp_processor = encoder->processor[ch];
-    if ((err = AADEncodeProcessor_CalculateRMSError(
-          &tmp_processor, buffer[ch],
-          num_encode_samples, (uint8_t)header->bits_per_sample, &min_rmse[ch])) != AAD_ERROR_OK) {
-      return err;
-    }
+  /* 直前のブロックがなければ、先頭の試行は基準値の計測そのものなので省略 */
+  trial = 0;
+  if (prev_input == NULL) {
+    memcpy(&tmp_processor, &baseline, sizeof(struct AADEncodeProcessor) * header->num_channels);
+    trial = 1;
   }
 
   /* 連続したブロックを複数回エンコードし、最小のRMSEを持つプロセッサを探す */
   /* memo: 複数回エンコードすることでフィルタの適応が早まる。
    * ただし、繰り返した分だけ単調に誤差が小さくなるとは限らないため（過学習など）、最も誤差の小さいプロセッサを採用 */
-  for (ch = 0; ch < header->num_channels; ch++) {
-    struct AADEncodeProcessor tmp_processor = encoder->processor[ch];
-    struct AADEncodeProcessor candidate;
-    for (trial = 0; trial < encoder->num_encode_trials; trial++) {
-      double tmp_rmse;
-      /* 直前のブロック */
-      if (progress >= header->num_samples_per_block) {
-        if ((err = AADEncodeProcessor_CalculateRMSError(
-                &tmp_processor, prev_buffer[ch], 
-                header->num_samples_per_block, (uint8_t)header->bits_per_sample, &tmp_rmse)) != AAD_ERROR_OK) {
-          return err;
-        }
+  /* 補足）試行は直前の試行の状態から始まるため、同時に計測できるのはチャンネル間のみ */
+  for (; trial < encoder->num_encode_trials; trial++) {
+    struct AADEncodeProcessor candidate[AAD_MAX_NUM_CHANNELS];
+    /* 直前のブロック（先頭の試行は計測済み） */
+    if ((prev_input != NULL) && (trial > 0)) {
+      for (ch = 0; ch < header->num_channels; ch++) {
+        lanes[ch].processor = &tmp_processor[ch];
+        lanes[ch].input = prev_input[ch];
+        lanes[ch].num_samples = header->num_samples_per_block;
+        lanes[ch].max_sum_squared_error = UINT64_MAX;
       }
-      /* 採用候補のプロセッサはここでの設定値を用いる */
-      candidate = tmp_processor;
-      /* エンコード対象のブロックのRMSEを計測 */
-      if ((err = AADEncodeProcessor_CalculateRMSError(
-            &tmp_processor, buffer[ch], 
-            num_encode_samples, (uint8_t)header->bits_per_sample, &tmp_rmse)) != AAD_ERROR_OK) {
+      if ((err = AADEncoder_CalculateSumSquaredErrorLanes(
+              lanes, header->num_channels, (uint8_t)header->bits_per_sample)) != AAD_ERROR_OK) {
         return err;
       }
-      /* RMSE基準でプロセッサを選択 */
-      if (min_rmse[ch] > tmp_rmse) {
-        min_rmse[ch] = tmp_rmse;
-        tmp_best[ch] = candidate;
+    }
+    /* 採用候補のプロセッサはここでの設定値を用いる */
+    memcpy(&candidate, &tmp_processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
+    /* エンコード対象のブロックの二乗誤差和を計測 */
+    /* 次の試行はこの計測後のプロセッサ状態から始まるため、打ち切れるのは最後の試行のみ */
+    /* 打ち切った場合の誤差は最小値を超え、選択結果は打ち切らない場合と変わらない */
+    for (ch = 0; ch < header->num_channels; ch++) {
+      lanes[ch].processor = &tmp_processor[ch];
+      lanes[ch].input = input[ch];
+      lanes[ch].num_samples = num_encode_samples;
+      lanes[ch].max_sum_squared_error
+        = ((trial + 1) == (uint32_t)encoder->num_encode_trials) ? min_sum_squared_error[ch] : UINT64_MAX;
+    }
+    if ((err = AADEncoder_CalculateSumSquaredErrorLanes(
+            lanes, header->num_channels, (uint8_t)header->bits_per_sample)) != AAD_ERROR_OK) {
+      return err;
+    }
+    /* 誤差基準でプロセッサを選択 */
+    /* 補足）サンプル数は共通なので、RMSEの比較は二乗誤差和の比較と等価 */
+    for (ch = 0; ch < header->num_channels; ch++) {
+      if (min_sum_squared_error[ch] > lanes[ch].sum_squared_error) {
+        min_sum_squared_error[ch] = lanes[ch].sum_squared_error;
+        tmp_best[ch] = candidate[ch];
       }
     }
   }
@@ -561,6 +1139,226 @@ static AADError AADEncoder_SearchBestProcessor(
   return AAD_ERROR_OK;
 }
 
+/* 独立探索のcandidate番目の候補（初期状態）を作成 */
+static void AADEncoder_MakeSearchCandidate(
+    const struct AADEncodeProcessor *current, const struct AADEncodeProcessor *adapted,
+    uint32_t candidate, struct AADEncodeProcessor *processor)
+{
+  uint32_t order;
+  int32_t index;
+
+  AAD_ASSERT((current != NULL) && (processor != NULL));
+
+  /* 起点（係数の初期値）とステップサイズインデックスのずらし順を決める */
+  /* 直前ブロックがあれば、直前ブロックで適応したプロセッサと現在のプロセッサを交互に起点とする */
+  /* 0: 現在（基準値）, 1: 適応後, 2: 現在+1, 3: 適応後+1, 4: 現在-1, 5: 適応後-1, ... */
+  if (adapted != NULL) {
+    (*processor) = ((candidate % 2) == 1) ? (*adapted) : (*current);
+    order = candidate / 2;
+  } else {
+    (*processor) = (*current);
+    order = candidate;
+  }
+
+  /* ステップサイズインデックスを0, +1, -1, +2, -2, ... 単位ずらす */
+  /* 補足）インデックスと係数はブロックヘッダに記録されるため、どの候補もデコード可能 */
+  index = processor->table.stepsize_index;
+  if ((order % 2) == 1) {
+    index += (int32_t)((order + 1) / 2) * AAD_ENCODER_SEARCH_STEPSIZE_INDEX_OFFSET;
+  } else {
+    index -= (int32_t)(order / 2) * AAD_ENCODER_SEARCH_STEPSIZE_INDEX_OFFSET;
+  }
+  processor->table.stepsize_index
+    = (int16_t)AAD_INNER_VAL(index, 0, AAD_TABLES_INDEX_TO_FLOAT(AAD_STEPSIZE_TABLE_SIZE - 1));
+}
+
+/* 初期状態の異なる独立な候補をレーンで同時に計測し、最大性能をもつエンコードプロセッサを探索 */
+static AADError AADEncoder_SearchBestProcessorIndependent(
+    const struct AADEncoder *encoder,
+    const int32_t *const *input, const int32_t *const *prev_input, uint32_t num_encode_samples,
+    struct AADEncodeProcessor *best_processor)
+{
+  uint32_t ch, lane, job, num_lanes, num_jobs, num_candidates;
+  uint64_t min_sum_squared_error[AAD_MAX_NUM_CHANNELS];
+  uint32_t best_candidate[AAD_MAX_NUM_CHANNELS];
+  uint32_t lane_candidate[AAD_ENCODER_NUM_LANES];
+  struct AADEncodeProcessor adapted[AAD_MAX_NUM_CHANNELS];
+  struct AADEncodeProcessor lane_processor[AAD_ENCODER_NUM_LANES];
+  struct AADEncodeLane lanes[AAD_ENCODER_NUM_LANES];
+  const struct AADHeaderInfo *header;
+  AADError err;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (input == NULL) || (best_processor == NULL)) {
+    return AAD_ERROR_INVALID_ARGUMENT;
+  }
+  header = &(encoder->header);
+
+  for (ch = 0; ch < header->num_channels; ch++) {
+    min_sum_squared_error[ch] = UINT64_MAX;
+    best_candidate[ch] = 0;
+  }
+
+  /* 直前のブロックで1回だけ適応したプロセッサを作り、同時に基準値（0番目の候補）を計測 */
+  job = 0;
+  if (prev_input != NULL) {
+    memcpy(&adapted, encoder->processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
+    memcpy(&lane_processor, encoder->processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
+    for (ch = 0; ch < header->num_channels; ch++) {
+      struct AADEncodeLane *lane_adapt = &lanes[2 * ch], *lane_baseline = &lanes[2 * ch + 1];
+      lane_adapt->processor = &adapted[ch];
+      lane_adapt->input = prev_input[ch];
+      lane_adapt->num_samples = header->num_samples_per_block;
+      lane_adapt->max_sum_squared_error = UINT64_MAX;
+      lane_baseline->processor = &lane_processor[ch];
+      lane_baseline->input = input[ch];
+      lane_baseline->num_samples = num_encode_samples;
+      lane_baseline->max_sum_squared_error = UINT64_MAX;
+    }
+    if ((err = AADEncoder_CalculateSumSquaredErrorLanes(
+            lanes, 2 * (uint32_t)header->num_channels, (uint8_t)header->bits_per_sample)) != AAD_ERROR_OK) {
+      return err;
+    }
+    for (ch = 0; ch < header->num_channels; ch++) {
+      min_sum_squared_error[ch] = lanes[2 * ch + 1].sum_squared_error;
+    }
+    job = header->num_channels;
+  }
+
+  /* 試行回数分の候補（直前ブロックがなければ基準値も）を、チャンネルをまたいでレーン数ずつまとめて計測 */
+  /* memo: 各候補は互いに独立なので、逐次探索と違い全レーンを候補で埋められる */
+  num_candidates = (uint32_t)encoder->num_encode_trials + 1;
+  num_jobs = num_candidates * header->num_channels;
+  for (; job < num_jobs; job += num_lanes) {
+    num_lanes = AAD_MIN_VAL(num_jobs - job, AAD_ENCODER_NUM_LANES);
+    for (lane = 0; lane < num_lanes; lane++) {
+      /* 候補の若い順に並べ、同じ誤差なら若い候補（基準値）を優先する */
+      ch = (job + lane) % header->num_channels;
+      lane_candidate[lane] = (job + lane) / header->num_channels;
+      AADEncoder_MakeSearchCandidate(&encoder->processor[ch],
+          (prev_input != NULL) ? &adapted[ch] : NULL, lane_candidate[lane], &lane_processor[lane]);
+      lanes[lane].processor = &lane_processor[lane];
+      lanes[lane].input = input[ch];
+      lanes[lane].num_samples = num_encode_samples;
+      /* 打ち切った場合の誤差は最小値を超え、選択結果は打ち切らない場合と変わらない */
+      lanes[lane].max_sum_squared_error = min_sum_squared_error[ch];
+    }
+    if ((err = AADEncoder_CalculateSumSquaredErrorLanes(
+            lanes, num_lanes, (uint8_t)header->bits_per_sample)) != AAD_ERROR_OK) {
+      return err;
+    }
+    for (lane = 0; lane < num_lanes; lane++) {
+      ch = (job + lane) % header->num_channels;
+      if (min_sum_squared_error[ch] > lanes[lane].sum_squared_error) {
+        min_sum_squared_error[ch] = lanes[lane].sum_squared_error;
+        best_candidate[ch] = lane_candidate[lane];
+      }
+    }
+  }
+
+  /* 最善プロセッサの記録 計測で状態が進んでいるため初期状態を作り直す */
+  for (ch = 0; ch < header->num_channels; ch++) {
+    AADEncoder_MakeSearchCandidate(&encoder->processor[ch],
+        (prev_input != NULL) ? &adapted[ch] : NULL, best_candidate[ch], &best_processor[ch]);
+  }
+  return AAD_ERROR_OK;
+}
+
+/* 符号配列を1符号ずつ符号列に詰める */
+static void AADEncoder_PackCodesScalar(
+    const uint8_t *codes, uint32_t num_codes, uint8_t bits_per_sample, uint8_t *data)
+{
+  uint32_t i, bitbuf, num_bits;
+
+  AAD_ASSERT((codes != NULL) && (data != NULL));
+  AAD_ASSERT((bits_per_sample >= 1) && (bits_per_sample <= 8));
+  AAD_ASSERT(((num_codes * bits_per_sample) % 8) == 0);
+
+  bitbuf = 0;
+  num_bits = 0;
+  for (i = 0; i < num_codes; i++) {
+    AAD_ASSERT(codes[i] < (1U << bits_per_sample));
+    bitbuf = (bitbuf << bits_per_sample) | codes[i];
+    num_bits += bits_per_sample;
+    /* 揃ったバイトから出力 */
+    while (num_bits >= 8) {
+      num_bits -= 8;
+      (*data++) = (uint8_t)(bitbuf >> num_bits);
+    }
+  }
+}
+
+#if AAD_ENCODER_USE_AVX2
+/* SSSE3で符号配列を符号列に詰める */
+/* 補足）隣接する符号を積和演算で2個→4個と結合し、64bitレーン内で8個分（bits_per_sample[byte]）にまとめる。 */
+/*       左詰めしてからバイト順を入れ替えてビッグエンディアンで取り出し、16符号ずつ出力する。 */
+/*       8符号が32bitに収まる4bit以下に対応する */
+__attribute__((target("ssse3")))
+static uint32_t AADEncoder_PackCodesSSSE3(
+    const uint8_t *codes, uint32_t num_codes, uint8_t bits_per_sample, uint8_t *data)
+{
+  uint32_t i, k;
+  uint8_t shuffle[16];
+  __m128i vpair_multiplier, vquad_multiplier, vshuffle;
+  __m128i vquad_shift, vgroup_shift;
+
+  AAD_ASSERT((codes != NULL) && (data != NULL));
+  AAD_ASSERT((bits_per_sample >= 1) && (bits_per_sample <= 4));
+
+  /* 結合用の乗数: 先頭側の符号を上位に置く */
+  vpair_multiplier = _mm_set1_epi16((short)(0x100 | (1 << bits_per_sample)));
+  vquad_multiplier = _mm_set1_epi32(0x10000 | (1 << (2 * bits_per_sample)));
+  vquad_shift = _mm_cvtsi32_si128(4 * bits_per_sample);
+  vgroup_shift = _mm_cvtsi32_si128(32 - 8 * bits_per_sample);
+
+  /* 各64bitレーンの下位32bitの上位バイトから順にbits_per_sample[byte]を取り出すシャッフル */
+  for (k = 0; k < 16; k++) {
+    shuffle[k] = 0x80;
+  }
+  for (k = 0; k < bits_per_sample; k++) {
+    shuffle[k] = (uint8_t)(3 - k);
+    shuffle[bits_per_sample + k] = (uint8_t)(8 + 3 - k);
+  }
+  vshuffle = _mm_loadu_si128((const __m128i *)shuffle);
+
+  /* 16byteのストアが出力末尾を超えない範囲で処理 */
+  for (i = 0; ((num_codes - i) * bits_per_sample) >= (16 * 8); i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&codes[i]);
+    /* 2符号 -> 16bit, 4符号 -> 32bit */
+    v = _mm_maddubs_epi16(v, vpair_multiplier);
+    v = _mm_madd_epi16(v, vquad_multiplier);
+    /* 8符号 -> 64bitレーンの下位32bit */
+    v = _mm_or_si128(_mm_sll_epi64(v, vquad_shift), _mm_srli_epi64(v, 32));
+    /* 左詰めしてビッグエンディアンで取り出し */
+    v = _mm_sll_epi64(v, vgroup_shift);
+    _mm_storeu_si128((__m128i *)data, _mm_shuffle_epi8(v, vshuffle));
+    data += 2 * bits_per_sample;
+  }
+
+  return i;
+}
+#endif /* AAD_ENCODER_USE_AVX2 */
+
+/* 符号配列を符号列に詰める */
+static void AADEncoder_PackCodes(
+    const uint8_t *codes, uint32_t num_codes, uint8_t bits_per_sample, uint8_t *data)
+{
+  uint32_t i = 0;
+
+  AAD_ASSERT((codes != NULL) && (data != NULL));
+
+#if AAD_ENCODER_USE_AVX2
+  if ((bits_per_sample <= 4) && __builtin_cpu_supports("ssse3")) {
+    i = AADEncoder_PackCodesSSSE3(codes, num_codes, bits_per_sample, data);
+  }
+#endif
+
+  /* 残りは逐次処理 */
+  /* 補足）iは8符号単位の区切りなので、符号列の位置はi * bits_per_sample / 8 */
+  AADEncoder_PackCodesScalar(&codes[i], num_codes - i, bits_per_sample,
+      &data[(i * bits_per_sample) / 8]);
+}
+
 /* 単一データブロックエンコード */
 static AADApiResult AADEncoder_EncodeBlock(
     struct AADEncoder *encoder,
@@ -568,9 +1366,15 @@ static AADApiResult AADEncoder_EncodeBlock(
     uint8_t *data, uint32_t data_size, uint32_t *output_size)
 {
   const struct AADHeaderInfo *header;
-  uint32_t ch, smpl;
+  uint32_t ch, smpl, num_unit_samples, num_chunk_units;
+  void (*encode_unit)(struct AADEncodeProcessor *processor, const int32_t *input, uint8_t *code);
   uint8_t *data_pos;
-  int32_t *buffer[AAD_MAX_NUM_CHANNELS];
+  const int32_t *const *buffer;
+#if AAD_ENCODER_USE_AVX2
+  uint8_t use_avx2;
+  struct AADEncodeLaneTablesAVX2 tables;
+  struct AADEncodeLaneStateAVX2 state;
+#endif
 
   AAD_ASSERT(num_samples <= encoder->header.num_samples_per_block);
 
@@ -584,23 +1388,9 @@ static AADApiResult AADEncoder_EncodeBlock(
   /* 書き出しポインタのセット */
   data_pos = data;
 
-  /* 入力をバッファにコピー */
-  for (ch = 0; ch < header->num_channels; ch++) {
-    /* ポインタ取得 */
-    buffer[ch] = encoder->input_buffer[ch];
-    /* バッファの末尾に前回エンコードの残骸が残る場合があるので、ブロックの大きさで0クリア */
-    memset(buffer[ch], 0, sizeof(int32_t) * header->num_samples_per_block);
-    memcpy(buffer[ch], input[ch], sizeof(int32_t) * num_samples);
-  }
-
-  /* LR -> MS */
-  if (header->ch_process_method == AAD_CH_PROCESS_METHOD_MS) {
-    /* チャンネル数チェック */
-    if (header->num_channels < 2) {
-      return AAD_APIRESULT_INVALID_FORMAT;
-    }
-    AADEncoder_LRtoMSInterleave(buffer, num_samples);
-  }
+  /* 変換済み入力を参照 */
+  /* 補足）データ単位の末尾はブロックあたりサンプル数までの0埋め領域を読む */
+  buffer = input;
 
   /* フィルタに先頭サンプルをセット */
   for (ch = 0; ch < header->num_channels; ch++) {
@@ -657,69 +1447,66 @@ static AADApiResult AADEncoder_EncodeBlock(
   /* ブロックヘッダサイズチェック */
   AAD_ASSERT((uint32_t)(data_pos - data) == AAD_BLOCK_HEADER_SIZE(header->num_channels));
 
-  /* データエンコード */
+  /* データ単位あたりのサンプル数とエンコード関数 */
+  /* 補足）サンプルあたりビット数での分岐はブロックごとに1回だけ行う */
   switch (header->bits_per_sample) {
-    case 4:
-      for (smpl = AAD_FILTER_ORDER; smpl < num_samples; smpl += 2) {
-        uint8_t code[2];
-        for (ch = 0; ch < header->num_channels; ch++) {
-          AAD_ASSERT((uint32_t)(data_pos - data) < data_size);
-          AAD_ASSERT((uint32_t)(data_pos - data) < header->block_size);
-          code[0] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 0], 4);
-          code[1] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 1], 4);
-          AAD_ASSERT((code[0] <= 0xF) && (code[1] <= 0xF));
-          ByteArray_PutUint8(data_pos, (code[0] << 4) | code[1]);
-          AAD_ASSERT((uint32_t)(data_pos - data) <= data_size);
-          AAD_ASSERT((uint32_t)(data_pos - data) <= header->block_size);
-        }
-      }
-      break;
-    case 3:
-      for (smpl = AAD_FILTER_ORDER; smpl < num_samples; smpl += 8) {
-        uint8_t code[8];
-        uint32_t outbuf;
-        for (ch = 0; ch < header->num_channels; ch++) {
-          AAD_ASSERT((uint32_t)(data_pos - data) < data_size);
-          AAD_ASSERT((uint32_t)(data_pos - data) < header->block_size);
-          code[0] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 0], 3);
-          code[1] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 1], 3);
-          code[2] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 2], 3);
-          code[3] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 3], 3);
-          code[4] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 4], 3);
-          code[5] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 5], 3);
-          code[6] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 6], 3);
-          code[7] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 7], 3);
-          AAD_ASSERT((code[0] <= 0x7) && (code[1] <= 0x7) && (code[2] <= 0x7) && (code[3] <= 0x7)
-                  && (code[4] <= 0x7) && (code[5] <= 0x7) && (code[6] <= 0x7) && (code[7] <= 0x7));
-          /* 3byteに詰める */
-          outbuf = (uint32_t)((code[0] << 21) | (code[1] << 18) | (code[2] << 15) | (code[3] << 12)
-                            | (code[4] <<  9) | (code[5] <<  6) | (code[6] <<  3) | (code[7] <<  0));
-          ByteArray_PutUint24BE(data_pos, outbuf);
-          AAD_ASSERT((uint32_t)(data_pos - data) <= data_size);
-          AAD_ASSERT((uint32_t)(data_pos - data) <= header->block_size);
-        }
-      }
-      break;
-    case 2:
-      for (smpl = AAD_FILTER_ORDER; smpl < num_samples; smpl += 4) {
-        uint8_t code[4];
+    case 4: num_unit_samples = 2; encode_unit = AADEncodeProcessor_EncodeUnit4bit; break;
+    case 3: num_unit_samples = 8; encode_unit = AADEncodeProcessor_EncodeUnit3bit; break;
+    case 2: num_unit_samples = 4; encode_unit = AADEncodeProcessor_EncodeUnit2bit; break;
+    default: return AAD_APIRESULT_INVALID_FORMAT;
+  }
+
+#if AAD_ENCODER_USE_AVX2
+  /* 複数チャンネルは各チャンネルをレーンに割り当てて同時にエンコード */
+  use_avx2 = ((header->num_channels >= 2) && __builtin_cpu_supports("avx2")) ? 1 : 0;
+  if (use_avx2) {
+    AADEncoder_InitializeLaneTablesAVX2(&tables, &(encoder->processor[0].table), (uint8_t)header->bits_per_sample);
+    AADEncoder_LoadLaneStateAVX2(&state, encoder->processor, header->num_channels);
+  }
+#endif
+
+  /* データエンコード */
+  /* 補足）データ単位の並び（チャンネルごとに交互）で符号配列に書き出してから、まとめて符号列に詰める */
+  num_chunk_units = AAD_ENCODER_CODE_BUFFER_SIZE / (num_unit_samples * header->num_channels);
+  for (smpl = AAD_FILTER_ORDER; smpl < num_samples; smpl += num_chunk_units * num_unit_samples) {
+    uint8_t codes[AAD_ENCODER_CODE_BUFFER_SIZE];
+    uint32_t unit, num_codes, write_size;
+    const uint32_t num_units
+      = AAD_MIN_VAL(num_chunk_units, (num_samples - smpl + num_unit_samples - 1) / num_unit_samples);
+
+    /* データ単位のサンプルをエンコード */
+    /* 補足）最後のデータ単位はブロック末尾の0埋め領域もエンコードする */
+    for (unit = 0; unit < num_units; unit++) {
+      uint8_t *unit_codes = &codes[unit * num_unit_samples * header->num_channels];
+      const uint32_t unit_smpl = smpl + unit * num_unit_samples;
+#if AAD_ENCODER_USE_AVX2
+      if (use_avx2) {
+        AADEncoder_EncodeUnitLanesAVX2(&state, &tables,
+            buffer, header->num_channels, unit_smpl, num_unit_samples, unit_codes);
+      } else
+#endif
+      {
         for (ch = 0; ch < header->num_channels; ch++) {
-          AAD_ASSERT((uint32_t)(data_pos - data) < data_size);
-          AAD_ASSERT((uint32_t)(data_pos - data) < header->block_size);
-          code[0] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 0], 2);
-          code[1] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 1], 2);
-          code[2] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 2], 2);
-          code[3] = AADEncodeProcessor_EncodeSample(&(encoder->processor[ch]), buffer[ch][smpl + 3], 2);
-          AAD_ASSERT((code[0] <= 0x3) && (code[1] <= 0x3) && (code[2] <= 0x3) && (code[3] <= 0x3));
-          ByteArray_PutUint8(data_pos, (code[0] << 6) | (code[1] << 4) | (code[2] << 2) | ((code[3] << 0)));
-          AAD_ASSERT((uint32_t)(data_pos - data) <= data_size);
-          AAD_ASSERT((uint32_t)(data_pos - data) <= header->block_size);
+          encode_unit(&(encoder->processor[ch]), &buffer[ch][unit_smpl], &unit_codes[ch * num_unit_samples]);
         }
       }
-      break;
-    default:
-      return AAD_APIRESULT_INVALID_FORMAT;
+    }
+
+    /* 符号列に詰めて書き出し */
+    num_codes = num_units * num_unit_samples * header->num_channels;
+    write_size = (num_codes * header->bits_per_sample) / 8;
+    AAD_ASSERT((uint32_t)(data_pos - data) + write_size <= data_size);
+    AAD_ASSERT((uint32_t)(data_pos - data) + write_size <= header->block_size);
+    AADEncoder_PackCodes(codes, num_codes, (uint8_t)header->bits_per_sample, data_pos);
+    data_pos += write_size;
+  }
+
+#if AAD_ENCODER_USE_AVX2
+  /* レーンの状態をプロセッサに反映 */
+  if (use_avx2) {
+    AADEncoder_StoreLaneStateAVX2(&state, encoder->processor, header->num_channels);
   }
+#endif
 
   /* 成功終了 */
   (*output_size) = (uint32_t)(data_pos - data);
@@ -728,7 +1515,7 @@ static AADApiResult AADEncoder_EncodeBlock(
 
 /* エンコードパラメータをヘッダに変換 */
 static AADError AADEncoder_ConvertParameterToHeader(
-    const struct AADEncodeParameter *enc_param, uint32_t num_samples,
+    const struct AADEncodeParameter *enc_param, uint64_t num_samples,
     struct AADHeaderInfo *header_info)
 {
   struct AADHeaderInfo tmp_header = { 0, };
@@ -792,14 +1579,22 @@ AADApiResult AADEncoder_SetEncodeParameter(
   if (AADEncoder_ConvertParameterToHeader(parameter, 0, &tmp_header) != AAD_ERROR_OK) {
     return AAD_APIRESULT_INVALID_FORMAT;
   }
+  /* 異常な探索法 */
+  if (parameter->search_method >= AAD_SEARCH_METHOD_INVALID) {
+    return AAD_APIRESULT_INVALID_FORMAT;
+  }
 
   /* テーブルの初期化 */
   for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
     AADTable_Initialize(&(encoder->processor[ch].table), parameter->bits_per_sample);
   }
 
-  /* エンコード繰り返し回数のセット */
+  /* エンコード繰り返し回数と探索法のセット */
   encoder->num_encode_trials = parameter->num_encode_trials;
+  encoder->search_method = parameter->search_method;
+
+  /* 直前ブロックの変換済み入力を破棄 */
+  encoder->prev_input_buffered = 0;
 
   /* ヘッダ設定 */
   encoder->header = tmp_header;
@@ -810,16 +1605,125 @@ AADApiResult AADEncoder_SetEncodeParameter(
   return AAD_APIRESULT_OK;
 }
 
+/* プロセッサを探索した上で単一データブロックをエンコード */
+static AADApiResult AADEncoder_SearchAndEncodeBlock(
+    struct AADEncoder *encoder,
+    const struct AADSampleBuffer *input, uint64_t input_offset,
+    const struct AADSampleBuffer *prev_input, uint64_t prev_offset, uint32_t num_encode_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+  uint32_t ch;
+  AADApiResult ret;
+  const struct AADHeaderInfo *header = &(encoder->header);
+
+  AAD_ASSERT(num_encode_samples <= header->num_samples_per_block);
+
+  /* エンコード対象ブロックを変換 */
+  if (AADEncoder_ConvertInput(header,
+        input, input_offset, num_encode_samples, encoder->input_buffer) != AAD_ERROR_OK) {
+    return AAD_APIRESULT_INVALID_FORMAT;
+  }
+
+  /* 性能のよいプロセッサの探索 */
+  if (encoder->num_encode_trials > 0) {
+    struct AADEncodeProcessor best_processor[AAD_MAX_NUM_CHANNELS];
+    const int32_t *const *prev_buffer;
+    AADError err;
+    /* 直前ブロックは前回変換したものを使う 保持していなければここで変換 */
+    /* 補足）保持していればprev_inputがNULLでも直前ブロックとして使う（ストリーミング時） */
+    if ((prev_input != NULL) && (encoder->prev_input_buffered == 0)) {
+      if (AADEncoder_ConvertInput(header,
+            prev_input, prev_offset, header->num_samples_per_block, encoder->prev_input_buffer) != AAD_ERROR_OK) {
+        return AAD_APIRESULT_INVALID_FORMAT;
+      }
+    }
+    prev_buffer = ((prev_input != NULL) || (encoder->prev_input_buffered == 1))
+      ? (const int32_t *const *)encoder->prev_input_buffer : NULL;
+    /* 探索法に応じて探索 */
+    if (encoder->search_method == AAD_SEARCH_METHOD_INDEPENDENT) {
+      err = AADEncoder_SearchBestProcessorIndependent(encoder,
+          (const int32_t *const *)encoder->input_buffer, prev_buffer, num_encode_samples, &best_processor[0]);
+    } else {
+      err = AADEncoder_SearchBestProcessor(encoder,
+          (const int32_t *const *)encoder->input_buffer, prev_buffer, num_encode_samples, &best_processor[0]);
+    }
+    if (err != AAD_ERROR_OK) {
+      return AAD_APIRESULT_NG;
+    }
+    /* 見つけたプロセッサをセット */
+    memcpy(encoder->processor, &best_processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
+  }
+
+  /* ブロックエンコード */
+  if ((ret = AADEncoder_EncodeBlock(encoder,
+          (const int32_t *const *)encoder->input_buffer, num_encode_samples,
+          data, data_size, output_size)) != AAD_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* 変換済みの現在ブロックを直前ブロックとし、バッファを入れ替える */
+  /* 補足）呼び出し側は時系列順にブロックをエンコードする。順序が途切れるときは保持フラグを下ろすこと */
+  for (ch = 0; ch < header->num_channels; ch++) {
+    int32_t *tmp = encoder->prev_input_buffer[ch];
+    encoder->prev_input_buffer[ch] = encoder->input_buffer[ch];
+    encoder->input_buffer[ch] = tmp;
+  }
+  encoder->prev_input_buffered = 1;
+
+  return AAD_APIRESULT_OK;
+}
+
+/* 入力信号の指定位置のブロックをエンコード */
+static AADApiResult AADEncoder_SearchAndEncodeBlockAt(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input, uint64_t progress,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+  uint32_t num_encode_samples;
+  const struct AADHeaderInfo *header = &(encoder->header);
+
+  AAD_ASSERT(progress < input->num_samples);
+
+  /* エンコードサンプル数の確定 */
+  num_encode_samples
+    = (uint32_t)AAD_MIN_VAL(header->num_samples_per_block, input->num_samples - progress);
+
+  /* 直前ブロックは入力の先頭ブロック以外で参照 */
+  if (progress >= header->num_samples_per_block) {
+    return AADEncoder_SearchAndEncodeBlock(encoder,
+        input, progress, input, progress - header->num_samples_per_block,
+        num_encode_samples, data, data_size, output_size);
+  }
+
+  return AADEncoder_SearchAndEncodeBlock(encoder,
+      input, progress, NULL, 0, num_encode_samples, data, data_size, output_size);
+}
+
 /* ヘッダ含めファイル全体をエンコード */
 AADApiResult AADEncoder_EncodeWhole(
     struct AADEncoder *encoder,
-    const int32_t *const *input, uint32_t num_samples,
-    uint8_t *data, uint32_t data_size, uint32_t *output_size)
+    const int32_t *const *input, uint64_t num_samples,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size)
+{
+  struct AADSampleBuffer buffer;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (input == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  AADSampleBuffer_SetPlanarInt32(&buffer, (int32_t *const *)input, encoder->header.num_channels, num_samples);
+  return AADEncoder_EncodeWholeFromBuffer(encoder, &buffer, data, data_size, output_size);
+}
+
+/* サンプルバッファ記述子からヘッダ含めファイル全体をエンコード */
+AADApiResult AADEncoder_EncodeWholeFromBuffer(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size)
 {
   AADApiResult ret;
-  uint32_t progress, ch, write_size, write_offset, num_encode_samples;
+  uint32_t write_size;
+  uint64_t progress, write_offset, num_samples;
   uint8_t *data_pos;
-  const int32_t *input_ptr[AAD_MAX_NUM_CHANNELS];
   const struct AADHeaderInfo *header;
 
   /* 引数チェック */
@@ -833,6 +1737,12 @@ AADApiResult AADEncoder_EncodeWhole(
     return AAD_APIRESULT_PARAMETER_NOT_SET;
   }
 
+  /* 入力バッファのチェック */
+  if (AADSampleBuffer_Check(input, encoder->header.num_channels, input->num_samples) != AAD_ERROR_OK) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+  num_samples = input->num_samples;
+
   /* 書き出し位置を取得 */
   data_pos = data;
 
@@ -845,42 +1755,24 @@ AADApiResult AADEncoder_EncodeWhole(
   header = &(encoder->header);
 
   /* 進捗状況初期化 */
+  encoder->prev_input_buffered = 0;
   progress = 0;
   write_offset = AAD_HEADER_SIZE;
   data_pos = data + AAD_HEADER_SIZE;
 
   /* ブロックを時系列順にエンコード */
   while (progress < num_samples) {
-    /* エンコードサンプル数の確定 */
-    num_encode_samples
-      = AAD_MIN_VAL(header->num_samples_per_block, num_samples - progress);
-    /* サンプル参照位置のセット */
-    for (ch = 0; ch < header->num_channels; ch++) {
-      input_ptr[ch] = &input[ch][progress];
-    }
-
-    /* 性能のよいプロセッサの探索 */
-    if (encoder->num_encode_trials > 0) {
-      struct AADEncodeProcessor best_processor[AAD_MAX_NUM_CHANNELS];
-      if (AADEncoder_SearchBestProcessor(
-            encoder, input, progress, num_encode_samples, &best_processor[0]) != AAD_ERROR_OK) {
-        return AAD_APIRESULT_NG;
-      }
-      /* 見つけたプロセッサをセット */
-      memcpy(encoder->processor, &best_processor, sizeof(struct AADEncodeProcessor) * header->num_channels);
-    }
-
     /* ブロックエンコード */
-    if ((ret = AADEncoder_EncodeBlock(encoder,
-            input_ptr, num_encode_samples,
-            data_pos, data_size - write_offset, &write_size)) != AAD_APIRESULT_OK) {
+    if ((ret = AADEncoder_SearchAndEncodeBlockAt(encoder,
+            input, progress, data_pos, (uint32_t)AAD_MIN_VAL(data_size - write_offset, header->block_size),
+            &write_size)) != AAD_APIRESULT_OK) {
       return ret;
     }
 
     /* 進捗更新 */
     data_pos      += write_size;
     write_offset  += write_size;
-    progress      += num_encode_samples;
+    progress      += header->num_samples_per_block;
     AAD_ASSERT(write_size <= header->block_size);
     AAD_ASSERT(write_offset <= data_size);
   }
@@ -889,3 +1781,411 @@ AADApiResult AADEncoder_EncodeWhole(
   (*output_size) = write_offset;
   return AAD_APIRESULT_OK;
 }
+
+/* エンコード後のデータサイズ（ファイルヘッダを含む）を計算 */
+static uint64_t AADEncoder_CalculateEncodedDataSize(
+    const struct AADHeaderInfo *header, uint64_t num_samples)
+{
+  uint64_t num_full_blocks, data_size;
+  uint32_t num_rest_samples, interleave_data_unit_size, num_samples_per_interleave_data_unit;
+
+  AAD_ASSERT(header != NULL);
+
+  /* 最終ブロック以外は全てブロックサイズで出力される */
+  num_full_blocks = num_samples / header->num_samples_per_block;
+  num_rest_samples = (uint32_t)(num_samples % header->num_samples_per_block);
+  data_size = AAD_HEADER_SIZE + num_full_blocks * header->block_size;
+
+  /* 最終ブロックはデータ単位に切り上げたサイズになる */
+  if (num_rest_samples > 0) {
+    data_size += AAD_BLOCK_HEADER_SIZE(header->num_channels);
+    if (num_rest_samples > AAD_FILTER_ORDER) {
+      interleave_data_unit_size = header->num_channels * (AADEncoder_CalculateLCM(8, header->bits_per_sample) / 8);
+      num_samples_per_interleave_data_unit = (interleave_data_unit_size * 8) / (header->num_channels * header->bits_per_sample);
+      data_size += interleave_data_unit_size
+        * ((num_rest_samples - AAD_FILTER_ORDER + num_samples_per_interleave_data_unit - 1) / num_samples_per_interleave_data_unit);
+    }
+  }
+
+  return data_size;
+}
+
+/* ワーカが担当するブロック範囲をエンコード */
+static void *AADEncodeWorker_Run(void *arg)
+{
+  uint32_t write_size;
+  uint64_t blk, write_offset;
+  struct AADEncodeWorker *worker = (struct AADEncodeWorker *)arg;
+  const struct AADHeaderInfo *header = &(worker->encoder->header);
+
+  AAD_ASSERT(worker != NULL);
+
+  /* 直前のブロックをエンコードして状態を温める 出力は捨てる */
+  for (blk = worker->warmup_block; blk < worker->start_block; blk++) {
+    if ((worker->result = AADEncoder_SearchAndEncodeBlockAt(worker->encoder,
+            &(worker->input), blk * header->num_samples_per_block,
+            worker->scratch, header->block_size, &write_size)) != AAD_APIRESULT_OK) {
+      return NULL;
+    }
+  }
+
+  /* 担当範囲のエンコード ブロックサイズは固定なので書き出し位置は直接計算できる */
+  for (blk = worker->start_block; blk < worker->end_block; blk++) {
+    write_offset = AAD_HEADER_SIZE + blk * header->block_size;
+    AAD_ASSERT(write_offset < worker->data_size);
+    if ((worker->result = AADEncoder_SearchAndEncodeBlockAt(worker->encoder,
+            &(worker->input), blk * header->num_samples_per_block,
+            &(worker->data[write_offset]), (uint32_t)AAD_MIN_VAL(worker->data_size - write_offset, header->block_size),
+            &write_size)) != AAD_APIRESULT_OK) {
+      return NULL;
+    }
+  }
+
+  return NULL;
+}
+
+/* ヘッダ含めファイル全体を複数スレッドでエンコード */
+AADApiResult AADEncoder_EncodeWholeParallel(
+    struct AADEncoder *encoder,
+    const int32_t *const *input, uint64_t num_samples,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
+{
+  struct AADSampleBuffer buffer;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (input == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  AADSampleBuffer_SetPlanarInt32(&buffer, (int32_t *const *)input, encoder->header.num_channels, num_samples);
+  return AADEncoder_EncodeWholeParallelFromBuffer(encoder, &buffer,
+      data, data_size, output_size, num_threads, num_warmup_blocks);
+}
+
+/* サンプルバッファ記述子からヘッダ含めファイル全体を複数スレッドでエンコード */
+AADApiResult AADEncoder_EncodeWholeParallelFromBuffer(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
+{
+  AADApiResult ret;
+  uint32_t i, num_workers;
+  uint64_t num_samples, num_blocks, encoded_data_size;
+  const struct AADHeaderInfo *header;
+  struct AADEncodeWorker *workers;
+  pthread_t *threads;
+  uint8_t *thread_created;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (input == NULL)
+      || (data == NULL) || (output_size == NULL) || (num_threads == 0)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* パラメータ未セットではエンコードできない */
+  if (encoder->set_parameter == 0) {
+    return AAD_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  /* 入力バッファのチェック */
+  if (AADSampleBuffer_Check(input, encoder->header.num_channels, input->num_samples) != AAD_ERROR_OK) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+  num_samples = input->num_samples;
+
+  /* 並列化の余地がなければ逐次処理 */
+  num_blocks = (num_samples + encoder->header.num_samples_per_block - 1) / encoder->header.num_samples_per_block;
+  num_workers = (uint32_t)AAD_MIN_VAL(num_threads, num_blocks);
+  if (num_workers <= 1) {
+    return AADEncoder_EncodeWholeFromBuffer(encoder, input, data, data_size, output_size);
+  }
+
+  /* ヘッダエンコード */
+  encoder->header.num_samples = num_samples;
+  if ((ret = AADEncoder_EncodeHeader(&(encoder->header), data, data_size))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  header = &(encoder->header);
+
+  /* 各ワーカは決まった位置に書き出すため、先に出力サイズを確認 */
+  encoded_data_size = AADEncoder_CalculateEncodedDataSize(header, num_samples);
+  if (data_size < encoded_data_size) {
+    return AAD_APIRESULT_INSUFFICIENT_BUFFER;
+  }
+
+  /* ワーカ領域確保 */
+  workers = (struct AADEncodeWorker *)calloc(num_workers, sizeof(struct AADEncodeWorker));
+  threads = (pthread_t *)malloc(sizeof(pthread_t) * num_workers);
+  thread_created = (uint8_t *)malloc(sizeof(uint8_t) * num_workers);
+  if ((workers == NULL) || (threads == NULL) || (thread_created == NULL)) {
+    ret = AAD_APIRESULT_NG;
+    goto EXIT;
+  }
+
+  /* 連続したブロック範囲ごとに分割 */
+  /* 各ワーカはエンコーダの初期状態から始め、担当範囲の直前num_warmup_blocksブロックで状態を温める */
+  for (i = 0; i < num_workers; i++) {
+    struct AADEncodeWorker *worker = &workers[i];
+    worker->encoder = AADEncoder_Create(header->block_size, NULL, 0);
+    worker->scratch = (uint8_t *)malloc(header->block_size);
+    if ((worker->encoder == NULL) || (worker->scratch == NULL)) {
+      ret = AAD_APIRESULT_NG;
+      goto EXIT;
+    }
+    worker->encoder->header             = encoder->header;
+    worker->encoder->num_encode_trials  = encoder->num_encode_trials;
+    worker->encoder->search_method      = encoder->search_method;
+    worker->encoder->set_parameter      = 1;
+    memcpy(worker->encoder->processor, encoder->processor, sizeof(struct AADEncodeProcessor) * AAD_MAX_NUM_CHANNELS);
+    worker->input         = (*input);
+    worker->data          = data;
+    worker->data_size     = data_size;
+    worker->start_block   = (num_blocks * i) / num_workers;
+    worker->end_block     = (num_blocks * (i + 1)) / num_workers;
+    worker->warmup_block  = (worker->start_block > num_warmup_blocks) ? (worker->start_block - num_warmup_blocks) : 0;
+    worker->result        = AAD_APIRESULT_OK;
+  }
+
+  /* 先頭以外のワーカをスレッドで起動 先頭は呼び出しスレッドで処理 */
+  /* スレッドが作れなかった場合は呼び出しスレッドで処理 */
+  for (i = 1; i < num_workers; i++) {
+    thread_created[i] = (pthread_create(&threads[i], NULL, AADEncodeWorker_Run, &workers[i]) == 0) ? 1 : 0;
+  }
+  AADEncodeWorker_Run(&workers[0]);
+  for (i = 1; i < num_workers; i++) {
+    if (thread_created[i] == 1) {
+      pthread_join(threads[i], NULL);
+    } else {
+      AADEncodeWorker_Run(&workers[i]);
+    }
+  }
+
+  /* 結果集約: 先頭側のエラーを優先 */
+  ret = AAD_APIRESULT_OK;
+  for (i = 0; i < num_workers; i++) {
+    if (workers[i].result != AAD_APIRESULT_OK) {
+      ret = workers[i].result;
+      break;
+    }
+  }
+
+  /* 末尾ワーカの状態をエンコーダに反映（逐次処理と同様に続けて使えるように） */
+  memcpy(encoder->processor, workers[num_workers - 1].encoder->processor, sizeof(struct AADEncodeProcessor) * AAD_MAX_NUM_CHANNELS);
+
+  /* 成功終了 */
+  if (ret == AAD_APIRESULT_OK) {
+    (*output_size) = encoded_data_size;
+  }
+
+EXIT:
+  if (workers != NULL) {
+    for (i = 0; i < num_workers; i++) {
+      AADEncoder_Destroy(workers[i].encoder);
+      free(workers[i].scratch);
+    }
+  }
+  free(workers);
+  free(threads);
+  free(thread_created);
+
+  return ret;
+}
+
+/* ストリーミングエンコードの開始 */
+AADApiResult AADEncoder_BeginEncodeStream(
+    struct AADEncoder *encoder, uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+  AADApiResult ret;
+  uint32_t ch;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (data == NULL) || (output_size == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* パラメータ未セットではエンコードできない */
+  if (encoder->set_parameter == 0) {
+    return AAD_APIRESULT_PARAMETER_NOT_SET;
+  }
+
+  /* ヘッダエンコード */
+  /* 総サンプル数は未確定のため不明として書き出す */
+  encoder->header.num_samples = AAD_NUM_SAMPLES_UNKNOWN;
+  if ((ret = AADEncoder_EncodeHeader(&(encoder->header), data, data_size))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* プロセッサを初期状態に戻す */
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    AADEncodeProcessor_Reset(&(encoder->processor[ch]));
+    AADTable_Initialize(&(encoder->processor[ch].table), encoder->header.bits_per_sample);
+  }
+
+  /* ストリーミング状態の初期化 */
+  encoder->prev_input_buffered = 0;
+  encoder->stream_num_buffered_samples = 0;
+  encoder->stream_num_samples = 0;
+  encoder->stream_begun = 1;
+
+  /* 成功終了 */
+  (*output_size) = AAD_HEADER_SIZE;
+  return AAD_APIRESULT_OK;
+}
+
+/* ストリーミング時に現在ブロックをエンコード */
+static AADApiResult AADEncoder_EncodeStreamBlock(
+    struct AADEncoder *encoder, uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+  AADApiResult ret;
+  struct AADSampleBuffer input;
+
+  AAD_ASSERT(encoder != NULL);
+  AAD_ASSERT(encoder->stream_num_buffered_samples > 0);
+
+  /* 溜めたブロックは16bit幅の値で持っている */
+  AADSampleBuffer_SetPlanarInt32(&input,
+      encoder->stream_buffer, encoder->header.num_channels, encoder->header.num_samples_per_block);
+
+  /* ブロックエンコード */
+  /* 補足）直前ブロックはエンコーダが変換済みのものを保持しているので渡さない */
+  if ((ret = AADEncoder_SearchAndEncodeBlock(encoder,
+          &input, 0, NULL, 0,
+          encoder->stream_num_buffered_samples, data, data_size, output_size)) != AAD_APIRESULT_OK) {
+    return ret;
+  }
+  encoder->stream_num_buffered_samples = 0;
+
+  return AAD_APIRESULT_OK;
+}
+
+/* ストリーミングエンコード */
+AADApiResult AADEncoder_EncodeStream(
+    struct AADEncoder *encoder,
+    const int32_t *const *input, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+  struct AADSampleBuffer buffer;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (input == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  AADSampleBuffer_SetPlanarInt32(&buffer, (int32_t *const *)input, encoder->header.num_channels, num_samples);
+  return AADEncoder_EncodeStreamFromBuffer(encoder, &buffer, data, data_size, output_size);
+}
+
+/* サンプルバッファ記述子からストリーミングエンコード */
+AADApiResult AADEncoder_EncodeStreamFromBuffer(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+  AADApiResult ret;
+  uint32_t ch, write_offset, write_size;
+  uint64_t progress, num_blocks, num_samples;
+  const struct AADHeaderInfo *header;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (input == NULL)
+      || (data == NULL) || (output_size == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 開始していないストリームには入力できない */
+  if (encoder->stream_begun == 0) {
+    return AAD_APIRESULT_NG;
+  }
+  header = &(encoder->header);
+
+  /* 入力バッファのチェック */
+  if (AADSampleBuffer_Check(input, header->num_channels, input->num_samples) != AAD_ERROR_OK) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+  num_samples = input->num_samples;
+
+  /* 出力されるブロック数から必要な出力サイズを確認 入力は一切消費しない */
+  num_blocks = (encoder->stream_num_buffered_samples + num_samples) / header->num_samples_per_block;
+  if (data_size < num_blocks * header->block_size) {
+    return AAD_APIRESULT_INSUFFICIENT_BUFFER;
+  }
+
+  progress = 0;
+  write_offset = 0;
+  while (progress < num_samples) {
+    /* 現在ブロックに溜める */
+    const uint32_t num_copy_samples = (uint32_t)AAD_MIN_VAL(
+        header->num_samples_per_block - encoder->stream_num_buffered_samples, num_samples - progress);
+    for (ch = 0; ch < header->num_channels; ch++) {
+      AADSampleBuffer_ReadChannel(input, ch, progress, num_copy_samples,
+          &(encoder->stream_buffer[ch][encoder->stream_num_buffered_samples]));
+    }
+    encoder->stream_num_buffered_samples += num_copy_samples;
+    encoder->stream_num_samples += num_copy_samples;
+    progress += num_copy_samples;
+
+    /* ブロックが揃ったらエンコード */
+    if (encoder->stream_num_buffered_samples == header->num_samples_per_block) {
+      if ((ret = AADEncoder_EncodeStreamBlock(encoder,
+              &data[write_offset], data_size - write_offset, &write_size)) != AAD_APIRESULT_OK) {
+        return ret;
+      }
+      write_offset += write_size;
+      AAD_ASSERT(write_size == header->block_size);
+      AAD_ASSERT(write_offset <= data_size);
+    }
+  }
+
+  /* 成功終了 */
+  (*output_size) = write_offset;
+  return AAD_APIRESULT_OK;
+}
+
+/* ストリーミングエンコードの終了 */
+AADApiResult AADEncoder_FinishEncodeStream(
+    struct AADEncoder *encoder,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    uint8_t *header_data, uint32_t header_data_size)
+{
+  AADApiResult ret;
+  uint32_t write_size;
+
+  /* 引数チェック */
+  if ((encoder == NULL) || (data == NULL)
+      || (output_size == NULL) || (header_data == NULL)) {
+    return AAD_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* 開始していないストリームは終了できない */
+  if (encoder->stream_begun == 0) {
+    return AAD_APIRESULT_NG;
+  }
+
+  /* 総サンプル数を確定したヘッダを出力 */
+  encoder->header.num_samples = encoder->stream_num_samples;
+  if ((ret = AADEncoder_EncodeHeader(&(encoder->header), header_data, header_data_size))
+      != AAD_APIRESULT_OK) {
+    return ret;
+  }
+
+  /* 残りのサンプルを最終ブロックとしてエンコード */
+  write_size = 0;
+  if (encoder->stream_num_buffered_samples > 0) {
+    if (data_size < encoder->header.block_size) {
+      return AAD_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+    if ((ret = AADEncoder_EncodeStreamBlock(encoder,
+            data, data_size, &write_size)) != AAD_APIRESULT_OK) {
+      return ret;
+    }
+  }
+
+  /* ストリーミング終了 */
+  encoder->stream_begun = 0;
+
+  /* 成功終了 */
+  (*output_size) = write_size;
+  return AAD_APIRESULT_OK;
+}
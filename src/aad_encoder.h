@@ -4,14 +4,22 @@
 #include "aad.h"
 #include <stdint.h>
 
+/* プロセッサ探索法 */
+typedef enum AADSearchMethodTag {
+  AAD_SEARCH_METHOD_SEQUENTIAL = 0,   /* 直前ブロックでの適応を繰り返す（試行は直列）   */
+  AAD_SEARCH_METHOD_INDEPENDENT,      /* 初期状態の異なる独立な候補をレーンで同時に計測 */
+  AAD_SEARCH_METHOD_INVALID           /* 無効値                                         */
+} AADSearchMethod;
+
 /* エンコードパラメータ */
 struct AADEncodeParameter {
   uint16_t num_channels;                      /* チャンネル数               */
   uint32_t sampling_rate;                     /* サンプリングレート         */
   uint16_t bits_per_sample;                   /* サンプルあたりビット数     */
-  uint16_t max_block_size;                    /* 最大ブロックサイズ[byte]   */
+  uint32_t max_block_size;                    /* 最大ブロックサイズ[byte]   */
   AADChannelProcessMethod ch_process_method;  /* マルチチャンネル処理法     */
   uint8_t  num_encode_trials;                 /* エンコード繰り返し回数     */
+  AADSearchMethod search_method;              /* プロセッサ探索法           */
 };
 
 /* エンコーダハンドル */
@@ -23,18 +31,19 @@ extern "C" {
 
 /* ブロックサイズとブロックあたりサンプル数の計算 */
 AADApiResult AADEncoder_CalculateBlockSize(
-    uint16_t max_block_size, uint16_t num_channels, uint32_t bits_per_sample,
-    uint16_t *block_size, uint32_t *num_samples_per_block);
+    uint32_t max_block_size, uint16_t num_channels, uint32_t bits_per_sample,
+    uint32_t *block_size, uint32_t *num_samples_per_block);
 
 /* ヘッダエンコード */
 AADApiResult AADEncoder_EncodeHeader(
-    const struct AADHeaderInfo *header_info, uint8_t *data, uint32_t data_size);
+    const struct AADHeaderInfo *header_info, uint8_t *data, uint64_t data_size);
 
 /* エンコーダワークサイズ計算 */
-int32_t AADEncoder_CalculateWorkSize(uint16_t max_block_size);
+/* 補足）ワークサイズがint32_tに収まらない最大ブロックサイズでは負値を返す */
+int32_t AADEncoder_CalculateWorkSize(uint32_t max_block_size);
 
 /* エンコーダハンドル作成 */
-struct AADEncoder *AADEncoder_Create(uint16_t max_block_size, void *work, int32_t work_size);
+struct AADEncoder *AADEncoder_Create(uint32_t max_block_size, void *work, int32_t work_size);
 
 /* エンコーダハンドル破棄 */
 void AADEncoder_Destroy(struct AADEncoder *encoder);
@@ -45,10 +54,60 @@ AADApiResult AADEncoder_SetEncodeParameter(
 
 /* ヘッダ含めファイル全体をエンコード */
 AADApiResult AADEncoder_EncodeWhole(
+    struct AADEncoder *encoder,
+    const int32_t *const *input, uint64_t num_samples,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size);
+
+/* サンプルバッファ記述子からヘッダ含めファイル全体をエンコード */
+/* 補足）総サンプル数はinput->num_samples。型変換・チャンネル処理・クリップはブロックごとに入力を読む際に行う */
+AADApiResult AADEncoder_EncodeWholeFromBuffer(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size);
+
+/* ヘッダ含めファイル全体を複数スレッドでエンコード */
+/* 補足）ブロック列を連続区間に分割して並列処理する。各区間は直前num_warmup_blocksブロックを */
+/*       捨てエンコードして状態を温めてから開始する。ウォームアップがデータ先頭まで届けば結果はAADEncoder_EncodeWholeと一致 */
+AADApiResult AADEncoder_EncodeWholeParallel(
+    struct AADEncoder *encoder,
+    const int32_t *const *input, uint64_t num_samples,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size,
+    uint32_t num_threads, uint32_t num_warmup_blocks);
+
+/* サンプルバッファ記述子からヘッダ含めファイル全体を複数スレッドでエンコード */
+AADApiResult AADEncoder_EncodeWholeParallelFromBuffer(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input,
+    uint8_t *data, uint64_t data_size, uint64_t *output_size,
+    uint32_t num_threads, uint32_t num_warmup_blocks);
+
+/* ストリーミングエンコードの開始 */
+/* 補足）ストリーミングAPIのサイズ・サンプル数は1回の呼び出しで扱う分であり、総サンプル数は64bitで数える */
+/* 補足）総サンプル数をAAD_NUM_SAMPLES_UNKNOWNとしたヘッダをdataに出力する。このヘッダのままでもデコードできるので、 */
+/*       ブロックをソケットやパイプに書き流すだけでよい。確定したヘッダはAADEncoder_FinishEncodeStreamで得られる */
+AADApiResult AADEncoder_BeginEncodeStream(
+    struct AADEncoder *encoder, uint8_t *data, uint32_t data_size, uint32_t *output_size);
+
+/* ストリーミングエンコード */
+/* 補足）任意のサンプル数を入力できる。揃ったブロックだけをエンコードしてdataに出力し、残りは内部に保持する */
+/*       出力ブロック数分のdata_sizeが無いときは入力を消費せずAAD_APIRESULT_INSUFFICIENT_BUFFERを返す */
+AADApiResult AADEncoder_EncodeStream(
     struct AADEncoder *encoder,
     const int32_t *const *input, uint32_t num_samples,
     uint8_t *data, uint32_t data_size, uint32_t *output_size);
 
+/* サンプルバッファ記述子からストリーミングエンコード */
+/* 補足）入力サンプル数はinput->num_samples */
+AADApiResult AADEncoder_EncodeStreamFromBuffer(
+    struct AADEncoder *encoder, const struct AADSampleBuffer *input,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size);
+
+/* ストリーミングエンコードの終了 */
+/* 補足）内部に残ったサンプルを最終ブロックとしてdataに出力し、総サンプル数を反映したヘッダをheader_dataに出力する */
+/*       出力先をシークできる場合は、出力先頭のヘッダをheader_dataで書き換えると総サンプル数が確定する */
+AADApiResult AADEncoder_FinishEncodeStream(
+    struct AADEncoder *encoder,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    uint8_t *header_data, uint32_t header_data_size);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,201 @@
+#include "aad_sample_buffer.h"
+#include <stddef.h>
+
+/* 浮動小数の正規化係数 */
+#define AAD_SAMPLE_BUFFER_FLOAT_SCALE 32768.0f
+
+/* チャンネルの先頭要素の位置を計算 */
+#define AAD_SAMPLE_BUFFER_CHANNEL_OFFSET(buffer, ch, offset)\
+  (((buffer)->layout == AAD_SAMPLE_LAYOUT_INTERLEAVED) ? ((offset) * (buffer)->stride + (ch)) : ((offset) * (buffer)->stride))
+
+/* チャンネルの配列先頭を取得 */
+#define AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch)\
+  (((buffer)->layout == AAD_SAMPLE_LAYOUT_INTERLEAVED) ? (buffer)->channels[0] : (buffer)->channels[(ch)])
+
+/* サンプルバッファ記述子の検査 */
+AADError AADSampleBuffer_Check(
+    const struct AADSampleBuffer *buffer, uint32_t num_channels, uint64_t num_samples)
+{
+  uint32_t ch;
+
+  /* 引数チェック */
+  if (buffer == NULL) {
+    return AAD_ERROR_INVALID_ARGUMENT;
+  }
+
+  /* 型・並び・間隔のチェック */
+  if ((buffer->format >= AAD_SAMPLE_FORMAT_INVALID)
+      || (buffer->layout >= AAD_SAMPLE_LAYOUT_INVALID)
+      || (buffer->stride == 0)) {
+    return AAD_ERROR_INVALID_ARGUMENT;
+  }
+
+  /* チャンネル数・サンプル数のチェック */
+  if ((buffer->num_channels < num_channels)
+      || (buffer->num_channels > AAD_MAX_NUM_CHANNELS)
+      || (buffer->num_samples < num_samples)) {
+    return AAD_ERROR_INSUFFICIENT_BUFFER;
+  }
+
+  /* 配列のチェック */
+  if (buffer->layout == AAD_SAMPLE_LAYOUT_INTERLEAVED) {
+    /* 1サンプル分の全チャンネルが重ならないこと */
+    if ((buffer->channels[0] == NULL) || (buffer->stride < buffer->num_channels)) {
+      return AAD_ERROR_INVALID_ARGUMENT;
+    }
+  } else {
+    for (ch = 0; ch < num_channels; ch++) {
+      if (buffer->channels[ch] == NULL) {
+        return AAD_ERROR_INVALID_ARGUMENT;
+      }
+    }
+  }
+
+  return AAD_ERROR_OK;
+}
+
+/* 16bit幅の値をint32_tで持つプレーナ配列を記述子にセット */
+void AADSampleBuffer_SetPlanarInt32(
+    struct AADSampleBuffer *buffer, int32_t *const *channels, uint32_t num_channels, uint64_t num_samples)
+{
+  uint32_t ch;
+
+  AAD_ASSERT(buffer != NULL);
+  AAD_ASSERT(num_channels <= AAD_MAX_NUM_CHANNELS);
+
+  buffer->format = AAD_SAMPLE_FORMAT_INT32;
+  buffer->layout = AAD_SAMPLE_LAYOUT_PLANAR;
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    buffer->channels[ch] = ((channels != NULL) && (ch < num_channels)) ? channels[ch] : NULL;
+  }
+  buffer->num_channels = num_channels;
+  buffer->num_samples = num_samples;
+  buffer->stride = 1;
+}
+
+/* 記述子が16bit幅の値をint32_tで持つ間隔1のプレーナ配列か判定 */
+uint8_t AADSampleBuffer_IsPlanarInt32(const struct AADSampleBuffer *buffer)
+{
+  AAD_ASSERT(buffer != NULL);
+
+  return ((buffer->format == AAD_SAMPLE_FORMAT_INT32)
+      && (buffer->layout == AAD_SAMPLE_LAYOUT_PLANAR) && (buffer->stride == 1)) ? 1 : 0;
+}
+
+/* 1チャンネル分のサンプルを16bit幅に変換・クリップしてdstに読み出し */
+void AADSampleBuffer_ReadChannel(
+    const struct AADSampleBuffer *buffer, uint32_t ch, uint64_t offset, uint32_t num_samples, int32_t *dst)
+{
+  uint32_t smpl;
+  size_t pos;
+  const size_t stride = buffer->stride;
+
+  AAD_ASSERT((buffer != NULL) && (dst != NULL));
+  AAD_ASSERT(ch < buffer->num_channels);
+  AAD_ASSERT((offset + num_samples) <= buffer->num_samples);
+
+  pos = (size_t)AAD_SAMPLE_BUFFER_CHANNEL_OFFSET(buffer, ch, offset);
+
+  /* 型での分岐はループの外で行う */
+  switch (buffer->format) {
+    case AAD_SAMPLE_FORMAT_INT16:
+      {
+        const int16_t *src = (const int16_t *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          dst[smpl] = src[pos];
+        }
+      }
+      break;
+    case AAD_SAMPLE_FORMAT_INT32:
+      {
+        const int32_t *src = (const int32_t *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          dst[smpl] = AAD_INNER_VAL(src[pos], INT16_MIN, INT16_MAX);
+        }
+      }
+      break;
+    case AAD_SAMPLE_FORMAT_INT32_MSB:
+      {
+        /* 下位16bitは切り捨て */
+        const int32_t *src = (const int32_t *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          dst[smpl] = src[pos] >> 16;
+        }
+      }
+      break;
+    case AAD_SAMPLE_FORMAT_FLOAT32:
+      {
+        /* 16bit幅にスケーリングし、範囲外はクリップしてから四捨五入 */
+        const float *src = (const float *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          float val = src[pos] * AAD_SAMPLE_BUFFER_FLOAT_SCALE;
+          if (val != val) {
+            /* NaNは無音として扱う */
+            val = 0.0f;
+          } else if (val > (float)INT16_MAX) {
+            val = (float)INT16_MAX;
+          } else if (val < (float)INT16_MIN) {
+            val = (float)INT16_MIN;
+          }
+          dst[smpl] = (int32_t)((val >= 0.0f) ? (val + 0.5f) : (val - 0.5f));
+        }
+      }
+      break;
+    default:
+      AAD_ASSERT(0);
+  }
+}
+
+/* 16bit幅の値srcを変換して1チャンネル分書き込み */
+void AADSampleBuffer_WriteChannel(
+    const struct AADSampleBuffer *buffer, uint32_t ch, uint64_t offset, uint32_t num_samples, const int32_t *src)
+{
+  uint32_t smpl;
+  size_t pos;
+  const size_t stride = buffer->stride;
+
+  AAD_ASSERT((buffer != NULL) && (src != NULL));
+  AAD_ASSERT(ch < buffer->num_channels);
+  AAD_ASSERT((offset + num_samples) <= buffer->num_samples);
+
+  pos = (size_t)AAD_SAMPLE_BUFFER_CHANNEL_OFFSET(buffer, ch, offset);
+
+  /* 型での分岐はループの外で行う */
+  switch (buffer->format) {
+    case AAD_SAMPLE_FORMAT_INT16:
+      {
+        int16_t *dst = (int16_t *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          dst[pos] = (int16_t)AAD_INNER_VAL(src[smpl], INT16_MIN, INT16_MAX);
+        }
+      }
+      break;
+    case AAD_SAMPLE_FORMAT_INT32:
+      {
+        int32_t *dst = (int32_t *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          dst[pos] = src[smpl];
+        }
+      }
+      break;
+    case AAD_SAMPLE_FORMAT_INT32_MSB:
+      {
+        /* 上位16bitに配置（シフトでなく乗算で負値を扱う） */
+        int32_t *dst = (int32_t *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          dst[pos] = AAD_INNER_VAL(src[smpl], INT16_MIN, INT16_MAX) * (1 << 16);
+        }
+      }
+      break;
+    case AAD_SAMPLE_FORMAT_FLOAT32:
+      {
+        float *dst = (float *)AAD_SAMPLE_BUFFER_CHANNEL_BASE(buffer, ch);
+        for (smpl = 0; smpl < num_samples; smpl++, pos += stride) {
+          dst[pos] = (float)src[smpl] / AAD_SAMPLE_BUFFER_FLOAT_SCALE;
+        }
+      }
+      break;
+    default:
+      AAD_ASSERT(0);
+  }
+}
@@ -0,0 +1,38 @@
+/* 多重インクルード防止 */
+#ifndef AAD_SAMPLE_BUFFER_H_INCLUDED
+#define AAD_SAMPLE_BUFFER_H_INCLUDED
+
+#include <stdint.h>
+#include "aad_internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* サンプルバッファ記述子の検査 */
+/* 補足）num_channelsチャンネル・num_samplesサンプルを読み書きできるか確認する */
+AADError AADSampleBuffer_Check(
+    const struct AADSampleBuffer *buffer, uint32_t num_channels, uint64_t num_samples);
+
+/* 16bit幅の値をint32_tで持つプレーナ配列を記述子にセット */
+/* 補足）従来のint32_t **を受け取るAPIで使う */
+void AADSampleBuffer_SetPlanarInt32(
+    struct AADSampleBuffer *buffer, int32_t *const *channels, uint32_t num_channels, uint64_t num_samples);
+
+/* 記述子が16bit幅の値をint32_tで持つ間隔1のプレーナ配列か判定 */
+/* 補足）この形式はコーデック内部の作業形式と同じなので変換を省ける */
+uint8_t AADSampleBuffer_IsPlanarInt32(const struct AADSampleBuffer *buffer);
+
+/* 1チャンネル分のサンプルを16bit幅に変換・クリップしてdstに読み出し */
+void AADSampleBuffer_ReadChannel(
+    const struct AADSampleBuffer *buffer, uint32_t ch, uint64_t offset, uint32_t num_samples, int32_t *dst);
+
+/* 16bit幅の値srcを変換して1チャンネル分書き込み */
+void AADSampleBuffer_WriteChannel(
+    const struct AADSampleBuffer *buffer, uint32_t ch, uint64_t offset, uint32_t num_samples, const int32_t *src);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* AAD_SAMPLE_BUFFER_H_INCLUDED */
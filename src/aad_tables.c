@@ -5,7 +5,7 @@
 #define AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(flt)  (int16_t)((flt) * (1 << AAD_TABLES_FLOAT_DIGITS))
 
 /* インデックス変動テーブル: 4bit */
-static const int16_t AAD_index_table_4bit[16] = {
+const int16_t AAD_index_table_4bit[16] = {
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(-1.17),
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(-1.07),
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(-0.9),
@@ -25,7 +25,7 @@ static const int16_t AAD_index_table_4bit[16] = {
 };
 
 /* インデックス変動テーブル: 3bit */
-static const int16_t AAD_index_table_3bit[8] = {
+const int16_t AAD_index_table_3bit[8] = {
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(-1.06),
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(-0.95),
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY( 2),
@@ -37,7 +37,7 @@ static const int16_t AAD_index_table_3bit[8] = {
 };
 
 /* インデックス変動テーブル: 2bit */
-static const int16_t AAD_index_table_2bit[4] = {
+const int16_t AAD_index_table_2bit[4] = {
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(-0.9),
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY( 2.5),
   AAD_TABLES_DEFINE_INDEX_TABLE_ENTRY(-0.9),
@@ -53,41 +53,86 @@ static const int16_t AAD_index_table_1bit[2] = {
 };
 #endif
 
-/* ステップサイズ量子化テーブル */
+/* ステップサイズ量子化テーブルの要素リスト */
 /* x ** 1.1 + 2 ** (log2(32767 - 255 ** 1.1) / 255 * x) で生成 */
-static const uint16_t AAD_stepsize_table[AAD_STEPSIZE_TABLE_SIZE] = {
-  1, 2, 3, 4, 6, 7, 8, 10,
-  11, 13, 14, 16, 17, 18, 20, 22,
-  23, 25, 26, 28, 29, 31, 32, 34,
-  36, 37, 39, 41, 42, 44, 46, 47,
-  49, 51, 52, 54, 56, 58, 59, 61,
-  63, 65, 67, 68, 70, 72, 74, 76,
-  78, 80, 82, 84, 86, 87, 89, 92,
-  94, 96, 98, 100, 102, 104, 106, 108,
-  111, 113, 115, 117, 120, 122, 124, 127,
-  129, 132, 134, 137, 139, 142, 145, 147,
-  150, 153, 156, 158, 161, 164, 167, 171,
-  174, 177, 180, 184, 187, 190, 194, 198,
-  201, 205, 209, 213, 217, 221, 226, 230,
-  235, 239, 244, 249, 254, 259, 264, 270,
-  275, 281, 287, 293, 299, 306, 312, 319,
-  326, 333, 341, 349, 357, 365, 373, 382,
-  391, 401, 411, 421, 431, 442, 453, 464,
-  476, 489, 502, 515, 529, 543, 558, 573,
-  589, 605, 622, 640, 658, 677, 697, 717,
-  739, 761, 784, 808, 832, 858, 885, 912,
-  941, 971, 1002, 1034, 1068, 1103, 1139, 1177,
-  1216, 1257, 1299, 1343, 1389, 1436, 1486, 1537,
-  1591, 1646, 1704, 1765, 1827, 1892, 1960, 2031,
-  2104, 2181, 2260, 2343, 2429, 2519, 2612, 2709,
-  2810, 2915, 3025, 3139, 3257, 3381, 3509, 3643,
-  3782, 3927, 4078, 4235, 4399, 4569, 4746, 4931,
-  5123, 5323, 5531, 5748, 5974, 6209, 6454, 6709,
-  6974, 7250, 7538, 7838, 8150, 8475, 8813, 9165,
-  9532, 9914, 10312, 10726, 11158, 11607, 12075, 12562,
-  13070, 13598, 14149, 14722, 15319, 15940, 16588, 17262,
-  17964, 18695, 19457, 20250, 21076, 21936, 22832, 23765,
-  24737, 25749, 26803, 27901, 29044, 30235, 31475, 32767,
+#define AAD_TABLES_STEPSIZE_LIST(X) \
+  X(1) X(2) X(3) X(4) X(6) X(7) X(8) X(10) \
+  X(11) X(13) X(14) X(16) X(17) X(18) X(20) X(22) \
+  X(23) X(25) X(26) X(28) X(29) X(31) X(32) X(34) \
+  X(36) X(37) X(39) X(41) X(42) X(44) X(46) X(47) \
+  X(49) X(51) X(52) X(54) X(56) X(58) X(59) X(61) \
+  X(63) X(65) X(67) X(68) X(70) X(72) X(74) X(76) \
+  X(78) X(80) X(82) X(84) X(86) X(87) X(89) X(92) \
+  X(94) X(96) X(98) X(100) X(102) X(104) X(106) X(108) \
+  X(111) X(113) X(115) X(117) X(120) X(122) X(124) X(127) \
+  X(129) X(132) X(134) X(137) X(139) X(142) X(145) X(147) \
+  X(150) X(153) X(156) X(158) X(161) X(164) X(167) X(171) \
+  X(174) X(177) X(180) X(184) X(187) X(190) X(194) X(198) \
+  X(201) X(205) X(209) X(213) X(217) X(221) X(226) X(230) \
+  X(235) X(239) X(244) X(249) X(254) X(259) X(264) X(270) \
+  X(275) X(281) X(287) X(293) X(299) X(306) X(312) X(319) \
+  X(326) X(333) X(341) X(349) X(357) X(365) X(373) X(382) \
+  X(391) X(401) X(411) X(421) X(431) X(442) X(453) X(464) \
+  X(476) X(489) X(502) X(515) X(529) X(543) X(558) X(573) \
+  X(589) X(605) X(622) X(640) X(658) X(677) X(697) X(717) \
+  X(739) X(761) X(784) X(808) X(832) X(858) X(885) X(912) \
+  X(941) X(971) X(1002) X(1034) X(1068) X(1103) X(1139) X(1177) \
+  X(1216) X(1257) X(1299) X(1343) X(1389) X(1436) X(1486) X(1537) \
+  X(1591) X(1646) X(1704) X(1765) X(1827) X(1892) X(1960) X(2031) \
+  X(2104) X(2181) X(2260) X(2343) X(2429) X(2519) X(2612) X(2709) \
+  X(2810) X(2915) X(3025) X(3139) X(3257) X(3381) X(3509) X(3643) \
+  X(3782) X(3927) X(4078) X(4235) X(4399) X(4569) X(4746) X(4931) \
+  X(5123) X(5323) X(5531) X(5748) X(5974) X(6209) X(6454) X(6709) \
+  X(6974) X(7250) X(7538) X(7838) X(8150) X(8475) X(8813) X(9165) \
+  X(9532) X(9914) X(10312) X(10726) X(11158) X(11607) X(12075) X(12562) \
+  X(13070) X(13598) X(14149) X(14722) X(15319) X(15940) X(16588) X(17262) \
+  X(17964) X(18695) X(19457) X(20250) X(21076) X(21936) X(22832) X(23765) \
+  X(24737) X(25749) X(26803) X(27901) X(29044) X(30235) X(31475) X(32767)
+
+/* ステップサイズ量子化テーブル */
+#define AAD_TABLES_DEFINE_STEPSIZE_ENTRY(step) step,
+const uint16_t AAD_stepsize_table[AAD_STEPSIZE_TABLE_SIZE] = {
+  AAD_TABLES_STEPSIZE_LIST(AAD_TABLES_DEFINE_STEPSIZE_ENTRY)
+};
+
+/* ステップサイズ逆数テーブル: floor(2**RECIPROCAL_DIGITS / stepsize) + 1 */
+#define AAD_TABLES_DEFINE_RECIPROCAL_ENTRY(step) \
+  ((((uint64_t)1 << AAD_TABLES_RECIPROCAL_DIGITS) / (step)) + 1),
+const uint64_t AAD_stepsize_reciprocal_table[AAD_STEPSIZE_TABLE_SIZE] = {
+  AAD_TABLES_STEPSIZE_LIST(AAD_TABLES_DEFINE_RECIPROCAL_ENTRY)
+};
+
+/* ステップサイズと符号から量子化した差分を計算 */
+/* diff = stepsize * (delta * 2 + 1) / 2**(bits_per_sample-1) に符号ビットを反映 */
+#define AAD_TABLES_QDIFF(step, code, bits_per_sample) \
+  ((((code) >> ((bits_per_sample) - 1)) & 1) \
+   ? -(((step) * ((((code) & ((1 << ((bits_per_sample) - 1)) - 1)) << 1) + 1)) >> ((bits_per_sample) - 1)) \
+   :  (((step) * ((((code) & ((1 << ((bits_per_sample) - 1)) - 1)) << 1) + 1)) >> ((bits_per_sample) - 1)))
+
+/* 量子化差分テーブルの行定義マクロ */
+#define AAD_TABLES_QDIFF_ROW_4BIT(step) { \
+    AAD_TABLES_QDIFF(step,  0, 4), AAD_TABLES_QDIFF(step,  1, 4), AAD_TABLES_QDIFF(step,  2, 4), AAD_TABLES_QDIFF(step,  3, 4), \
+    AAD_TABLES_QDIFF(step,  4, 4), AAD_TABLES_QDIFF(step,  5, 4), AAD_TABLES_QDIFF(step,  6, 4), AAD_TABLES_QDIFF(step,  7, 4), \
+    AAD_TABLES_QDIFF(step,  8, 4), AAD_TABLES_QDIFF(step,  9, 4), AAD_TABLES_QDIFF(step, 10, 4), AAD_TABLES_QDIFF(step, 11, 4), \
+    AAD_TABLES_QDIFF(step, 12, 4), AAD_TABLES_QDIFF(step, 13, 4), AAD_TABLES_QDIFF(step, 14, 4), AAD_TABLES_QDIFF(step, 15, 4) \
+  },
+#define AAD_TABLES_QDIFF_ROW_3BIT(step) { \
+    AAD_TABLES_QDIFF(step,  0, 3), AAD_TABLES_QDIFF(step,  1, 3), AAD_TABLES_QDIFF(step,  2, 3), AAD_TABLES_QDIFF(step,  3, 3), \
+    AAD_TABLES_QDIFF(step,  4, 3), AAD_TABLES_QDIFF(step,  5, 3), AAD_TABLES_QDIFF(step,  6, 3), AAD_TABLES_QDIFF(step,  7, 3) \
+  },
+#define AAD_TABLES_QDIFF_ROW_2BIT(step) { \
+    AAD_TABLES_QDIFF(step,  0, 2), AAD_TABLES_QDIFF(step,  1, 2), AAD_TABLES_QDIFF(step,  2, 2), AAD_TABLES_QDIFF(step,  3, 2) \
+  },
+
+/* 量子化差分テーブル: [ステップサイズテーブルインデックス][符号] */
+const int32_t AAD_qdiff_table_4bit[AAD_STEPSIZE_TABLE_SIZE][16] = {
+  AAD_TABLES_STEPSIZE_LIST(AAD_TABLES_QDIFF_ROW_4BIT)
+};
+const int32_t AAD_qdiff_table_3bit[AAD_STEPSIZE_TABLE_SIZE][8] = {
+  AAD_TABLES_STEPSIZE_LIST(AAD_TABLES_QDIFF_ROW_3BIT)
+};
+const int32_t AAD_qdiff_table_2bit[AAD_STEPSIZE_TABLE_SIZE][4] = {
+  AAD_TABLES_STEPSIZE_LIST(AAD_TABLES_QDIFF_ROW_2BIT)
 };
 
 /* テーブルの初期化 */
@@ -99,14 +144,17 @@ void AADTable_Initialize(struct AADTable *table, uint16_t bits_per_sample)
   case 4:
     table->index_table = AAD_index_table_4bit;
     table->index_table_size = AAD_NUM_TABLE_ELEMENTS(AAD_index_table_4bit);
+    table->qdiff_table = &AAD_qdiff_table_4bit[0][0];
     break;
   case 3:
     table->index_table = AAD_index_table_3bit;
     table->index_table_size = AAD_NUM_TABLE_ELEMENTS(AAD_index_table_3bit);
+    table->qdiff_table = &AAD_qdiff_table_3bit[0][0];
     break;
   case 2:
     table->index_table = AAD_index_table_2bit;
     table->index_table_size = AAD_NUM_TABLE_ELEMENTS(AAD_index_table_2bit);
+    table->qdiff_table = &AAD_qdiff_table_2bit[0][0];
     break;
   default:
     AAD_ASSERT(0);
@@ -114,4 +162,5 @@ void AADTable_Initialize(struct AADTable *table, uint16_t bits_per_sample)
 
   table->stepsize_index = 0;
   table->stepsize_table = &AAD_stepsize_table[0];
+  table->stepsize_reciprocal_table = &AAD_stepsize_reciprocal_table[0];
 }
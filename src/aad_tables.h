@@ -13,6 +13,11 @@
 #define AAD_TABLES_FLOAT_0_5 (1 << (AAD_TABLES_FLOAT_DIGITS - 1))
 /* 固定小数 -> ステップサイズテーブルインデックス */
 #define AAD_TABLES_FLOAT_TO_INDEX(flt) (((flt) + AAD_TABLES_FLOAT_0_5) >> AAD_TABLES_FLOAT_DIGITS)
+/* ステップサイズ逆数の固定小数部の桁数 */
+#define AAD_TABLES_RECIPROCAL_DIGITS 40
+/* 逆数乗算で正確に除算できる被除数の最大値 */
+/* 補足）被除数 < 2**RECIPROCAL_DIGITS / 最大ステップサイズ ならば床関数の結果は除算と一致する */
+#define AAD_TABLES_MAX_DIVIDEND (1 << 18)
 /* ステップサイズテーブルインデックス -> 固定小数 */
 #define AAD_TABLES_INDEX_TO_FLOAT(idx) ((idx) << AAD_TABLES_FLOAT_DIGITS)
 
@@ -22,11 +27,25 @@ struct AADTable {
   int16_t index_table_size;
   int16_t stepsize_index;
   const uint16_t *stepsize_table;
+  const int32_t *qdiff_table;   /* 量子化差分テーブル [ステップサイズテーブルインデックス][符号] */
+  const uint64_t *stepsize_reciprocal_table;  /* ステップサイズ逆数テーブル */
 };
 
 /* ステップサイズ取得 */
 #define AADTable_GetStepSize(table) ((table)->stepsize_table[AAD_TABLES_FLOAT_TO_INDEX((table)->stepsize_index)])
 
+/* ステップサイズによる除算 floor(val / stepsize) を逆数乗算で計算 */
+/* 補足）valは0以上AAD_TABLES_MAX_DIVIDEND以下であること */
+#define AADTable_DivideByStepSize(table, val)\
+  ((int32_t)(((uint64_t)(val)\
+      * (table)->stepsize_reciprocal_table[AAD_TABLES_FLOAT_TO_INDEX((table)->stepsize_index)])\
+    >> AAD_TABLES_RECIPROCAL_DIGITS))
+
+/* 量子化した差分の取得 */
+/* 補足）ステップサイズと符号から計算される差分をテーブル引きで得る（符号反映済み） */
+#define AADTable_GetQuantizedDiff(table, code)\
+  ((table)->qdiff_table[AAD_TABLES_FLOAT_TO_INDEX((table)->stepsize_index) * (table)->index_table_size + (code)])
+
 /* インデックスの更新 */
 #define AADTable_UpdateIndex(table, code)\
   do {\
@@ -42,10 +61,36 @@ struct AADTable {
     (table)->stepsize_index = (inx);\
   } while (0)
 
+/* サンプルあたりビット数を固定したインデックスの更新 */
+/* 補足）ビット数ごとに特殊化した処理向け。テーブルを直接参照する */
+#define AADTable_UpdateIndexNbit(stepsize_index, code, bits_per_sample)\
+  do {\
+    int16_t inx = (stepsize_index);\
+    AAD_ASSERT((code) < (1 << (bits_per_sample)));\
+    (inx) = (int16_t)((inx) + AAD_index_table_ ## bits_per_sample ## bit[(code)]);\
+    (inx) = AAD_INNER_VAL((inx), 0,\
+        AAD_TABLES_INDEX_TO_FLOAT(AAD_STEPSIZE_TABLE_SIZE - 1));\
+    AAD_ASSERT(AAD_TABLES_FLOAT_TO_INDEX(inx) < AAD_STEPSIZE_TABLE_SIZE);\
+    (stepsize_index) = (inx);\
+  } while (0)
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/* インデックス変動テーブル */
+extern const int16_t AAD_index_table_4bit[16];
+extern const int16_t AAD_index_table_3bit[8];
+extern const int16_t AAD_index_table_2bit[4];
+/* ステップサイズ量子化テーブル */
+extern const uint16_t AAD_stepsize_table[AAD_STEPSIZE_TABLE_SIZE];
+/* ステップサイズ逆数テーブル */
+extern const uint64_t AAD_stepsize_reciprocal_table[AAD_STEPSIZE_TABLE_SIZE];
+/* 量子化差分テーブル: [ステップサイズテーブルインデックス][符号] */
+extern const int32_t AAD_qdiff_table_4bit[AAD_STEPSIZE_TABLE_SIZE][16];
+extern const int32_t AAD_qdiff_table_3bit[AAD_STEPSIZE_TABLE_SIZE][8];
+extern const int32_t AAD_qdiff_table_2bit[AAD_STEPSIZE_TABLE_SIZE][4];
+
 /* テーブルの初期化 */
 void AADTable_Initialize(struct AADTable *table, uint16_t bits_per_sample);
 
@@ -4,17 +4,27 @@
  * To Public License, Version 2, as published by Sam Hocevar. See
  * http://www.wtfpl.net/ for more details. */
 
+/* clock_gettime, stat, opendir等のPOSIXの宣言を有効にする */
+#define _POSIX_C_SOURCE 200112L
+
 #include "aad.h"
 #include "aad_encoder.h"
 #include "aad_decoder.h"
 #include "wav.h"
+#include "mapped_file.h"
 #include "command_line_parser.h"
+#include "work_stealing_pool.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
-#include <sys/stat.h>
+#include <ctype.h>
 #include <math.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <pthread.h>
 
 /* コマンドライン仕様 */
 static struct CommandLineParserSpecification command_line_spec[] = {
@@ -48,6 +58,18 @@ static struct CommandLineParserSpecification command_line_spec[] = {
   { 'm', "ms-conversion", COMMAND_LINE_PARSER_FALSE, 
     "Switch to use LR to MS conversion (default: no)", 
     NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'S', "independent-search", COMMAND_LINE_PARSER_FALSE,
+    "Switch to search independent starting states (current/adapted weights with shifted step sizes) in SIMD lanes instead of repeated trials (default: no)",
+    NULL, COMMAND_LINE_PARSER_FALSE },
+  { 'j', "num-threads", COMMAND_LINE_PARSER_TRUE, 
+    "Specify number of threads for encoding/decoding (default: 1)",
+    "1", COMMAND_LINE_PARSER_FALSE },
+  { 'w', "num-warmup-blocks", COMMAND_LINE_PARSER_TRUE,
+    "Specify number of warm-up blocks per segment in parallel encoding (default: 2)",
+    "2", COMMAND_LINE_PARSER_FALSE },
+  { 'B', "batch", COMMAND_LINE_PARSER_FALSE,
+    "Batch mode for encode/decode (INPUT: directory or list file of input files, OUTPUT: output directory)",
+    NULL, COMMAND_LINE_PARSER_FALSE },
   { 'h', "help", COMMAND_LINE_PARSER_FALSE, 
     "Show help message", 
     NULL, COMMAND_LINE_PARSER_FALSE },
@@ -57,172 +79,621 @@ static struct CommandLineParserSpecification command_line_spec[] = {
   { 0, }
 };
 
-/* デコード処理 */
-static int execute_decode(const char *adpcm_filename, const char *decoded_filename)
+/* 実行環境がリトルエンディアンか判定 */
+static int is_little_endian(void)
 {
-  FILE                      *fp;
-  struct stat               fstat;
-  uint8_t                   *buffer;
-  uint32_t                  buffer_size;
-  struct AADDecoder         *decoder;
-  struct AADHeaderInfo      header;
-  struct WAVFile            *wav;
-  struct WAVFileFormat      wavformat;
-  int32_t                   *output[AAD_MAX_NUM_CHANNELS];
-  uint32_t                  ch, smpl;
-  AADApiResult              ret;
+  const uint16_t val = 1;
+  return (*((const uint8_t *)&val) == 1) ? 1 : 0;
+}
 
-  /* ファイルオープン */
-  fp = fopen(adpcm_filename, "rb");
-  if (fp == NULL) {
-    fprintf(stderr, "Failed to open %s. \n", adpcm_filename);
-    return 1;
+/* ファイル名が標準入出力を表すか判定 */
+static int is_stdio_filename(const char *filename)
+{
+  return (strcmp(filename, "-") == 0) ? 1 : 0;
+}
+
+/* エラーメッセージ出力の排他とスレッドごとの接頭辞（バッチ処理で処理中のファイル名） */
+static pthread_mutex_t error_message_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t error_message_prefix_key;
+static uint8_t error_message_prefix_enabled = 0;
+
+/* エラーメッセージ出力 */
+/* 補足）並列に処理するワーカのメッセージが混ざらないよう1行ずつ排他して出力する */
+static void print_error_message(const char *format, ...)
+{
+  va_list ap;
+  const char *prefix = NULL;
+
+  if (error_message_prefix_enabled) {
+    prefix = (const char *)pthread_getspecific(error_message_prefix_key);
   }
 
-  /* 入力ファイルのサイズ取得 / バッファ領域割り当て */
-  stat(adpcm_filename, &fstat);
-  buffer_size = (uint32_t)fstat.st_size;
-  buffer = (uint8_t *)malloc(buffer_size);
-  /* バッファ領域にデータをロード */
-  fread(buffer, sizeof(uint8_t), buffer_size, fp);
-  fclose(fp);
+  pthread_mutex_lock(&error_message_mutex);
+  if (prefix != NULL) {
+    fprintf(stderr, "%s: ", prefix);
+  }
+  va_start(ap, format);
+  vfprintf(stderr, format, ap);
+  va_end(ap);
+  pthread_mutex_unlock(&error_message_mutex);
+}
 
-  /* デコーダ作成 */
-  decoder = AADDecoder_Create(NULL, 0);
+/* wavのストリーミング読み込みを開始（"-"は標準入力） */
+static struct WAVReadStream *open_wav_read_stream(const char *filename, struct WAVFileFormat *format)
+{
+  if (is_stdio_filename(filename)) {
+    return WAV_OpenReadStreamFromFilePointer(stdin, format);
+  }
+  return WAV_OpenReadStream(filename, format);
+}
+
+/* wavのストリーミング書き込みを開始（"-"は標準出力） */
+static struct WAVWriteStream *open_wav_write_stream(const char *filename, const struct WAVFileFormat *format)
+{
+  if (is_stdio_filename(filename)) {
+    return WAV_OpenWriteStreamToFilePointer(stdout, format);
+  }
+  return WAV_OpenWriteStream(filename, format);
+}
+
+/* デコード処理（デコーダを受け取る） */
+/* 補足）失敗時も確保した資源は解放する（バッチ処理で繰り返し呼ぶため） */
+static int execute_decode_core(struct AADDecoder *decoder,
+    const char *adpcm_filename, const char *decoded_filename, uint32_t num_threads)
+{
+  struct MappedFile         in_map, out_map;
+  struct AADHeaderInfo      header;
+  struct WAVFileFormat      wavformat;
+  struct AADSampleBuffer    output;
+  uint64_t                  num_samples, output_size;
+  AADApiResult              api_result;
+  int                       ret = 1;
+
+  in_map.data = out_map.data = NULL;
+  in_map.size = out_map.size = 0;
+  in_map.fd = out_map.fd = -1;
+
+  /* 入力ファイルを読み込み専用でマップ */
+  if (MappedFile_OpenRead(adpcm_filename, &in_map) != MAPPED_FILE_APIRESULT_OK) {
+    print_error_message("Failed to open %s. \n", adpcm_filename);
+    goto EXIT;
+  }
 
   /* ヘッダ読み取り */
-  if ((ret = AADDecoder_DecodeHeader(buffer, buffer_size, &header))
+  if ((api_result = AADDecoder_DecodeHeader(in_map.data, in_map.size, &header))
       != AAD_APIRESULT_OK) {
-    fprintf(stderr, "Failed to read header. API result: %d \n", ret);
-    return 1;
+    print_error_message("Failed to read header. API result: %d \n", api_result);
+    goto EXIT;
   }
 
-  /* 出力バッファ領域確保 */
-  for (ch = 0; ch < header.num_channels; ch++) {
-    output[ch] = malloc(sizeof(int32_t) * header.num_samples);
+  /* 総サンプル数（不明な場合はデータサイズから求まる） */
+  if ((api_result = AADDecoder_CalculateNumSamples(&header, in_map.size, &num_samples))
+      != AAD_APIRESULT_OK) {
+    print_error_message("Failed to read header. API result: %d \n", api_result);
+    goto EXIT;
   }
 
-  /* 全データをデコード */
-  if ((ret = AADDecoder_DecodeWhole(decoder, 
-        buffer, buffer_size, output, 
-        header.num_channels, header.num_samples)) != AAD_APIRESULT_OK) {
-    fprintf(stderr, "Failed to decode. API result: %d \n", ret);
-    return 1;
+  /* wavはサイズを32bitで持つため、それを超える長さは書き出せない */
+  output_size = WAV_HEADER_SIZE + num_samples * header.num_channels * sizeof(int16_t);
+  if (output_size > UINT32_MAX) {
+    print_error_message("Too long to write as wav file: %s \n", decoded_filename);
+    goto EXIT;
   }
 
-  /* 出力ファイルを作成 */
+  /* 出力ファイルを16bitPCMのwavとして必要なサイズで作成してマップ */
   wavformat.data_format = WAV_DATA_FORMAT_PCM;
   wavformat.num_channels = header.num_channels;
   wavformat.sampling_rate = header.sampling_rate;
   wavformat.bits_per_sample = 16;
-  wavformat.num_samples = header.num_samples;
-  wav = WAV_Create(&wavformat);
+  wavformat.num_samples = (uint32_t)num_samples;
+  if (MappedFile_Create(decoded_filename, (size_t)output_size, &out_map) != MAPPED_FILE_APIRESULT_OK) {
+    print_error_message("Failed to open output file %s \n", decoded_filename);
+    goto EXIT;
+  }
+  WAV_PutWAVHeaderToMemory(&wavformat, out_map.data, WAV_HEADER_SIZE);
+
+  /* マップした出力ファイルのPCM領域（インターリーブした16bit）に直接デコード */
+  output.format = AAD_SAMPLE_FORMAT_INT16;
+  output.layout = AAD_SAMPLE_LAYOUT_INTERLEAVED;
+  output.channels[0] = &out_map.data[WAV_HEADER_SIZE];
+  output.channels[1] = NULL;
+  output.num_channels = header.num_channels;
+  output.num_samples = num_samples;
+  output.stride = header.num_channels;
+
+  /* 全データをデコード */
+  if ((api_result = AADDecoder_DecodeWholeParallelToBuffer(decoder,
+        in_map.data, in_map.size, &output, num_threads)) != AAD_APIRESULT_OK) {
+    print_error_message("Failed to decode. API result: %d \n", api_result);
+    goto EXIT;
+  }
+
+  /* ビッグエンディアン環境ではファイルのバイト順（リトルエンディアン）に並び替え */
+  if (!is_little_endian()) {
+    uint64_t i;
+    uint8_t *pcm = &out_map.data[WAV_HEADER_SIZE];
+    for (i = 0; i < output_size - WAV_HEADER_SIZE; i += 2) {
+      const uint8_t tmp = pcm[i];
+      pcm[i] = pcm[i + 1];
+      pcm[i + 1] = tmp;
+    }
+  }
+
+  if (MappedFile_Close(&out_map) != MAPPED_FILE_APIRESULT_OK) {
+    print_error_message("Warning: failed to write decoded data \n");
+    goto EXIT;
+  }
 
-  /* PCM書き出し */
-  for (ch = 0; ch < header.num_channels; ch++) {
-    for (smpl = 0; smpl < header.num_samples; smpl++) {
-      WAVFile_PCM(wav, smpl, ch) = (output[ch][smpl] << 16);
+  ret = 0;
+
+EXIT:
+  /* 失敗時は途中までの出力ファイルを残さない */
+  if ((ret != 0) && (out_map.fd >= 0)) {
+    MappedFile_Close(&out_map);
+    remove(decoded_filename);
+  }
+  MappedFile_Close(&out_map);
+  MappedFile_Close(&in_map);
+
+  return ret;
+}
+
+/* デコード処理 */
+static int execute_decode(const char *adpcm_filename, const char *decoded_filename, uint32_t num_threads)
+{
+  int ret;
+  struct AADDecoder *decoder;
+
+  /* デコーダ作成 */
+  decoder = AADDecoder_Create(NULL, 0);
+
+  ret = execute_decode_core(decoder, adpcm_filename, decoded_filename, num_threads);
+
+  AADDecoder_Destroy(decoder);
+
+  return ret;
+}
+
+/* ストリーミングデコード処理 */
+static int execute_decode_stream(const char *adpcm_filename, const char *decoded_filename)
+{
+#define DECODE_STREAM_READ_SIZE   (64 * 1024)
+#define DECODE_STREAM_NUM_SAMPLES 4096
+  FILE                  *fp;
+  struct WAVWriteStream *wavstream = NULL;
+  struct WAVFileFormat  wavformat;
+  struct AADDecoder     *decoder = NULL;
+  struct AADHeaderInfo  header;
+  WAVPcmData            *pcm[AAD_MAX_NUM_CHANNELS] = { NULL, };
+  uint8_t               *data = NULL;
+  uint32_t              ch, smpl, data_size, read_offset, num_consumed_bytes, num_decode_samples;
+  AADApiResult          api_result;
+  int                   ret = 1;
+
+  /* 入力を開く */
+  fp = is_stdio_filename(adpcm_filename) ? stdin : fopen(adpcm_filename, "rb");
+  if (fp == NULL) {
+    fprintf(stderr, "Failed to open %s. \n", adpcm_filename);
+    return 1;
+  }
+
+  /* 入力の区間とデコード結果の領域を確保 */
+  if ((data = malloc(DECODE_STREAM_READ_SIZE)) == NULL) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    goto EXIT;
+  }
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    if ((pcm[ch] = malloc(sizeof(WAVPcmData) * DECODE_STREAM_NUM_SAMPLES)) == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      goto EXIT;
     }
   }
 
-  WAV_WriteToFile(decoded_filename, wav);
+  /* デコーダ作成 ストリーミング開始 */
+  if ((decoder = AADDecoder_Create(NULL, 0)) == NULL) {
+    fprintf(stderr, "Failed to create decoder handle. \n");
+    goto EXIT;
+  }
+  if ((api_result = AADDecoder_BeginDecodeStream(decoder)) != AAD_APIRESULT_OK) {
+    fprintf(stderr, "Failed to decode. API result: %d \n", api_result);
+    goto EXIT;
+  }
 
+  /* 少しずつ読み込んでデコード結果を書き出し */
+  data_size = read_offset = 0;
+  while (1) {
+    /* 入力を使い切ったら次の区間を読み込む（終端では0バイトで呼び、デコーダ内に残った出力を取り出す） */
+    if (read_offset >= data_size) {
+      data_size = (uint32_t)fread(data, sizeof(uint8_t), DECODE_STREAM_READ_SIZE, fp);
+      read_offset = 0;
+    }
+    if ((api_result = AADDecoder_DecodeStream(decoder, &data[read_offset], data_size - read_offset, &num_consumed_bytes,
+            pcm, AAD_MAX_NUM_CHANNELS, DECODE_STREAM_NUM_SAMPLES, &num_decode_samples)) != AAD_APIRESULT_OK) {
+      fprintf(stderr, "Failed to decode. API result: %d \n", api_result);
+      goto EXIT;
+    }
+    read_offset += num_consumed_bytes;
+
+    /* ヘッダが得られたら出力を開く */
+    if ((wavstream == NULL) && (AADDecoder_GetHeader(decoder, &header) == AAD_APIRESULT_OK)) {
+      wavformat.data_format = WAV_DATA_FORMAT_PCM;
+      wavformat.num_channels = header.num_channels;
+      wavformat.sampling_rate = header.sampling_rate;
+      wavformat.bits_per_sample = 16;
+      if (header.num_samples == AAD_NUM_SAMPLES_UNKNOWN) {
+        /* 長さ不明ならwavで表せる最大の長さとしておく（シークできる出力なら終了時に書き換わる） */
+        wavformat.num_samples = (UINT32_MAX - WAV_HEADER_SIZE) / (header.num_channels * (uint32_t)sizeof(int16_t));
+      } else if (WAV_HEADER_SIZE + header.num_samples * header.num_channels * sizeof(int16_t) > UINT32_MAX) {
+        /* wavはサイズを32bitで持つため、それを超える長さは書き出せない */
+        fprintf(stderr, "Too long to write as wav file: %s \n", decoded_filename);
+        goto EXIT;
+      } else {
+        wavformat.num_samples = (uint32_t)header.num_samples;
+      }
+      if ((wavstream = open_wav_write_stream(decoded_filename, &wavformat)) == NULL) {
+        fprintf(stderr, "Failed to open output file %s \n", decoded_filename);
+        goto EXIT;
+      }
+    }
+
+    /* 入力が尽きて出力もなくなったら終了 */
+    if ((num_consumed_bytes == 0) && (num_decode_samples == 0)) {
+      break;
+    }
+
+    /* デコード結果（16bit幅）を上位16bitに値を持つ32bitにして書き出し */
+    if (num_decode_samples > 0) {
+      for (ch = 0; ch < header.num_channels; ch++) {
+        for (smpl = 0; smpl < num_decode_samples; smpl++) {
+          pcm[ch][smpl] = pcm[ch][smpl] << 16;
+        }
+      }
+      if (WAV_WriteFrames(wavstream, pcm, num_decode_samples) != WAV_APIRESULT_OK) {
+        fprintf(stderr, "Warning: failed to write decoded data \n");
+        goto EXIT;
+      }
+    }
+  }
+
+  /* ヘッダを読めないまま入力が終わった */
+  if (ferror(fp) || (wavstream == NULL)) {
+    fprintf(stderr, "Failed to read from %s. \n", adpcm_filename);
+    goto EXIT;
+  }
+
+  ret = 0;
+
+EXIT:
+  /* 出力を閉じる 失敗時は途中までの出力ファイルを残さない */
+  if (wavstream != NULL) {
+    if ((WAV_FinalizeWriteStream(wavstream) != WAV_APIRESULT_OK) && (ret == 0)) {
+      fprintf(stderr, "Warning: failed to write decoded data \n");
+      ret = 1;
+    }
+    if ((ret != 0) && !is_stdio_filename(decoded_filename)) {
+      remove(decoded_filename);
+    }
+  }
+
+  /* 領域開放 */
   AADDecoder_Destroy(decoder);
-  for (ch = 0; ch < header.num_channels; ch++) {
-    free(output[ch]);
+  free(data);
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    free(pcm[ch]);
+  }
+  if (fp != stdin) {
+    fclose(fp);
   }
-  WAV_Destroy(wav);
-  free(buffer);
 
-  return 0;
+  return ret;
+#undef DECODE_STREAM_READ_SIZE
+#undef DECODE_STREAM_NUM_SAMPLES
 }
 
 /* エンコード処理 */
 static int execute_encode(
-    const char *wav_file, const char *encoded_filename, const struct AADEncodeParameter *encode_paramemter)
+    const char *wav_file, const char *encoded_filename, const struct AADEncodeParameter *encode_paramemter,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
 {
-  FILE                      *fp;
-  struct WAVFile            *wavfile;
-  struct stat               fstat;
-  int32_t                   *input[AAD_MAX_NUM_CHANNELS];
-  uint32_t                  ch, smpl, buffer_size, output_size;
-  uint32_t                  num_channels, num_samples;
-  uint8_t                   *buffer;
+  struct MappedFile         in_map, out_map;
+  struct WAVFile            *wavfile = NULL;
+  struct WAVFileFormat      wavformat;
+  struct AADSampleBuffer    input;
+  uint32_t                  ch, data_offset, block_size, num_samples_per_block;
+  uint64_t                  output_size, max_output_size;
   struct AADEncodeParameter enc_param;
-  struct AADEncoder         *encoder;
+  struct AADEncoder         *encoder = NULL;
   AADApiResult              api_result;
+  uint8_t                   output_created = 0;
+  int                       ret = 1;
 
-  /* 入力wav取得 */
-  wavfile = WAV_CreateFromFile(wav_file);
-  if (wavfile == NULL) {
+  in_map.data = out_map.data = NULL;
+  in_map.size = out_map.size = 0;
+  in_map.fd = out_map.fd = -1;
+
+  /* 入力wavのフォーマットとPCMデータの位置を取得 */
+  if (WAV_GetWAVFormatAndDataOffsetFromFile(wav_file, &wavformat, &data_offset) != WAV_APIRESULT_OK) {
     fprintf(stderr, "Failed to open %s. \n", wav_file);
-    return 1;
+    goto EXIT;
   }
-
-  num_channels = wavfile->format.num_channels;
-  num_samples = wavfile->format.num_samples;
-
-  /* 出力データの領域割当て */
-  for (ch = 0; ch < num_channels; ch++) {
-    input[ch] = malloc(sizeof(int32_t) * num_samples);
+  if (wavformat.num_channels > AAD_MAX_NUM_CHANNELS) {
+    fprintf(stderr, "Unsupported number of channels: %d \n", wavformat.num_channels);
+    goto EXIT;
   }
-  /* 入力wavと同じサイズの出力領域を確保（増えることはないと期待） */
-  stat(wav_file, &fstat);
-  buffer_size = (uint32_t)fstat.st_size;
-  buffer = malloc(buffer_size);
 
-  /* 16bit幅でデータ取得 */
-  for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      input[ch][smpl] = (int16_t)(WAVFile_PCM(wavfile, smpl, ch) >> 16);
+  /* 入力ファイルを読み込み専用でマップ */
+  if ((wavformat.bits_per_sample == 16) && is_little_endian() && ((data_offset % 2) == 0)
+      && (MappedFile_OpenRead(wav_file, &in_map) == MAPPED_FILE_APIRESULT_OK)
+      && ((uint64_t)data_offset + (uint64_t)wavformat.num_samples * wavformat.num_channels * sizeof(int16_t) <= in_map.size)) {
+    /* 16bitPCMはマップしたPCM領域（インターリーブした16bit）をそのまま入力にする */
+    input.format = AAD_SAMPLE_FORMAT_INT16;
+    input.layout = AAD_SAMPLE_LAYOUT_INTERLEAVED;
+    input.channels[0] = (in_map.data != NULL) ? &in_map.data[data_offset] : NULL;
+    input.channels[1] = NULL;
+    input.stride = wavformat.num_channels;
+  } else {
+    /* それ以外は読み込んだwavのPCM領域（上位16bitに値を持つ32bit）を入力にする */
+    MappedFile_Close(&in_map);
+    if ((wavfile = WAV_CreateFromFile(wav_file)) == NULL) {
+      fprintf(stderr, "Failed to open %s. \n", wav_file);
+      goto EXIT;
     }
+    input.format = AAD_SAMPLE_FORMAT_INT32_MSB;
+    input.layout = AAD_SAMPLE_LAYOUT_PLANAR;
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      input.channels[ch] = (ch < wavformat.num_channels) ? wavfile->data[ch] : NULL;
+    }
+    input.stride = 1;
   }
+  input.num_channels = wavformat.num_channels;
+  input.num_samples = wavformat.num_samples;
 
   /* ハンドル作成 */
-  encoder = AADEncoder_Create(encode_paramemter->max_block_size, NULL, 0);
+  if ((encoder = AADEncoder_Create(encode_paramemter->max_block_size, NULL, 0)) == NULL) {
+    fprintf(stderr, "Failed to create encoder handle. \n");
+    goto EXIT;
+  }
 
   /* エンコードパラメータをセット */
-  enc_param.num_channels      = (uint16_t)num_channels;
-  enc_param.sampling_rate     = wavfile->format.sampling_rate;
+  enc_param.num_channels      = (uint16_t)wavformat.num_channels;
+  enc_param.sampling_rate     = wavformat.sampling_rate;
   enc_param.bits_per_sample   = encode_paramemter->bits_per_sample;
   enc_param.max_block_size    = encode_paramemter->max_block_size;
   enc_param.ch_process_method = encode_paramemter->ch_process_method;
   enc_param.num_encode_trials = encode_paramemter->num_encode_trials;
+  enc_param.search_method = encode_paramemter->search_method;
   if ((api_result = AADEncoder_SetEncodeParameter(encoder, &enc_param))
       != AAD_APIRESULT_OK) {
     fprintf(stderr, "Failed to set encode parameter. Please check encode parameter. \n");
-    return 1;
+    goto EXIT;
   }
 
-  /* エンコード */
-  if ((api_result = AADEncoder_EncodeWhole(
-        encoder, (const int32_t *const *)input, num_samples,
-        buffer, buffer_size, &output_size)) != AAD_APIRESULT_OK) {
+  /* 出力ファイルを全ブロックが最大サイズになった場合のサイズで作成してマップ */
+  if (AADEncoder_CalculateBlockSize(enc_param.max_block_size,
+        enc_param.num_channels, enc_param.bits_per_sample,
+        &block_size, &num_samples_per_block) != AAD_APIRESULT_OK) {
+    fprintf(stderr, "Failed to set encode parameter. Please check encode parameter. \n");
+    goto EXIT;
+  }
+  max_output_size = AAD_HEADER_SIZE
+    + ((uint64_t)wavformat.num_samples + num_samples_per_block - 1) / num_samples_per_block * block_size;
+  if ((max_output_size > (size_t)-1)
+      || (MappedFile_Create(encoded_filename, (size_t)max_output_size, &out_map) != MAPPED_FILE_APIRESULT_OK)) {
+    fprintf(stderr, "Failed to open output file %s \n", encoded_filename);
+    goto EXIT;
+  }
+  output_created = 1;
+
+  /* マップした出力ファイルに直接エンコード */
+  if ((api_result = AADEncoder_EncodeWholeParallelFromBuffer(encoder, &input,
+        out_map.data, out_map.size, &output_size, num_threads, num_warmup_blocks)) != AAD_APIRESULT_OK) {
     fprintf(stderr, "Failed to encode. API result:%d \n", api_result);
-    return 1;
+    goto EXIT;
+  }
+
+  /* 実際の出力サイズに切り詰めて閉じる */
+  if (MappedFile_CloseWithSize(&out_map, (size_t)output_size) != MAPPED_FILE_APIRESULT_OK) {
+    fprintf(stderr, "Warning: failed to write encoded data \n");
+    goto EXIT;
+  }
+
+  ret = 0;
+
+EXIT:
+  /* 失敗時は最大サイズで作った出力ファイルを残さない */
+  if ((ret != 0) && output_created) {
+    MappedFile_Close(&out_map);
+    remove(encoded_filename);
+  }
+
+  /* 領域開放 */
+  AADEncoder_Destroy(encoder);
+  MappedFile_Close(&in_map);
+  WAV_Destroy(wavfile);
+
+  return ret;
+}
+
+/* ストリーミングエンコード処理（エンコーダを受け取る） */
+/* 補足）失敗時も確保した資源は解放する（バッチ処理で繰り返し呼ぶため） */
+static int execute_encode_stream_core(struct AADEncoder *encoder,
+    const char *wav_file, const char *encoded_filename, const struct AADEncodeParameter *encode_paramemter)
+{
+#define ENCODE_STREAM_NUM_SAMPLES 4096
+  FILE                      *fp = NULL;
+  struct WAVReadStream      *wavstream;
+  struct WAVFileFormat      wavformat;
+  struct AADSampleBuffer    input;
+  WAVPcmData                *pcm[AAD_MAX_NUM_CHANNELS] = { NULL, };
+  uint32_t                  ch, buffer_size, output_size, num_read_samples;
+  uint32_t                  num_channels, block_size, num_samples_per_block;
+  uint8_t                   *buffer = NULL;
+  uint8_t                   header_data[AAD_HEADER_SIZE];
+  struct AADEncodeParameter enc_param;
+  AADApiResult              api_result;
+  uint8_t                   output_created = 0;
+  int                       ret = 1;
+
+  /* 入力wavを開く PCMデータは区間ごとに読み込む */
+  wavstream = open_wav_read_stream(wav_file, &wavformat);
+  if (wavstream == NULL) {
+    print_error_message("Failed to open %s. \n", wav_file);
+    goto EXIT;
+  }
+
+  num_channels = wavformat.num_channels;
+  if (num_channels > AAD_MAX_NUM_CHANNELS) {
+    print_error_message("Unsupported number of channels: %d \n", num_channels);
+    goto EXIT;
+  }
+
+  /* エンコードパラメータをセット */
+  enc_param.num_channels      = (uint16_t)num_channels;
+  enc_param.sampling_rate     = wavformat.sampling_rate;
+  enc_param.bits_per_sample   = encode_paramemter->bits_per_sample;
+  enc_param.max_block_size    = encode_paramemter->max_block_size;
+  enc_param.ch_process_method = encode_paramemter->ch_process_method;
+  enc_param.num_encode_trials = encode_paramemter->num_encode_trials;
+  enc_param.search_method = encode_paramemter->search_method;
+
+  /* 1回の入力で出力されうるブロック数分の出力領域を確保 */
+  if (AADEncoder_CalculateBlockSize(enc_param.max_block_size,
+        enc_param.num_channels, enc_param.bits_per_sample,
+        &block_size, &num_samples_per_block) != AAD_APIRESULT_OK) {
+    print_error_message("Failed to set encode parameter. Please check encode parameter. \n");
+    goto EXIT;
+  }
+  buffer_size = (ENCODE_STREAM_NUM_SAMPLES / num_samples_per_block + 1) * block_size;
+  if (buffer_size < AAD_HEADER_SIZE) {
+    buffer_size = AAD_HEADER_SIZE;
+  }
+  if ((buffer = malloc(buffer_size)) == NULL) {
+    print_error_message("Failed to allocate memory. \n");
+    goto EXIT;
+  }
+
+  /* 入力はwavから読み込んだPCM（上位16bitに値を持つ32bit）の区間 */
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    pcm[ch] = (ch < num_channels) ? malloc(sizeof(WAVPcmData) * ENCODE_STREAM_NUM_SAMPLES) : NULL;
+    if ((ch < num_channels) && (pcm[ch] == NULL)) {
+      print_error_message("Failed to allocate memory. \n");
+      goto EXIT;
+    }
+    input.channels[ch] = pcm[ch];
+  }
+  input.format = AAD_SAMPLE_FORMAT_INT32_MSB;
+  input.layout = AAD_SAMPLE_LAYOUT_PLANAR;
+  input.num_channels = num_channels;
+  input.stride = 1;
+
+  if ((api_result = AADEncoder_SetEncodeParameter(encoder, &enc_param))
+      != AAD_APIRESULT_OK) {
+    print_error_message("Failed to set encode parameter. Please check encode parameter. \n");
+    goto EXIT;
   }
 
-  /* ファイル書き出し */
-  fp = fopen(encoded_filename, "wb");
+  /* ストリーミング開始 */
+  if ((api_result = AADEncoder_BeginEncodeStream(encoder, buffer, buffer_size, &output_size))
+      != AAD_APIRESULT_OK) {
+    print_error_message("Failed to encode. API result:%d \n", api_result);
+    goto EXIT;
+  }
+
+  /* 出力ファイルオープン ヘッダを書き出し */
+  fp = is_stdio_filename(encoded_filename) ? stdout : fopen(encoded_filename, "wb");
   if (fp == NULL) {
-    fprintf(stderr, "Failed to open output file %s \n", encoded_filename);
-    return 1;
+    print_error_message("Failed to open output file %s \n", encoded_filename);
+    goto EXIT;
   }
+  output_created = (fp != stdout) ? 1 : 0;
   if (fwrite(buffer, sizeof(uint8_t), output_size, fp) < output_size) {
-    fprintf(stderr, "Warning: failed to write encoded data \n");
-    return 1;
+    print_error_message("Warning: failed to write encoded data \n");
+    goto EXIT;
+  }
+
+  /* 少しずつ読み込んでエンコード結果を書き出し */
+  while (1) {
+    if (WAV_ReadFrames(wavstream, pcm, ENCODE_STREAM_NUM_SAMPLES, &num_read_samples) != WAV_APIRESULT_OK) {
+      print_error_message("Failed to read %s. \n", wav_file);
+      goto EXIT;
+    }
+    if (num_read_samples == 0) {
+      break;
+    }
+    input.num_samples = num_read_samples;
+    if ((api_result = AADEncoder_EncodeStreamFromBuffer(encoder, &input,
+            buffer, buffer_size, &output_size)) != AAD_APIRESULT_OK) {
+      print_error_message("Failed to encode. API result:%d \n", api_result);
+      goto EXIT;
+    }
+    if (fwrite(buffer, sizeof(uint8_t), output_size, fp) < output_size) {
+      print_error_message("Warning: failed to write encoded data \n");
+      goto EXIT;
+    }
   }
-  fclose(fp);
 
+  /* ストリーミング終了 最終ブロックを書き出し */
+  if ((api_result = AADEncoder_FinishEncodeStream(encoder,
+          buffer, buffer_size, &output_size, header_data, sizeof(header_data))) != AAD_APIRESULT_OK) {
+    print_error_message("Failed to encode. API result:%d \n", api_result);
+    goto EXIT;
+  }
+  if (fwrite(buffer, sizeof(uint8_t), output_size, fp) < output_size) {
+    print_error_message("Warning: failed to write encoded data \n");
+    goto EXIT;
+  }
+
+  /* 総サンプル数が確定したヘッダで先頭を書き換え */
+  /* 補足）パイプ等シークできない出力では総サンプル数が不明のヘッダのままとする */
+  if (fseek(fp, 0, SEEK_SET) == 0) {
+    if (fwrite(header_data, sizeof(uint8_t), AAD_HEADER_SIZE, fp) < AAD_HEADER_SIZE) {
+      print_error_message("Warning: failed to write encoded data \n");
+      goto EXIT;
+    }
+  }
+  if (fclose(fp) != 0) {
+    fp = NULL;
+    print_error_message("Warning: failed to write encoded data \n");
+    goto EXIT;
+  }
+  fp = NULL;
+
+  ret = 0;
+
+EXIT:
   /* 領域開放 */
-  AADEncoder_Destroy(encoder);
+  if ((fp != NULL) && (fp != stdout)) {
+    fclose(fp);
+  }
+  /* 失敗時は途中までの出力ファイルを残さない */
+  if ((ret != 0) && output_created) {
+    remove(encoded_filename);
+  }
   free(buffer);
-  for (ch = 0; ch < num_channels; ch++) {
-    free(input[ch]);
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    free(pcm[ch]);
   }
-  WAV_Destroy(wavfile);
+  WAV_CloseReadStream(wavstream);
 
-  return 0;
+  return ret;
+#undef ENCODE_STREAM_NUM_SAMPLES
+}
+
+/* ストリーミングエンコード処理 */
+static int execute_encode_stream(
+    const char *wav_file, const char *encoded_filename, const struct AADEncodeParameter *encode_paramemter)
+{
+  int ret;
+  struct AADEncoder *encoder;
+
+  /* ハンドル作成 */
+  encoder = AADEncoder_Create(encode_paramemter->max_block_size, NULL, 0);
+
+  ret = execute_encode_stream_core(encoder, wav_file, encoded_filename, encode_paramemter);
+
+  AADEncoder_Destroy(encoder);
+
+  return ret;
 }
 
 /* ヘッダ情報の表示 */
@@ -235,7 +706,7 @@ static int execute_information(const char *adpcm_filename)
   static const char *ch_process_string_table[] = { "None", "MS-Conversion" };
 
   /* ファイルオープン */
-  fp = fopen(adpcm_filename, "rb");
+  fp = is_stdio_filename(adpcm_filename) ? stdin : fopen(adpcm_filename, "rb");
   if (fp == NULL) {
     fprintf(stderr, "Failed to open %s. \n", adpcm_filename);
     return 1;
@@ -244,10 +715,14 @@ static int execute_information(const char *adpcm_filename)
   /* ヘッダだけ読み込み */
   if (fread(buffer, sizeof(uint8_t), AAD_HEADER_SIZE, fp) < AAD_HEADER_SIZE) {
     fprintf(stderr, "Failed to read from %s. \n", adpcm_filename);
-    fclose(fp);
+    if (fp != stdin) {
+      fclose(fp);
+    }
     return 1;
   }
-  fclose(fp);
+  if (fp != stdin) {
+    fclose(fp);
+  }
 
   /* ヘッダデコード */
   if ((ret = AADDecoder_DecodeHeader(buffer, AAD_HEADER_SIZE, &header))
@@ -260,7 +735,11 @@ static int execute_information(const char *adpcm_filename)
   printf("%-30s %-9d   \n", "Format Version:",                header.format_version);
   printf("%-30s %-9d   \n", "Codec Version:",                 header.codec_version);
   printf("%-30s %-9d   \n", "Number of Channels:",            header.num_channels);
-  printf("%-30s %-9d   \n", "Number of Samples per Channel:", header.num_samples);
+  if (header.num_samples == AAD_NUM_SAMPLES_UNKNOWN) {
+    printf("%-30s %-9s   \n", "Number of Samples per Channel:", "Unknown");
+  } else {
+    printf("%-30s %-9lu   \n", "Number of Samples per Channel:", (unsigned long)header.num_samples);
+  }
   printf("%-30s %-9d   \n", "Sampling Rate:",                 header.sampling_rate);
   printf("%-30s %-9d   \n", "Bits per Sample:",               header.bits_per_sample);
   printf("%-30s %-9d   \n", "Block size:",                    header.block_size);
@@ -272,39 +751,49 @@ static int execute_information(const char *adpcm_filename)
 }
 
 /* 再構成コア処理 */
+/* 補足）decodedには上位16bitに値を持つ32bitで出力する。in_wavのPCM領域を指してもよい（エンコード後に上書きする） */
 static int execute_reconstruction_core(
-    const struct WAVFile *in_wav, int32_t **decoded, const struct AADEncodeParameter *encode_paramemter)
+    const struct WAVFile *in_wav, int32_t **decoded, const struct AADEncodeParameter *encode_paramemter,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
 {
-  int32_t                   *pcmdata[AAD_MAX_NUM_CHANNELS];
-  uint32_t                  ch, smpl, buffer_size, output_size;
-  uint32_t                  num_channels, num_samples;
-  uint8_t                   *buffer;
+  int                       ret = 1;
+  uint32_t                  ch, num_channels, num_samples;
+  uint64_t                  buffer_size, output_size;
+  uint8_t                   *buffer = NULL;
+  struct AADSampleBuffer    input, output;
   struct AADEncodeParameter enc_param;
-  struct AADEncoder         *encoder;
-  struct AADDecoder         *decoder;
+  struct AADEncoder         *encoder = NULL;
+  struct AADDecoder         *decoder = NULL;
   AADApiResult              api_result;
 
   num_channels  = in_wav->format.num_channels;
   num_samples   = in_wav->format.num_samples;
 
-  /* 出力データの領域割当て */
-  for (ch = 0; ch < num_channels; ch++) {
-    pcmdata[ch] = malloc(sizeof(int32_t) * num_samples);
-  }
   /* 入力wavPCMと同等の出力領域を確保（増えることはないと期待） */
-  buffer_size = (uint32_t)(sizeof(int32_t) * num_channels * num_samples);
-  buffer = malloc(buffer_size);
+  buffer_size = (uint64_t)sizeof(int32_t) * num_channels * num_samples;
+  if ((buffer = malloc((size_t)buffer_size)) == NULL) {
+    fprintf(stderr, "Failed to allocate memory. \n");
+    goto EXIT;
+  }
 
-  /* 16bit幅でデータ取得 */
-  for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      pcmdata[ch][smpl] = (int32_t)(WAVFile_PCM(in_wav, smpl, ch) >> 16);
-    }
+  /* 入出力はwavのPCM（上位16bitに値を持つ32bit）をそのまま記述 */
+  input.format = output.format = AAD_SAMPLE_FORMAT_INT32_MSB;
+  input.layout = output.layout = AAD_SAMPLE_LAYOUT_PLANAR;
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    input.channels[ch] = (ch < num_channels) ? in_wav->data[ch] : NULL;
+    output.channels[ch] = (ch < num_channels) ? decoded[ch] : NULL;
   }
+  input.num_channels = output.num_channels = num_channels;
+  input.num_samples = output.num_samples = num_samples;
+  input.stride = output.stride = 1;
 
   /* ハンドル作成 */
   encoder = AADEncoder_Create(encode_paramemter->max_block_size, NULL, 0);
   decoder = AADDecoder_Create(NULL, 0);
+  if ((encoder == NULL) || (decoder == NULL)) {
+    fprintf(stderr, "Failed to create encoder/decoder handle. \n");
+    goto EXIT;
+  }
 
   /* エンコードパラメータをセット */
   enc_param.num_channels      = (uint16_t)num_channels;
@@ -313,47 +802,45 @@ static int execute_reconstruction_core(
   enc_param.max_block_size    = encode_paramemter->max_block_size;
   enc_param.ch_process_method = encode_paramemter->ch_process_method;
   enc_param.num_encode_trials = encode_paramemter->num_encode_trials;
+  enc_param.search_method = encode_paramemter->search_method;
   if ((api_result = AADEncoder_SetEncodeParameter(encoder, &enc_param))
       != AAD_APIRESULT_OK) {
     fprintf(stderr, "Failed to set encode parameter. Please check encode parameter. \n");
-    return 1;
+    goto EXIT;
   }
 
   /* エンコード */
-  if ((api_result = AADEncoder_EncodeWhole(
-        encoder, (const int32_t *const *)pcmdata, num_samples,
-        buffer, buffer_size, &output_size)) != AAD_APIRESULT_OK) {
+  if ((api_result = AADEncoder_EncodeWholeParallelFromBuffer(
+        encoder, &input, buffer, buffer_size, &output_size, num_threads, num_warmup_blocks)) != AAD_APIRESULT_OK) {
     fprintf(stderr, "Failed to encode. API result:%d \n", api_result);
-    return 1;
+    goto EXIT;
   }
 
   /* そのままデコード */
-  if ((api_result = AADDecoder_DecodeWhole(decoder, 
-        buffer, output_size, decoded, num_channels, num_samples)) != AAD_APIRESULT_OK) {
+  if ((api_result = AADDecoder_DecodeWholeParallelToBuffer(decoder,
+        buffer, output_size, &output, num_threads)) != AAD_APIRESULT_OK) {
     fprintf(stderr, "Failed to decode. API result: %d \n", api_result);
-    return 1;
+    goto EXIT;
   }
 
+  ret = 0;
+
+EXIT:
   /* 領域開放 */
   AADEncoder_Destroy(encoder);
   AADDecoder_Destroy(decoder);
   free(buffer);
-  for (ch = 0; ch < num_channels; ch++) {
-    free(pcmdata[ch]);
-  }
 
-  return 0;
+  return ret;
 }
 
 /* 再構成処理 */
 static int execute_reconstruction(
-    const char *wav_file, const char *reconstruct_file, const struct AADEncodeParameter *encode_paramemter)
+    const char *wav_file, const char *reconstruct_file, const struct AADEncodeParameter *encode_paramemter,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
 {
   int             ret;
   struct WAVFile  *wavfile;
-  int32_t         *pcmdata[AAD_MAX_NUM_CHANNELS];
-  uint32_t        ch, smpl;
-  uint32_t        num_channels, num_samples;
 
   /* 入力wav取得 */
   wavfile = WAV_CreateFromFile(wav_file);
@@ -362,26 +849,12 @@ static int execute_reconstruction(
     return 1;
   }
 
-  num_channels = wavfile->format.num_channels;
-  num_samples = wavfile->format.num_samples;
-
-  /* 出力データの領域割当て */
-  for (ch = 0; ch < num_channels; ch++) {
-    pcmdata[ch] = malloc(sizeof(int32_t) * num_samples);
-  }
-
-  /* 再構成処理実行 */
-  if ((ret = execute_reconstruction_core(wavfile, pcmdata, encode_paramemter)) != 0) {
+  /* 再構成処理実行 デコード結果は入力wavのPCM領域に直接書き込む */
+  if ((ret = execute_reconstruction_core(wavfile, wavfile->data, encode_paramemter, num_threads, num_warmup_blocks)) != 0) {
+    WAV_Destroy(wavfile);
     return ret;
   }
 
-  /* デコード結果を出力にセット */
-  for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      WAVFile_PCM(wavfile, smpl, ch) = pcmdata[ch][smpl] << 16;
-    }
-  }
-
   /* ファイルに書き出し */
   WAV_WriteToFile(reconstruct_file, wavfile);
 
@@ -393,7 +866,8 @@ static int execute_reconstruction(
 
 /* 残差出力処理 */
 static int execute_gap(
-    const char *wav_file, const char *gap_file, const struct AADEncodeParameter *encode_paramemter)
+    const char *wav_file, const char *gap_file, const struct AADEncodeParameter *encode_paramemter,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
 {
   int             ret;
   struct WAVFile  *wavfile;
@@ -415,35 +889,80 @@ static int execute_gap(
   for (ch = 0; ch < num_channels; ch++) {
     pcmdata[ch] = malloc(sizeof(int32_t) * num_samples);
   }
+  for (ch = 0; ch < num_channels; ch++) {
+    if (pcmdata[ch] == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      ret = 1;
+      goto EXIT;
+    }
+  }
 
   /* 再構成処理実行 */
-  if ((ret = execute_reconstruction_core(wavfile, pcmdata, encode_paramemter)) != 0) {
-    return ret;
+  if ((ret = execute_reconstruction_core(wavfile, pcmdata, encode_paramemter, num_threads, num_warmup_blocks)) != 0) {
+    goto EXIT;
   }
 
   /* 原音から差し引いて残差計算 */
   for (ch = 0; ch < num_channels; ch++) {
     for (smpl = 0; smpl < num_samples; smpl++) {
-      WAVFile_PCM(wavfile, smpl, ch) -= (pcmdata[ch][smpl] << 16);
+      WAVFile_PCM(wavfile, smpl, ch) -= pcmdata[ch][smpl];
     }
   }
 
   /* ファイルに書き出し */
   WAV_WriteToFile(gap_file, wavfile);
 
+EXIT:
   /* ハンドル破棄 */
+  for (ch = 0; ch < num_channels; ch++) {
+    free(pcmdata[ch]);
+  }
   WAV_Destroy(wavfile);
 
-  return 0;
+  return ret;
+}
+
+/* 原音と再構成信号の誤差統計を計算 */
+static void calculate_error_statistics(
+    const struct WAVFile *wavfile, int32_t *const *decoded,
+    double *rms_error, double *abs_error, double *max_error)
+{
+  uint32_t ch, smpl;
+  uint32_t num_channels, num_samples;
+
+  num_channels = wavfile->format.num_channels;
+  num_samples = wavfile->format.num_samples;
+
+  (*rms_error) = 0.0f;
+  (*max_error) = 0.0f;
+  (*abs_error) = 0.0f;
+  for (ch = 0; ch < num_channels; ch++) {
+    for (smpl = 0; smpl < num_samples; smpl++) {
+      double pcm1, pcm2;
+      /* 原音から差し引いた残差で計算（decodedは上位16bitに値を持つ） */
+      pcm1 = (double)(WAVFile_PCM(wavfile, smpl, ch) - decoded[ch][smpl]) / INT32_MAX;
+      pcm2 = ((double)decoded[ch][smpl] / 65536.0) / INT32_MAX;
+      (*rms_error) += pow(pcm1 - pcm2, 2);
+      (*abs_error) += fabs(pcm1 - pcm2);
+      if ((*max_error) < fabs(pcm1 - pcm2)) {
+        (*max_error) = fabs(pcm1 - pcm2);
+      }
+    }
+  }
+
+  (*rms_error) = sqrt((*rms_error) / (num_channels * num_samples));
+  (*abs_error) = (*abs_error) / (num_channels * num_samples);
 }
 
 /* 統計情報出力 */
-static int execute_calculation(const char *wav_file, const struct AADEncodeParameter *encode_paramemter)
+static int execute_calculation(
+    const char *wav_file, const struct AADEncodeParameter *encode_paramemter,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
 {
   int             ret;
   struct WAVFile  *wavfile;
   int32_t         *pcmdata[AAD_MAX_NUM_CHANNELS];
-  uint32_t        ch, smpl;
+  uint32_t        ch;
   uint32_t        num_channels, num_samples;
   double          rms_error, max_error, abs_error;
 
@@ -461,51 +980,519 @@ static int execute_calculation(const char *wav_file, const struct AADEncodeParam
   for (ch = 0; ch < num_channels; ch++) {
     pcmdata[ch] = malloc(sizeof(int32_t) * num_samples);
   }
+  for (ch = 0; ch < num_channels; ch++) {
+    if (pcmdata[ch] == NULL) {
+      fprintf(stderr, "Failed to allocate memory. \n");
+      ret = 1;
+      goto EXIT;
+    }
+  }
 
-  /* 再構成処理実行 */
-  if ((ret = execute_reconstruction_core(wavfile, pcmdata, encode_paramemter)) != 0) {
-    return ret;
+  /* 逐次処理で再構成 */
+  if ((ret = execute_reconstruction_core(wavfile, pcmdata, encode_paramemter, 1, 0)) != 0) {
+    goto EXIT;
   }
 
-  /* 原音から差し引いて残差計算 */
-  for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      WAVFile_PCM(wavfile, smpl, ch) -= (pcmdata[ch][smpl] << 16);
+  /* 統計情報計算 */
+  calculate_error_statistics(wavfile, pcmdata, &rms_error, &abs_error, &max_error);
+  printf("RMSE:%f MSD:%f MaxAE:%f \n", rms_error, abs_error, max_error);
+
+  /* 並列エンコード時は逐次処理との品質差も報告 */
+  if (num_threads > 1) {
+    double serial_rms_error = rms_error;
+
+    if ((ret = execute_reconstruction_core(wavfile, pcmdata, encode_paramemter, num_threads, num_warmup_blocks)) != 0) {
+      goto EXIT;
     }
+
+    calculate_error_statistics(wavfile, pcmdata, &rms_error, &abs_error, &max_error);
+    printf("Parallel(threads:%u warm-up blocks:%u) RMSE:%f MSD:%f MaxAE:%f RMSE difference:%+e \n",
+        num_threads, num_warmup_blocks, rms_error, abs_error, max_error, rms_error - serial_rms_error);
   }
 
-  /* 統計情報計算 */
-  rms_error = 0.0f;
-  max_error = 0.0f;
-  abs_error = 0.0f;
+EXIT:
+  /* ハンドル破棄 */
   for (ch = 0; ch < num_channels; ch++) {
-    for (smpl = 0; smpl < num_samples; smpl++) {
-      double pcm1, pcm2;
-      pcm1 = (double)WAVFile_PCM(wavfile, smpl, ch) / INT32_MAX;
-      pcm2 = (double)pcmdata[ch][smpl] / INT32_MAX;
-      rms_error += pow(pcm1 - pcm2, 2);
-      abs_error += fabs(pcm1 - pcm2);
-      if (max_error < fabs(pcm1 - pcm2)) {
-        max_error = fabs(pcm1 - pcm2);
+    free(pcmdata[ch]);
+  }
+  WAV_Destroy(wavfile);
+
+  return ret;
+}
+
+/* バッチ処理のジョブ */
+struct BatchJob {
+  char      *input_filename;  /* 入力ファイル名                         */
+  char      *output_filename; /* 出力ファイル名                         */
+  uint64_t  input_size;       /* 入力ファイルサイズ                     */
+  uint64_t  output_size;      /* 出力ファイルサイズ                     */
+  double    duration;         /* 音声の長さ[sec]                        */
+  int       result;           /* 処理結果（0で成功）                    */
+  uint8_t   collided;         /* 出力ファイル名が他のジョブと重なるか   */
+};
+
+/* バッチ処理のワーカ */
+struct BatchWorker {
+  struct AADEncoder               *encoder;           /* ワーカ専用のエンコーダ（デコード時はNULL） */
+  struct AADDecoder               *decoder;           /* ワーカ専用のデコーダ（エンコード時はNULL） */
+  const struct AADEncodeParameter *encode_paramemter; /* エンコードパラメータ                       */
+  struct BatchJob                 *jobs;              /* 全ジョブ                                   */
+};
+
+/* 経過時間計測用の時刻[sec]を取得 */
+static double get_wall_clock_time(void)
+{
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+    return 0.0;
+  }
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1.0e-9;
+}
+
+/* ファイルサイズの取得 通常のファイルでなければ失敗 */
+static int get_file_size(const char *filename, uint64_t *size)
+{
+  struct stat stat_buf;
+  if ((stat(filename, &stat_buf) != 0) || !S_ISREG(stat_buf.st_mode)) {
+    return 1;
+  }
+  (*size) = (uint64_t)stat_buf.st_size;
+  return 0;
+}
+
+/* ディレクトリか判定 */
+static int is_directory(const char *path)
+{
+  struct stat stat_buf;
+  return ((stat(path, &stat_buf) == 0) && S_ISDIR(stat_buf.st_mode)) ? 1 : 0;
+}
+
+/* ファイル名が拡張子extで終わるか判定（大文字小文字は区別しない） */
+static int has_extension(const char *filename, const char *ext)
+{
+  size_t i;
+  const size_t filename_length = strlen(filename);
+  const size_t ext_length = strlen(ext);
+
+  if (filename_length <= ext_length) {
+    return 0;
+  }
+  for (i = 0; i < ext_length; i++) {
+    if (tolower((unsigned char)filename[filename_length - ext_length + i]) != tolower((unsigned char)ext[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* ディレクトリとファイル名を連結した文字列を作成 */
+static char *join_path(const char *dir, const char *name, size_t name_length)
+{
+  const size_t dir_length = strlen(dir);
+  char *path = malloc(dir_length + name_length + 2);
+  if (path != NULL) {
+    memcpy(path, dir, dir_length);
+    path[dir_length] = '/';
+    memcpy(&path[dir_length + 1], name, name_length);
+    path[dir_length + 1 + name_length] = '\0';
+  }
+  return path;
+}
+
+/* 入力ファイル名から出力ディレクトリ内の出力ファイル名を作成（拡張子はextに置き換える） */
+static char *make_batch_output_filename(const char *output_dir, const char *input_filename, const char *ext)
+{
+  char *path;
+  size_t name_length;
+  const char *name, *dot;
+
+  /* ディレクトリ部分と拡張子を除いた名前 */
+  name = strrchr(input_filename, '/');
+  name = (name != NULL) ? (name + 1) : input_filename;
+  dot = strrchr(name, '.');
+  name_length = ((dot != NULL) && (dot != name)) ? (size_t)(dot - name) : strlen(name);
+
+  if ((path = join_path(output_dir, name, name_length + strlen(ext))) != NULL) {
+    strcpy(&path[strlen(output_dir) + 1 + name_length], ext);
+  }
+  return path;
+}
+
+/* 比較関数（ファイル名の昇順） */
+static int compare_filename(const void *a, const void *b)
+{
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/* 入力ファイル名の列を取得 */
+/* 補足）inputがディレクトリなら拡張子extを持つファイル、そうでなければ1行に1つのファイル名を並べたリスト（"-"は標準入力）を読む */
+/*       失敗時・1つも見つからない場合は理由を表示してNULLを返す */
+static char **collect_batch_input_filenames(const char *input, const char *ext, uint32_t *num_filenames)
+{
+  char **filenames = NULL, **tmp, *filename;
+  uint32_t i, num = 0, capacity = 0;
+
+  if (is_directory(input)) {
+    DIR *dir;
+    struct dirent *entry;
+    uint64_t size;
+
+    if ((dir = opendir(input)) == NULL) {
+      fprintf(stderr, "Failed to open %s. \n", input);
+      return NULL;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+      if (!has_extension(entry->d_name, ext)) {
+        continue;
+      }
+      if ((filename = join_path(input, entry->d_name, strlen(entry->d_name))) == NULL) {
+        break;
+      }
+      if (get_file_size(filename, &size) != 0) {
+        free(filename);
+        continue;
+      }
+      if (num == capacity) {
+        capacity = (capacity == 0) ? 64 : (2 * capacity);
+        if ((tmp = realloc(filenames, sizeof(char *) * capacity)) == NULL) {
+          free(filename);
+          break;
+        }
+        filenames = tmp;
       }
+      filenames[num++] = filename;
+    }
+    closedir(dir);
+    /* 処理順や出力が実行ごとに変わらないよう名前順に並べる */
+    if (num > 0) {
+      qsort(filenames, num, sizeof(char *), compare_filename);
+    }
+  } else {
+    FILE *fp;
+    char line[FILENAME_MAX + 2];
+    size_t length, pos;
+    uint32_t line_no = 0;
+    int is_valid;
+
+    /* 入力ファイルそのものはリストとして読まない（中身をファイル名として扱ってしまう） */
+    if (has_extension(input, ext)) {
+      fprintf(stderr, "%s is neither a directory nor a list file of input files. \n", input);
+      return NULL;
+    }
+
+    fp = is_stdio_filename(input) ? stdin : fopen(input, "r");
+    if (fp == NULL) {
+      fprintf(stderr, "Failed to open %s. \n", input);
+      return NULL;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+      line_no++;
+
+      /* 改行で終わらない（長すぎる・NULを含む）行や、制御文字を含む行があればリストではない */
+      length = strcspn(line, "\r\n");
+      is_valid = ((line[length] != '\0') || feof(fp)) ? 1 : 0;
+      for (pos = 0; (pos < length) && is_valid; pos++) {
+        if (((unsigned char)line[pos] < 0x20) || ((unsigned char)line[pos] == 0x7F)) {
+          is_valid = 0;
+        }
+      }
+      if (!is_valid) {
+        fprintf(stderr, "Invalid file name at line %u of %s. \n", line_no, input);
+        for (i = 0; i < num; i++) {
+          free(filenames[i]);
+        }
+        free(filenames);
+        if (fp != stdin) {
+          fclose(fp);
+        }
+        return NULL;
+      }
+
+      /* 改行を除き、空行は読み飛ばす */
+      line[length] = '\0';
+      if (line[0] == '\0') {
+        continue;
+      }
+      if ((filename = malloc(strlen(line) + 1)) == NULL) {
+        break;
+      }
+      strcpy(filename, line);
+      if (num == capacity) {
+        capacity = (capacity == 0) ? 64 : (2 * capacity);
+        if ((tmp = realloc(filenames, sizeof(char *) * capacity)) == NULL) {
+          free(filename);
+          break;
+        }
+        filenames = tmp;
+      }
+      filenames[num++] = filename;
+    }
+    if (fp != stdin) {
+      fclose(fp);
     }
   }
 
-  printf("RMSE:%f MSD:%f MaxAE:%f \n", 
-      sqrt(rms_error / (num_channels * num_samples)), 
-      abs_error / (num_channels * num_samples),
-      max_error);
+  if (num == 0) {
+    fprintf(stderr, "No input files found in %s. \n", input);
+    free(filenames);
+    return NULL;
+  }
 
-  /* ハンドル破棄 */
-  WAV_Destroy(wavfile);
+  (*num_filenames) = num;
+  return filenames;
+}
+
+/* .aadファイルの音声の長さ[sec]を取得 */
+static int get_aad_duration(const char *adpcm_filename, double *duration)
+{
+  FILE *fp;
+  uint8_t buffer[AAD_HEADER_SIZE];
+  struct AADHeaderInfo header;
+  uint64_t file_size, num_samples;
+  size_t read_size;
+
+  if ((fp = fopen(adpcm_filename, "rb")) == NULL) {
+    return 1;
+  }
+  read_size = fread(buffer, sizeof(uint8_t), AAD_HEADER_SIZE, fp);
+  fclose(fp);
+
+  /* 総サンプル数が不明なヘッダでも、ファイルサイズから求まる */
+  if ((AADDecoder_DecodeHeader(buffer, read_size, &header) != AAD_APIRESULT_OK)
+      || (get_file_size(adpcm_filename, &file_size) != 0)
+      || (AADDecoder_CalculateNumSamples(&header, file_size, &num_samples) != AAD_APIRESULT_OK)) {
+    return 1;
+  }
 
+  (*duration) = (double)num_samples / header.sampling_rate;
   return 0;
 }
 
+/* 比較関数（出力ファイル名の昇順） */
+static int compare_batch_job_output(const void *a, const void *b)
+{
+  return strcmp((*(struct BatchJob *const *)a)->output_filename, (*(struct BatchJob *const *)b)->output_filename);
+}
+
+/* 出力ファイル名が重なるジョブに印を付け、その数を返す */
+/* 補足）重なったジョブは同じファイルへ同時に書き込みうるため、全て処理しない */
+static uint32_t mark_batch_output_collisions(struct BatchJob *jobs, uint32_t num_jobs)
+{
+  uint32_t i, num_collided = 0;
+  struct BatchJob **sorted;
+
+  if ((sorted = (struct BatchJob **)malloc(sizeof(struct BatchJob *) * num_jobs)) == NULL) {
+    return num_jobs;
+  }
+  for (i = 0; i < num_jobs; i++) {
+    sorted[i] = &jobs[i];
+  }
+  qsort(sorted, num_jobs, sizeof(struct BatchJob *), compare_batch_job_output);
+
+  /* 名前順に並べて隣同士を比べる */
+  for (i = 1; i < num_jobs; i++) {
+    if (strcmp(sorted[i - 1]->output_filename, sorted[i]->output_filename) == 0) {
+      sorted[i - 1]->collided = sorted[i]->collided = 1;
+    }
+  }
+  for (i = 0; i < num_jobs; i++) {
+    if (jobs[i].collided) {
+      fprintf(stderr, "Output file %s of %s collides with another input. \n", jobs[i].output_filename, jobs[i].input_filename);
+      num_collided++;
+    }
+  }
+
+  free(sorted);
+  return num_collided;
+}
+
+/* バッチ処理の1ジョブ（1ファイル）を処理 */
+static void batch_process_job(void *worker_arg, uint32_t job_index)
+{
+  struct BatchWorker *worker = (struct BatchWorker *)worker_arg;
+  struct BatchJob *job = &worker->jobs[job_index];
+  const char *adpcm_filename;
+
+  /* 出力ファイル名が重なるジョブは失敗扱い */
+  if (job->collided) {
+    return;
+  }
+
+  /* このスレッドのエラーメッセージには入力ファイル名を付ける */
+  pthread_setspecific(error_message_prefix_key, job->input_filename);
+
+  /* ワーカのハンドルを使い回す 各ファイルは1スレッドで処理 */
+  if (worker->encoder != NULL) {
+    job->result = execute_encode_stream_core(worker->encoder,
+        job->input_filename, job->output_filename, worker->encode_paramemter);
+    adpcm_filename = job->output_filename;
+  } else {
+    job->result = execute_decode_core(worker->decoder,
+        job->input_filename, job->output_filename, 1);
+    adpcm_filename = job->input_filename;
+  }
+
+  /* 統計情報の取得 */
+  if (job->result == 0) {
+    if ((get_file_size(job->output_filename, &job->output_size) != 0)
+        || (get_aad_duration(adpcm_filename, &job->duration) != 0)) {
+      job->output_size = 0;
+      job->duration = 0.0;
+    }
+  }
+}
+
+/* バッチ処理 入力ディレクトリ（またはファイルリスト）内の全ファイルを並列にエンコード/デコード */
+static int execute_batch(
+    const char *input, const char *output_dir, uint8_t is_encode,
+    const struct AADEncodeParameter *encode_paramemter, uint32_t num_threads)
+{
+  uint32_t i, num_jobs, num_workers, num_failed;
+  uint64_t *job_costs = NULL;
+  uint64_t total_input_size, total_output_size;
+  double total_duration, start_time, elapsed_time;
+  char **input_filenames;
+  struct BatchJob *jobs = NULL;
+  struct BatchWorker *workers = NULL;
+  void **worker_args = NULL;
+  WorkStealingPoolApiResult run_result;
+  int ret = 1;
+
+  /* 出力先の確認 */
+  if (!is_directory(output_dir)) {
+    fprintf(stderr, "Output directory %s does not exist. \n", output_dir);
+    return 1;
+  }
+
+  /* 入力ファイル一覧の取得 */
+  if ((input_filenames = collect_batch_input_filenames(input, is_encode ? ".wav" : ".aad", &num_jobs)) == NULL) {
+    return 1;
+  }
+
+  /* ジョブとワーカの領域確保 */
+  num_workers = (num_threads < num_jobs) ? num_threads : num_jobs;
+  jobs = (struct BatchJob *)calloc(num_jobs, sizeof(struct BatchJob));
+  job_costs = (uint64_t *)malloc(sizeof(uint64_t) * num_jobs);
+  workers = (struct BatchWorker *)calloc(num_workers, sizeof(struct BatchWorker));
+  worker_args = (void **)malloc(sizeof(void *) * num_workers);
+  if ((jobs == NULL) || (job_costs == NULL) || (workers == NULL) || (worker_args == NULL)) {
+    fprintf(stderr, "Failed to allocate memory for batch processing. \n");
+    goto EXIT;
+  }
+
+  /* ジョブ作成 入力ファイルサイズを処理コストとする */
+  for (i = 0; i < num_jobs; i++) {
+    struct BatchJob *job = &jobs[i];
+    job->input_filename = input_filenames[i];
+    job->output_filename = make_batch_output_filename(output_dir, job->input_filename, is_encode ? ".aad" : ".wav");
+    if (job->output_filename == NULL) {
+      fprintf(stderr, "Failed to allocate memory for batch processing. \n");
+      goto EXIT;
+    }
+    if (get_file_size(job->input_filename, &job->input_size) != 0) {
+      job->input_size = 0;
+    }
+    job_costs[i] = job->input_size;
+    job->result = 1;
+  }
+
+  /* 出力ファイル名の重なりを検出（異なるディレクトリにある同名のファイル等） */
+  if (mark_batch_output_collisions(jobs, num_jobs) == num_jobs) {
+    fprintf(stderr, "No jobs to process. \n");
+    goto EXIT;
+  }
+
+  /* ワーカ作成 ハンドル（ワーク領域）はワーカごとに1つ作り、全ジョブで使い回す */
+  for (i = 0; i < num_workers; i++) {
+    struct BatchWorker *worker = &workers[i];
+    if (is_encode) {
+      worker->encoder = AADEncoder_Create(encode_paramemter->max_block_size, NULL, 0);
+    } else {
+      worker->decoder = AADDecoder_Create(NULL, 0);
+    }
+    if ((worker->encoder == NULL) && (worker->decoder == NULL)) {
+      fprintf(stderr, "Failed to create %s. \n", is_encode ? "encoder" : "decoder");
+      goto EXIT;
+    }
+    worker->encode_paramemter = encode_paramemter;
+    worker->jobs = jobs;
+    worker_args[i] = worker;
+  }
+
+  /* 全ジョブを処理 */
+  if (pthread_key_create(&error_message_prefix_key, NULL) != 0) {
+    fprintf(stderr, "Failed to run batch processing. \n");
+    goto EXIT;
+  }
+  error_message_prefix_enabled = 1;
+  start_time = get_wall_clock_time();
+  run_result = WorkStealingPool_Run(num_workers, job_costs, num_jobs, batch_process_job, worker_args);
+  error_message_prefix_enabled = 0;
+  pthread_key_delete(error_message_prefix_key);
+  if (run_result != WORK_STEALING_POOL_APIRESULT_OK) {
+    fprintf(stderr, "Failed to run batch processing. \n");
+    goto EXIT;
+  }
+  elapsed_time = get_wall_clock_time() - start_time;
+
+  /* 結果集計 */
+  num_failed = 0;
+  total_input_size = total_output_size = 0;
+  total_duration = 0.0;
+  for (i = 0; i < num_jobs; i++) {
+    const struct BatchJob *job = &jobs[i];
+    if (job->result != 0) {
+      fprintf(stderr, "Failed to process %s. \n", job->input_filename);
+      num_failed++;
+      continue;
+    }
+    total_input_size += job->input_size;
+    total_output_size += job->output_size;
+    total_duration += job->duration;
+  }
+
+  /* 全体のスループットを表示 */
+  printf("Processed files: %u (failed: %u) \n", num_jobs - num_failed, num_failed);
+  printf("Elapsed time:    %.3f [sec] (%u threads) \n", elapsed_time, num_workers);
+  if (elapsed_time > 0.0) {
+    printf("Throughput:      %.2f [files/sec], input %.2f [MiB/sec], output %.2f [MiB/sec], %.1fx realtime \n",
+        (num_jobs - num_failed) / elapsed_time,
+        (double)total_input_size / (1024.0 * 1024.0) / elapsed_time,
+        (double)total_output_size / (1024.0 * 1024.0) / elapsed_time,
+        total_duration / elapsed_time);
+  }
+
+  ret = (num_failed == 0) ? 0 : 1;
+
+EXIT:
+  /* 領域開放 */
+  if (workers != NULL) {
+    for (i = 0; i < num_workers; i++) {
+      AADEncoder_Destroy(workers[i].encoder);
+      AADDecoder_Destroy(workers[i].decoder);
+    }
+  }
+  for (i = 0; i < num_jobs; i++) {
+    free(input_filenames[i]);
+    if (jobs != NULL) {
+      free(jobs[i].output_filename);
+    }
+  }
+  free(input_filenames);
+  free(jobs);
+  free(job_costs);
+  free(workers);
+  free(worker_args);
+
+  return ret;
+}
+
 /* 使用法の表示 */
 static void print_usage(const char* program_name)
 {
   printf("Usage: %s [options] INPUT_FILE_NAME OUTPUT_FILE_NAME \n", program_name);
+  printf("       (use - as INPUT_FILE_NAME/OUTPUT_FILE_NAME for standard input/output in encode/decode/information modes) \n");
+  printf("       %s -e|-d -B [options] INPUT_DIRECTORY_OR_LIST_FILE OUTPUT_DIRECTORY \n", program_name);
 }
 
 /* バージョン情報の表示 */
@@ -517,7 +1504,7 @@ static void print_version_info(void)
 /* メインエントリ */
 int main(int argc, char **argv)
 {
-  uint32_t num_modes_specified;
+  uint32_t num_modes_specified, num_threads, num_warmup_blocks;
   const char *filename_ptr[2] = { NULL, NULL };
   const char *in_filename, *out_filename;
   struct AADEncodeParameter encode_paramemter = { 0, };
@@ -582,13 +1569,33 @@ int main(int argc, char **argv)
     encode_paramemter.bits_per_sample
       = (uint8_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "bits-per-sample"), NULL, 10);
     encode_paramemter.max_block_size
-      = (uint16_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "max-block-size"), NULL, 10);
+      = (uint32_t)strtoul(CommandLineParser_GetArgumentString(command_line_spec, "max-block-size"), NULL, 10);
     encode_paramemter.num_encode_trials
       = (uint8_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "num-encode-trials"), NULL, 10);
     encode_paramemter.ch_process_method = AAD_CH_PROCESS_METHOD_NONE;
     if (CommandLineParser_GetOptionAcquired(command_line_spec, "ms-conversion") == COMMAND_LINE_PARSER_TRUE) {
       encode_paramemter.ch_process_method = AAD_CH_PROCESS_METHOD_MS;
     }
+    encode_paramemter.search_method = AAD_SEARCH_METHOD_SEQUENTIAL;
+    if (CommandLineParser_GetOptionAcquired(command_line_spec, "independent-search") == COMMAND_LINE_PARSER_TRUE) {
+      encode_paramemter.search_method = AAD_SEARCH_METHOD_INDEPENDENT;
+    }
+  }
+
+  /* スレッド数の取得 */
+  num_threads = (uint32_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "num-threads"), NULL, 10);
+  if (num_threads == 0) {
+    fprintf(stderr, "%s: number of threads must be positive. \n", argv[0]);
+    return 1;
+  }
+  num_warmup_blocks = (uint32_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "num-warmup-blocks"), NULL, 10);
+
+  /* バッチ処理はエンコード・デコードのみ */
+  if ((CommandLineParser_GetOptionAcquired(command_line_spec, "batch") == COMMAND_LINE_PARSER_TRUE)
+      && (CommandLineParser_GetOptionAcquired(command_line_spec, "encode") != COMMAND_LINE_PARSER_TRUE)
+      && (CommandLineParser_GetOptionAcquired(command_line_spec, "decode") != COMMAND_LINE_PARSER_TRUE)) {
+    fprintf(stderr, "%s: batch mode is available only in encode/decode mode. \n", argv[0]);
+    return 1;
   }
 
   /* 入力だけが必要な処理 */
@@ -597,7 +1604,7 @@ int main(int argc, char **argv)
     return execute_information(in_filename);
   } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "calculate") == COMMAND_LINE_PARSER_TRUE) {
     /* 統計情報出力 */
-    return execute_calculation(in_filename, &encode_paramemter);
+    return execute_calculation(in_filename, &encode_paramemter, num_threads, num_warmup_blocks);
   } 
   
   /* 出力ファイル名の取得 */
@@ -606,19 +1613,33 @@ int main(int argc, char **argv)
     return 1;
   }
 
+  /* バッチ処理 ファイル単位で並列に処理 */
+  if (CommandLineParser_GetOptionAcquired(command_line_spec, "batch") == COMMAND_LINE_PARSER_TRUE) {
+    return execute_batch(in_filename, out_filename,
+        (CommandLineParser_GetOptionAcquired(command_line_spec, "encode") == COMMAND_LINE_PARSER_TRUE) ? 1 : 0,
+        &encode_paramemter, num_threads);
+  }
+
   /* 入出力が必要な処理 */
   if (CommandLineParser_GetOptionAcquired(command_line_spec, "decode") == COMMAND_LINE_PARSER_TRUE) {
-    /* デコード */
-    return execute_decode(in_filename, out_filename);
+    /* デコード 標準入出力はマップできないのでストリーミングで処理 */
+    if (is_stdio_filename(in_filename) || is_stdio_filename(out_filename)) {
+      return execute_decode_stream(in_filename, out_filename);
+    }
+    return execute_decode(in_filename, out_filename, num_threads);
   } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "encode") == COMMAND_LINE_PARSER_TRUE) {
-    /* エンコード */
-    return execute_encode(in_filename, out_filename, &encode_paramemter);
+    /* エンコード 標準入出力はマップできないのでストリーミングで処理 */
+    /* 補足）ファイル間では逐次処理でもマップした入出力に直接エンコードする */
+    if (is_stdio_filename(in_filename) || is_stdio_filename(out_filename)) {
+      return execute_encode_stream(in_filename, out_filename, &encode_paramemter);
+    }
+    return execute_encode(in_filename, out_filename, &encode_paramemter, num_threads, num_warmup_blocks);
   } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "reconstruct") == COMMAND_LINE_PARSER_TRUE) {
     /* 再構成 */
-    return execute_reconstruction(in_filename, out_filename, &encode_paramemter);
+    return execute_reconstruction(in_filename, out_filename, &encode_paramemter, num_threads, num_warmup_blocks);
   } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "gap") == COMMAND_LINE_PARSER_TRUE) {
     /* 残差生成 */
-    return execute_gap(in_filename, out_filename, &encode_paramemter);
+    return execute_gap(in_filename, out_filename, &encode_paramemter, num_threads, num_warmup_blocks);
   }
 
   return 1;
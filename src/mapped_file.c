@@ -0,0 +1,145 @@
+/* mmap, ftruncate等のPOSIXの宣言を有効にする */
+#define _POSIX_C_SOURCE 200112L
+
+#include "mapped_file.h"
+
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* ファイルを読み込み専用でマップ */
+MappedFileApiResult MappedFile_OpenRead(const char *filename, struct MappedFile *map)
+{
+  struct stat fstat_buf;
+  void *ptr;
+
+  /* 引数チェック */
+  if ((filename == NULL) || (map == NULL)) {
+    return MAPPED_FILE_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  map->data = NULL;
+  map->size = 0;
+  if ((map->fd = open(filename, O_RDONLY)) < 0) {
+    return MAPPED_FILE_APIRESULT_IOERROR;
+  }
+
+  /* 通常のファイルのみマップできる */
+  if ((fstat(map->fd, &fstat_buf) != 0) || !S_ISREG(fstat_buf.st_mode)
+      || ((uint64_t)fstat_buf.st_size > (uint64_t)((size_t)-1))) {
+    close(map->fd);
+    map->fd = -1;
+    return MAPPED_FILE_APIRESULT_MAP_FAILED;
+  }
+
+  /* サイズ0はマップできないので空のまま返す */
+  map->size = (size_t)fstat_buf.st_size;
+  if (map->size == 0) {
+    return MAPPED_FILE_APIRESULT_OK;
+  }
+
+  if ((ptr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, map->fd, 0)) == MAP_FAILED) {
+    close(map->fd);
+    map->fd = -1;
+    map->size = 0;
+    return MAPPED_FILE_APIRESULT_MAP_FAILED;
+  }
+  map->data = (uint8_t *)ptr;
+
+  /* 先読みを促す（失敗しても動作には影響しない） */
+  (void)posix_madvise(ptr, map->size, POSIX_MADV_SEQUENTIAL);
+
+  return MAPPED_FILE_APIRESULT_OK;
+}
+
+/* sizeバイトのファイルを新規作成して書き込み可能でマップ */
+MappedFileApiResult MappedFile_Create(const char *filename, size_t size, struct MappedFile *map)
+{
+  void *ptr;
+
+  /* 引数チェック */
+  if ((filename == NULL) || (map == NULL) || (size == 0)) {
+    return MAPPED_FILE_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  map->data = NULL;
+  map->size = 0;
+  if ((map->fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0) {
+    return MAPPED_FILE_APIRESULT_IOERROR;
+  }
+
+  /* 先にファイルサイズを確保してからマップ */
+  if (ftruncate(map->fd, (off_t)size) != 0) {
+    close(map->fd);
+    map->fd = -1;
+    return MAPPED_FILE_APIRESULT_IOERROR;
+  }
+  if ((ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0)) == MAP_FAILED) {
+    close(map->fd);
+    map->fd = -1;
+    return MAPPED_FILE_APIRESULT_MAP_FAILED;
+  }
+  map->data = (uint8_t *)ptr;
+  map->size = size;
+
+  return MAPPED_FILE_APIRESULT_OK;
+}
+
+/* マップを解除してファイルを閉じる */
+MappedFileApiResult MappedFile_Close(struct MappedFile *map)
+{
+  MappedFileApiResult ret = MAPPED_FILE_APIRESULT_OK;
+
+  /* 引数チェック */
+  if (map == NULL) {
+    return MAPPED_FILE_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  if (map->data != NULL) {
+    if (munmap(map->data, map->size) != 0) {
+      ret = MAPPED_FILE_APIRESULT_IOERROR;
+    }
+    map->data = NULL;
+  }
+  if (map->fd >= 0) {
+    if (close(map->fd) != 0) {
+      ret = MAPPED_FILE_APIRESULT_IOERROR;
+    }
+    map->fd = -1;
+  }
+  map->size = 0;
+
+  return ret;
+}
+
+/* マップを解除し、ファイルをsizeバイトに切り詰めて閉じる */
+MappedFileApiResult MappedFile_CloseWithSize(struct MappedFile *map, size_t size)
+{
+  MappedFileApiResult ret = MAPPED_FILE_APIRESULT_OK;
+
+  /* 引数チェック */
+  if ((map == NULL) || (size > map->size)) {
+    return MAPPED_FILE_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  /* マップ解除後に切り詰める（マップ中の領域を切り詰めるとアクセス時に例外となるため） */
+  if (map->data != NULL) {
+    if (munmap(map->data, map->size) != 0) {
+      ret = MAPPED_FILE_APIRESULT_IOERROR;
+    }
+    map->data = NULL;
+  }
+  if (map->fd >= 0) {
+    if (ftruncate(map->fd, (off_t)size) != 0) {
+      ret = MAPPED_FILE_APIRESULT_IOERROR;
+    }
+  }
+
+  if (MappedFile_Close(map) != MAPPED_FILE_APIRESULT_OK) {
+    ret = MAPPED_FILE_APIRESULT_IOERROR;
+  }
+
+  return ret;
+}
@@ -0,0 +1,44 @@
+#ifndef MAPPED_FILE_H_INCLUDED
+#define MAPPED_FILE_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* API結果型 */
+typedef enum MappedFileApiResultTag {
+  MAPPED_FILE_APIRESULT_OK = 0,             /* 成功 */
+  MAPPED_FILE_APIRESULT_INVALID_ARGUMENT,   /* 無効な引数 */
+  MAPPED_FILE_APIRESULT_IOERROR,            /* ファイル入出力エラー */
+  MAPPED_FILE_APIRESULT_MAP_FAILED          /* マップに失敗（通常のファイルでない等） */
+} MappedFileApiResult;
+
+/* メモリマップしたファイル */
+struct MappedFile {
+  uint8_t *data;    /* マップした領域の先頭 */
+  size_t  size;     /* マップした領域のサイズ */
+  int     fd;       /* ファイルディスクリプタ */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ファイルを読み込み専用でマップ */
+/* 補足）先頭から順に読むことをOSに伝える。サイズ0のファイルはdataがNULLになる */
+MappedFileApiResult MappedFile_OpenRead(const char *filename, struct MappedFile *map);
+
+/* sizeバイトのファイルを新規作成して書き込み可能でマップ */
+/* 補足）書き込み後はMappedFile_CloseWithSizeで実際に使ったサイズに切り詰める */
+MappedFileApiResult MappedFile_Create(const char *filename, size_t size, struct MappedFile *map);
+
+/* マップを解除してファイルを閉じる */
+MappedFileApiResult MappedFile_Close(struct MappedFile *map);
+
+/* マップを解除し、ファイルをsizeバイトに切り詰めて閉じる */
+MappedFileApiResult MappedFile_CloseWithSize(struct MappedFile *map, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAPPED_FILE_H_INCLUDED */
@@ -5,8 +5,18 @@
 #include <string.h>
 #include <assert.h>
 
+/* SIMDによるPCM変換の利用可否（WAV_DISABLE_SIMD/AAD_DISABLE_SIMDで無効化） */
+#if !defined(WAV_DISABLE_SIMD) && !defined(AAD_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WAV_USE_SSSE3 1
+#include <immintrin.h>
+#else
+#define WAV_USE_SSSE3 0
+#endif
+
 /* パーサの読み込みバッファサイズ */
 #define WAVBITBUFFER_BUFFER_SIZE         (10 * 1024)
+/* PCMデータを一括で読み込む際の作業領域サイズ */
+#define WAV_PCM_STAGING_BUFFER_SIZE      (256 * 1024)
 
 /* 下位n_bitsを取得 */
 /* 補足）((1 << n_bits) - 1)は下位の数値だけ取り出すマスクになる */
@@ -26,6 +36,7 @@ struct WAVBitBuffer {
   uint8_t   bytes[WAVBITBUFFER_BUFFER_SIZE];   /* ビットバッファ */
   uint32_t  bit_count;                        /* ビット入力カウント */
   int32_t   byte_pos;                         /* バイト列読み込み位置 */
+  int32_t   num_bytes;                        /* バッファに読み込んだバイト数（パーサのみ使用） */
 };
 
 /* パーサ */
@@ -42,6 +53,27 @@ struct WAVWriter {
   struct WAVBitBuffer buffer;   /* ビットバッファ */
 };
 
+/* ストリーミング読み込みハンドル */
+struct WAVReadStream {
+  FILE*                 fp;                   /* 読み込みファイルポインタ */
+  struct WAVParser      parser;               /* パーサ */
+  struct WAVFileFormat  format;               /* フォーマット */
+  uint32_t              num_remain_samples;   /* 未読のサンプル数 */
+  uint8_t*              staging;              /* PCMデータの作業領域 */
+  uint32_t              num_staging_samples;  /* 作業領域に収まるサンプル数 */
+};
+
+/* ストリーミング書き込みハンドル */
+struct WAVWriteStream {
+  FILE*                 fp;                   /* 書き込みファイルポインタ */
+  uint8_t               seekable;             /* ファイルポインタがシーク可能か */
+  struct WAVWriter      writer;               /* ライタ */
+  struct WAVFileFormat  format;               /* フォーマット（サンプル数はヘッダに書いた値） */
+  uint32_t              num_written_samples;  /* 書き出したサンプル数 */
+  uint8_t*              staging;              /* PCMデータの作業領域 */
+  uint32_t              num_staging_samples;  /* 作業領域に収まるサンプル数 */
+};
+
 /* パーサの初期化 */
 static void WAVParser_Initialize(struct WAVParser* parser, FILE* fp);
 /* パーサの使用終了 */
@@ -50,6 +82,14 @@ static void WAVParser_Finalize(struct WAVParser* parser);
 static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uint64_t* bitsbuf);
 /* シーク（fseek準拠） */
 static WAVError WAVParser_Seek(struct WAVParser* parser, int32_t offset, int32_t wherefrom);
+/* バイト境界にいるか判定 */
+static uint8_t WAVParser_IsByteAligned(const struct WAVParser* parser);
+/* 次に読むバイトのファイル先頭からの位置を取得（ftell準拠） */
+/* 補足）バイト境界にいること */
+static int32_t WAVParser_Tell(const struct WAVParser* parser);
+/* バイト列を一括で取得 取得できたバイト数を返す */
+/* 補足）バイト境界にいること。ビットバッファの残りを使い切った後はファイルから直接読み込む */
+static uint32_t WAVParser_GetBytes(struct WAVParser* parser, uint8_t* bytes, uint32_t nbytes);
 /* ライタの初期化 */
 static void WAVWriter_Initialize(struct WAVWriter* writer, FILE* fp);
 /* ライタの終了 */
@@ -58,6 +98,9 @@ static void WAVWriter_Finalize(struct WAVWriter* writer);
 static WAVError WAVWriter_PutBits(struct WAVWriter* writer, uint64_t val, uint32_t n_bits);
 /* バッファにたまったビットをクリア */
 static WAVError WAVWriter_Flush(struct WAVWriter* writer);
+/* バイト列を一括で書き込む */
+/* 補足）バイト境界にいること。バッファにたまった分を書き出してからファイルに直接書き込む */
+static WAVError WAVWriter_PutBytes(struct WAVWriter* writer, const uint8_t* bytes, uint32_t nbytes);
 /* リトルエンディアンでビットパターンを出力 */
 static WAVError WAVWriter_PutLittleEndianBytes(
     struct WAVWriter* writer, uint32_t nbytes, uint64_t data);
@@ -68,6 +111,14 @@ static WAVError WAVWriter_PutWAVHeader(
 /* ライタを使用してPCMデータ出力 */
 static WAVError WAVWriter_PutWAVPcmData(
     struct WAVWriter* writer, const struct WAVFile* wavfile);
+/* ライタを使用してPCMデータを1サンプルずつビット単位で出力 */
+static WAVError WAVWriter_PutWAVPcmDataByBits(
+    struct WAVWriter* writer, const struct WAVFile* wavfile);
+/* ライタを使用してdata[ch][offset]からnum_samplesサンプル分のPCMデータを作業領域経由で出力 */
+static WAVError WAVWriter_PutPcmFrames(
+    struct WAVWriter* writer, const struct WAVFileFormat* format,
+    uint8_t* staging, uint32_t num_staging_samples,
+    WAVPcmData* const* data, uint32_t offset, uint32_t num_samples);
 
 /* リトルエンディアンでビットパターンを取得 */
 static WAVError WAVParser_GetLittleEndianBytes(
@@ -84,6 +135,58 @@ static WAVError WAVParser_GetWAVFormat(
 /* パーサを使用してPCMデータを読み取り */
 static WAVError WAVParser_GetWAVPcmData(
     struct WAVParser* parser, struct WAVFile* wavfile);
+/* パーサを使用してPCMデータを1サンプルずつビット単位で読み取り */
+static WAVError WAVParser_GetWAVPcmDataByBits(
+    struct WAVParser* parser, struct WAVFile* wavfile);
+/* パーサを使用してnum_samplesサンプル分のPCMデータを作業領域経由で読み取りdata[ch][offset]から格納 */
+/* 補足）読み取れたサンプル数を返す。ファイル終端で途中までのサンプルは捨てる */
+static uint32_t WAVParser_GetPcmFrames(
+    struct WAVParser* parser, const struct WAVFileFormat* format,
+    uint8_t* staging, uint32_t num_staging_samples,
+    WAVPcmData** data, uint32_t offset, uint32_t num_samples);
+
+/* 一括変換で扱えるフォーマットならば作業領域に収まるサンプル数を返す 扱えなければ0 */
+static uint32_t WAV_GetNumStagingSamples(const struct WAVFileFormat* format);
+/* 作業領域の確保 */
+/* 補足）SIMD実装の書き込みはみ出し分を余分に確保する */
+static uint8_t* WAV_AllocateStaging(const struct WAVFileFormat* format, uint32_t num_staging_samples);
+
+/* インターリーブされたPCMバイト列を32bit形式に変換してチャンネルごとに格納 */
+/* 補足）bytesはnum_samples * num_channels * bytes_per_sampleバイト。data[ch][offset]から書き込む */
+static void WAV_DeinterleavePCM(
+    const uint8_t* bytes, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    WAVPcmData** data, uint32_t offset);
+/* WAV_DeinterleavePCMの1サンプルずつ処理する実装 */
+static void WAV_DeinterleavePCMScalar(
+    const uint8_t* bytes, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    WAVPcmData** data, uint32_t offset);
+
+/* チャンネルごとの32bit形式のPCMをファイルのビット深度に変換してインターリーブ */
+/* 補足）data[ch][offset]からnum_samplesサンプルを変換し、bytesに書き込む */
+/*       SIMD実装のためbytesは変換結果より4バイト以上大きく確保すること */
+static void WAV_InterleavePCM(
+    WAVPcmData* const* data, uint32_t offset, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    uint8_t* bytes);
+/* WAV_InterleavePCMの1サンプルずつ処理する実装 */
+static void WAV_InterleavePCMScalar(
+    WAVPcmData* const* data, uint32_t offset, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    uint8_t* bytes);
+#if WAV_USE_SSSE3
+/* SSSE3で4サンプル分のPCMを読み込み32bit形式に拡張 */
+static __m128i WAV_LoadPCM4SSSE3(const uint8_t* bytes, uint32_t bytes_per_sample);
+/* SSSE3でWAV_DeinterleavePCMを処理 処理したサンプル数を返す */
+/* 補足）モノラル・ステレオのみ対応 */
+static uint32_t WAV_DeinterleavePCMSSSE3(
+    const uint8_t* bytes, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    WAVPcmData** data, uint32_t offset);
+/* SSSE3で8値分の32bit形式のPCMをビット深度に変換して書き込み */
+static void WAV_StorePCM8SSSE3(__m128i v0, __m128i v1, uint32_t bytes_per_sample, uint8_t* bytes);
+/* SSSE3でWAV_InterleavePCMを処理 処理したサンプル数を返す */
+/* 補足）モノラル・ステレオのみ対応 */
+static uint32_t WAV_InterleavePCMSSSE3(
+    WAVPcmData* const* data, uint32_t offset, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    uint8_t* bytes);
+#endif
 
 /* 8bitPCM形式を32bit形式に変換 */
 static int32_t WAV_Convert8bitPCMto32bitPCM(int32_t in_8bitpcm);
@@ -194,8 +297,9 @@ static WAVError WAVParser_GetWAVFormat(
 
   /* サンプル数: 波形データバイト数から算出 */
   if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) { return WAV_ERROR_IO; }
+  /* 補足）パイプ出力などで長さ不明として最大値が書かれている場合があるので、端数は切り捨てる */
+  /*       （実際のデータがサイズより短い場合はストリーミング読み込みで終端まで読む） */
   tmp_format.num_samples = (uint32_t)bitsbuf;
-  assert(tmp_format.num_samples % ((tmp_format.bits_per_sample / 8) * tmp_format.num_channels) == 0);
   tmp_format.num_samples /= ((tmp_format.bits_per_sample / 8) * tmp_format.num_channels);
 
   /* 構造体コピー */
@@ -207,6 +311,70 @@ static WAVError WAVParser_GetWAVFormat(
 /* パーサを使用してPCMデータを読み取り */
 static WAVError WAVParser_GetWAVPcmData(
     struct WAVParser* parser, struct WAVFile* wavfile)
+{
+  uint32_t  num_staging_samples;
+  uint8_t*  staging;
+
+  /* 引数チェック */
+  if (parser == NULL || wavfile == NULL) {
+    return WAV_ERROR_INVALID_PARAMETER;
+  }
+
+  /* 対応するフォーマットでなければ、あるいはバイト境界にいなければビット単位で読み取り */
+  num_staging_samples = WAV_GetNumStagingSamples(&wavfile->format);
+  if ((num_staging_samples == 0) || !WAVParser_IsByteAligned(parser)) {
+    return WAVParser_GetWAVPcmDataByBits(parser, wavfile);
+  }
+
+  /* 作業領域確保 */
+  if ((staging = WAV_AllocateStaging(&wavfile->format, num_staging_samples)) == NULL) {
+    return WAVParser_GetWAVPcmDataByBits(parser, wavfile);
+  }
+
+  /* 作業領域に一括で読み込んでからチャンネルごとに展開 */
+  if (WAVParser_GetPcmFrames(parser, &wavfile->format, staging, num_staging_samples,
+        wavfile->data, 0, wavfile->format.num_samples) < wavfile->format.num_samples) {
+    free(staging);
+    return WAV_ERROR_IO;
+  }
+
+  free(staging);
+  return WAV_ERROR_OK;
+}
+
+/* パーサを使用してnum_samplesサンプル分のPCMデータを作業領域経由で読み取りdata[ch][offset]から格納 */
+static uint32_t WAVParser_GetPcmFrames(
+    struct WAVParser* parser, const struct WAVFileFormat* format,
+    uint8_t* staging, uint32_t num_staging_samples,
+    WAVPcmData** data, uint32_t offset, uint32_t num_samples)
+{
+  uint32_t progress;
+  const uint32_t bytes_per_sample = format->bits_per_sample / 8;
+  const uint32_t bytes_per_frame = bytes_per_sample * format->num_channels;
+
+  assert((parser != NULL) && (staging != NULL) && (data != NULL));
+  assert(num_staging_samples > 0);
+
+  for (progress = 0; progress < num_samples; ) {
+    uint32_t num_read_samples
+      = (num_samples - progress < num_staging_samples) ? (num_samples - progress) : num_staging_samples;
+    const uint32_t num_read_bytes = WAVParser_GetBytes(parser, staging, num_read_samples * bytes_per_frame);
+    const uint8_t is_short = (num_read_bytes < num_read_samples * bytes_per_frame) ? 1 : 0;
+    num_read_samples = num_read_bytes / bytes_per_frame;
+    WAV_DeinterleavePCM(staging,
+        bytes_per_sample, format->num_channels, num_read_samples, data, offset + progress);
+    progress += num_read_samples;
+    if (is_short) {
+      break;
+    }
+  }
+
+  return progress;
+}
+
+/* パーサを使用してPCMデータを1サンプルずつビット単位で読み取り */
+static WAVError WAVParser_GetWAVPcmDataByBits(
+    struct WAVParser* parser, struct WAVFile* wavfile)
 {
   uint32_t  ch, sample, bytes_per_sample;
   uint64_t  bitsbuf;
@@ -251,6 +419,279 @@ static WAVError WAVParser_GetWAVPcmData(
   return WAV_ERROR_OK;
 }
 
+/* 一括変換で扱えるフォーマットならば作業領域に収まるサンプル数を返す 扱えなければ0 */
+static uint32_t WAV_GetNumStagingSamples(const struct WAVFileFormat* format)
+{
+  assert(format != NULL);
+
+  switch (format->bits_per_sample) {
+    case 8: case 16: case 24: case 32:
+      break;
+    default:
+      return 0;
+  }
+  if (format->num_channels == 0) {
+    return 0;
+  }
+
+  return WAV_PCM_STAGING_BUFFER_SIZE / ((format->bits_per_sample / 8) * format->num_channels);
+}
+
+/* 作業領域の確保 */
+static uint8_t* WAV_AllocateStaging(const struct WAVFileFormat* format, uint32_t num_staging_samples)
+{
+  assert(format != NULL);
+  return (uint8_t *)malloc(num_staging_samples * (format->bits_per_sample / 8) * format->num_channels + 16);
+}
+
+/* インターリーブされたPCMバイト列を32bit形式に変換してチャンネルごとに格納 */
+static void WAV_DeinterleavePCM(
+    const uint8_t* bytes, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    WAVPcmData** data, uint32_t offset)
+{
+  uint32_t num_processed = 0;
+
+  assert((bytes != NULL) && (data != NULL));
+
+#if WAV_USE_SSSE3
+  if ((num_channels <= 2) && __builtin_cpu_supports("ssse3")) {
+    num_processed = WAV_DeinterleavePCMSSSE3(bytes, bytes_per_sample, num_channels, num_samples, data, offset);
+  }
+#endif
+
+  /* 残りのサンプルを処理 */
+  WAV_DeinterleavePCMScalar(&bytes[num_processed * bytes_per_sample * num_channels],
+      bytes_per_sample, num_channels, num_samples - num_processed, data, offset + num_processed);
+}
+
+/* WAV_DeinterleavePCMの1サンプルずつ処理する実装 */
+static void WAV_DeinterleavePCMScalar(
+    const uint8_t* bytes, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    WAVPcmData** data, uint32_t offset)
+{
+  uint32_t ch, smpl;
+  const uint8_t *pos;
+
+  /* ビット深度での分岐はループの外で行う */
+  /* 補足）リトルエンディアンのバイト列を上位ビットに詰める */
+  switch (bytes_per_sample) {
+    case 1:
+      for (ch = 0; ch < num_channels; ch++) {
+        pos = &bytes[ch];
+        for (smpl = 0; smpl < num_samples; smpl++, pos += num_channels) {
+          data[ch][offset + smpl] = WAV_Convert8bitPCMto32bitPCM(pos[0]);
+        }
+      }
+      break;
+    case 2:
+      for (ch = 0; ch < num_channels; ch++) {
+        pos = &bytes[2 * ch];
+        for (smpl = 0; smpl < num_samples; smpl++, pos += 2 * num_channels) {
+          data[ch][offset + smpl] = (int32_t)(((uint32_t)pos[0] << 16) | ((uint32_t)pos[1] << 24));
+        }
+      }
+      break;
+    case 3:
+      for (ch = 0; ch < num_channels; ch++) {
+        pos = &bytes[3 * ch];
+        for (smpl = 0; smpl < num_samples; smpl++, pos += 3 * num_channels) {
+          data[ch][offset + smpl]
+            = (int32_t)(((uint32_t)pos[0] << 8) | ((uint32_t)pos[1] << 16) | ((uint32_t)pos[2] << 24));
+        }
+      }
+      break;
+    case 4:
+      for (ch = 0; ch < num_channels; ch++) {
+        pos = &bytes[4 * ch];
+        for (smpl = 0; smpl < num_samples; smpl++, pos += 4 * num_channels) {
+          data[ch][offset + smpl] = (int32_t)((uint32_t)pos[0]
+              | ((uint32_t)pos[1] << 8) | ((uint32_t)pos[2] << 16) | ((uint32_t)pos[3] << 24));
+        }
+      }
+      break;
+    default:
+      assert(0);
+  }
+}
+
+#if WAV_USE_SSSE3
+/* SSSE3で4サンプル分のPCMを読み込み32bit形式に拡張 */
+__attribute__((target("ssse3")))
+static __m128i WAV_LoadPCM4SSSE3(const uint8_t* bytes, uint32_t bytes_per_sample)
+{
+  const __m128i zero = _mm_setzero_si128();
+
+  switch (bytes_per_sample) {
+    case 1:
+      {
+        /* 符号反転で128を引いた値にし、下位にゼロを詰めて24bit左シフト相当 */
+        int32_t tmp;
+        __m128i v;
+        memcpy(&tmp, bytes, sizeof(int32_t));
+        v = _mm_xor_si128(_mm_cvtsi32_si128(tmp), _mm_set1_epi8((char)0x80));
+        v = _mm_unpacklo_epi8(zero, v);
+        return _mm_unpacklo_epi16(zero, v);
+      }
+    case 2:
+      /* 下位にゼロを詰めて16bit左シフト相当 */
+      return _mm_unpacklo_epi16(zero, _mm_loadl_epi64((const __m128i *)bytes));
+    case 3:
+      /* 3バイトずつ各レーンの上位に配置 */
+      return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)bytes),
+          _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11));
+    default:
+      return _mm_loadu_si128((const __m128i *)bytes);
+  }
+}
+
+/* SSSE3でWAV_DeinterleavePCMを処理 処理したサンプル数を返す */
+__attribute__((target("ssse3")))
+static uint32_t WAV_DeinterleavePCMSSSE3(
+    const uint8_t* bytes, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    WAVPcmData** data, uint32_t offset)
+{
+  uint32_t smpl, pos;
+  const uint32_t num_bytes = num_samples * num_channels * bytes_per_sample;
+
+  assert((num_channels == 1) || (num_channels == 2));
+
+  /* 8値ずつ処理 24bitは16バイト読み込むため末尾に4バイトの余裕を持たせる */
+  smpl = 0;
+  for (pos = 0; (pos + 8 * bytes_per_sample + 4) <= num_bytes; pos += 8 * bytes_per_sample) {
+    const __m128i v0 = WAV_LoadPCM4SSSE3(&bytes[pos], bytes_per_sample);
+    const __m128i v1 = WAV_LoadPCM4SSSE3(&bytes[pos + 4 * bytes_per_sample], bytes_per_sample);
+    if (num_channels == 1) {
+      _mm_storeu_si128((__m128i *)&data[0][offset + smpl], v0);
+      _mm_storeu_si128((__m128i *)&data[0][offset + smpl + 4], v1);
+      smpl += 8;
+    } else {
+      /* [L0 R0 L1 R1] [L2 R2 L3 R3] -> [L0 L1 L2 L3] [R0 R1 R2 R3] */
+      const __m128i t0 = _mm_shuffle_epi32(v0, _MM_SHUFFLE(3, 1, 2, 0));
+      const __m128i t1 = _mm_shuffle_epi32(v1, _MM_SHUFFLE(3, 1, 2, 0));
+      _mm_storeu_si128((__m128i *)&data[0][offset + smpl], _mm_unpacklo_epi64(t0, t1));
+      _mm_storeu_si128((__m128i *)&data[1][offset + smpl], _mm_unpackhi_epi64(t0, t1));
+      smpl += 4;
+    }
+  }
+
+  return smpl;
+}
+#endif
+
+/* チャンネルごとの32bit形式のPCMをファイルのビット深度に変換してインターリーブ */
+static void WAV_InterleavePCM(
+    WAVPcmData* const* data, uint32_t offset, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    uint8_t* bytes)
+{
+  uint32_t num_processed = 0;
+
+  assert((bytes != NULL) && (data != NULL));
+
+#if WAV_USE_SSSE3
+  if ((num_channels <= 2) && __builtin_cpu_supports("ssse3")) {
+    num_processed = WAV_InterleavePCMSSSE3(data, offset, bytes_per_sample, num_channels, num_samples, bytes);
+  }
+#endif
+
+  /* 残りのサンプルを処理 */
+  WAV_InterleavePCMScalar(data, offset + num_processed, bytes_per_sample, num_channels,
+      num_samples - num_processed, &bytes[num_processed * bytes_per_sample * num_channels]);
+}
+
+/* WAV_InterleavePCMの1サンプルずつ処理する実装 */
+static void WAV_InterleavePCMScalar(
+    WAVPcmData* const* data, uint32_t offset, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    uint8_t* bytes)
+{
+  uint32_t ch, smpl, i;
+  uint8_t *pos;
+
+  /* 補足）32bit形式の上位バイトをリトルエンディアンで出力する。8bitは128のオフセットを加える */
+  for (ch = 0; ch < num_channels; ch++) {
+    pos = &bytes[bytes_per_sample * ch];
+    for (smpl = 0; smpl < num_samples; smpl++, pos += bytes_per_sample * num_channels) {
+      const uint32_t val = (uint32_t)data[ch][offset + smpl];
+      for (i = 0; i < bytes_per_sample; i++) {
+        pos[i] = (uint8_t)((val >> (8 * (4 - bytes_per_sample + i))) & 0xFFU);
+      }
+      if (bytes_per_sample == 1) {
+        pos[0] ^= 0x80U;
+      }
+    }
+  }
+}
+
+#if WAV_USE_SSSE3
+/* SSSE3で8値分の32bit形式のPCMをビット深度に変換して書き込み */
+__attribute__((target("ssse3")))
+static void WAV_StorePCM8SSSE3(__m128i v0, __m128i v1, uint32_t bytes_per_sample, uint8_t* bytes)
+{
+  /* 各レーンの上位バイトを取り出して詰める */
+  switch (bytes_per_sample) {
+    case 1:
+      {
+        const __m128i lo = _mm_shuffle_epi8(v0,
+            _mm_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+        const __m128i hi = _mm_shuffle_epi8(v1,
+            _mm_setr_epi8(-1, -1, -1, -1, 3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+        _mm_storel_epi64((__m128i *)bytes, _mm_xor_si128(_mm_or_si128(lo, hi), _mm_set1_epi8((char)0x80)));
+      }
+      break;
+    case 2:
+      {
+        const __m128i lo = _mm_shuffle_epi8(v0,
+            _mm_setr_epi8(2, 3, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+        const __m128i hi = _mm_shuffle_epi8(v1,
+            _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 2, 3, 6, 7, 10, 11, 14, 15));
+        _mm_storeu_si128((__m128i *)bytes, _mm_or_si128(lo, hi));
+      }
+      break;
+    case 3:
+      {
+        /* 12バイトずつ書き込む 後ろの4バイトは次の書き込みで上書きされる */
+        const __m128i mask = _mm_setr_epi8(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1);
+        _mm_storeu_si128((__m128i *)bytes, _mm_shuffle_epi8(v0, mask));
+        _mm_storeu_si128((__m128i *)&bytes[12], _mm_shuffle_epi8(v1, mask));
+      }
+      break;
+    default:
+      _mm_storeu_si128((__m128i *)bytes, v0);
+      _mm_storeu_si128((__m128i *)&bytes[16], v1);
+      break;
+  }
+}
+
+/* SSSE3でWAV_InterleavePCMを処理 処理したサンプル数を返す */
+__attribute__((target("ssse3")))
+static uint32_t WAV_InterleavePCMSSSE3(
+    WAVPcmData* const* data, uint32_t offset, uint32_t bytes_per_sample, uint32_t num_channels, uint32_t num_samples,
+    uint8_t* bytes)
+{
+  uint32_t smpl, pos;
+
+  assert((num_channels == 1) || (num_channels == 2));
+
+  /* 8値ずつ処理 */
+  pos = 0;
+  if (num_channels == 1) {
+    for (smpl = 0; (smpl + 8) <= num_samples; smpl += 8, pos += 8 * bytes_per_sample) {
+      WAV_StorePCM8SSSE3(
+          _mm_loadu_si128((const __m128i *)&data[0][offset + smpl]),
+          _mm_loadu_si128((const __m128i *)&data[0][offset + smpl + 4]), bytes_per_sample, &bytes[pos]);
+    }
+  } else {
+    for (smpl = 0; (smpl + 4) <= num_samples; smpl += 4, pos += 8 * bytes_per_sample) {
+      /* [L0 L1 L2 L3] [R0 R1 R2 R3] -> [L0 R0 L1 R1] [L2 R2 L3 R3] */
+      const __m128i l = _mm_loadu_si128((const __m128i *)&data[0][offset + smpl]);
+      const __m128i r = _mm_loadu_si128((const __m128i *)&data[1][offset + smpl]);
+      WAV_StorePCM8SSSE3(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r), bytes_per_sample, &bytes[pos]);
+    }
+  }
+
+  return smpl;
+}
+#endif
+
 /* ファイルからWAVファイルフォーマットだけ読み取り */
 WAVApiResult WAV_GetWAVFormatFromFile(
     const char* filename, struct WAVFileFormat* format)
@@ -287,6 +728,50 @@ WAVApiResult WAV_GetWAVFormatFromFile(
   return WAV_APIRESULT_OK;
 }
 
+/* ファイルからWAVファイルフォーマットとPCMデータ先頭のファイル内オフセットを読み取り */
+WAVApiResult WAV_GetWAVFormatAndDataOffsetFromFile(
+    const char* filename, struct WAVFileFormat* format, uint32_t* data_offset)
+{
+  struct WAVParser parser;
+  FILE*            fp;
+  int32_t          pos;
+
+  /* 引数チェック */
+  if (filename == NULL || format == NULL || data_offset == NULL) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  /* wavファイルを開く */
+  fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    return WAV_APIRESULT_NG;
+  }
+
+  /* パーサ初期化 */
+  WAVParser_Initialize(&parser, fp);
+
+  /* ヘッダ読み取り 読み取り後はdataチャンクの先頭にいる */
+  if (WAVParser_GetWAVFormat(&parser, format) != WAV_ERROR_OK) {
+    WAVParser_Finalize(&parser);
+    fclose(fp);
+    return WAV_APIRESULT_NG;
+  }
+  pos = WAVParser_Tell(&parser);
+
+  /* パーサ使用終了 */
+  WAVParser_Finalize(&parser);
+
+  /* ファイルを閉じる */
+  fclose(fp);
+
+  if (pos < 0) {
+    return WAV_APIRESULT_IOERROR;
+  }
+  *data_offset = (uint32_t)pos;
+
+  return WAV_APIRESULT_OK;
+}
+
 /* ファイルからWAVファイルハンドルを作成 */
 struct WAVFile* WAV_CreateFromFile(const char* filename)
 {
@@ -343,6 +828,124 @@ EXIT_FAILURE_WITH_DATA_RELEASE:
   return NULL;
 }
 
+/* ファイルを開いてストリーミング読み込みを開始 */
+struct WAVReadStream* WAV_OpenReadStream(
+    const char* filename, struct WAVFileFormat* format)
+{
+  FILE* fp;
+  struct WAVReadStream* stream;
+
+  /* 引数チェック */
+  if (filename == NULL || format == NULL) {
+    return NULL;
+  }
+
+  /* wavファイルを開く */
+  fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  if ((stream = WAV_OpenReadStreamFromFilePointer(fp, format)) == NULL) {
+    fclose(fp);
+    return NULL;
+  }
+
+  return stream;
+}
+
+/* 開いているファイルポインタからストリーミング読み込みを開始 */
+struct WAVReadStream* WAV_OpenReadStreamFromFilePointer(
+    FILE* fp, struct WAVFileFormat* format)
+{
+  struct WAVReadStream* stream;
+
+  /* 引数チェック */
+  if (fp == NULL || format == NULL) {
+    return NULL;
+  }
+
+  /* ハンドル作成 */
+  stream = (struct WAVReadStream *)malloc(sizeof(struct WAVReadStream));
+  if (stream == NULL) {
+    return NULL;
+  }
+  stream->staging = NULL;
+  stream->fp = fp;
+
+  /* パーサ初期化 */
+  WAVParser_Initialize(&stream->parser, stream->fp);
+
+  /* ヘッダ読み取り 読み取り後はdataチャンクの先頭にいる */
+  if (WAVParser_GetWAVFormat(&stream->parser, &stream->format) != WAV_ERROR_OK) {
+    goto EXIT_FAILURE_WITH_DATA_RELEASE;
+  }
+  assert(WAVParser_IsByteAligned(&stream->parser));
+
+  /* 一括変換できるフォーマットのみ対応 */
+  stream->num_staging_samples = WAV_GetNumStagingSamples(&stream->format);
+  if (stream->num_staging_samples == 0) {
+    goto EXIT_FAILURE_WITH_DATA_RELEASE;
+  }
+  if ((stream->staging = WAV_AllocateStaging(&stream->format, stream->num_staging_samples)) == NULL) {
+    goto EXIT_FAILURE_WITH_DATA_RELEASE;
+  }
+
+  stream->num_remain_samples = stream->format.num_samples;
+  *format = stream->format;
+
+  return stream;
+
+EXIT_FAILURE_WITH_DATA_RELEASE:
+  /* 失敗時はファイルポインタを閉じない */
+  stream->fp = NULL;
+  WAV_CloseReadStream(stream);
+  return NULL;
+}
+
+/* ストリーミング読み込みで次のnum_framesサンプル分を読み込み */
+WAVApiResult WAV_ReadFrames(
+    struct WAVReadStream* stream, WAVPcmData** data, uint32_t num_frames, uint32_t* num_read_frames)
+{
+  uint32_t num_request, num_read;
+
+  /* 引数チェック */
+  if (stream == NULL || data == NULL || num_read_frames == NULL) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  /* 終端を超えて読まない */
+  num_request = (num_frames < stream->num_remain_samples) ? num_frames : stream->num_remain_samples;
+  if (num_request == 0) {
+    *num_read_frames = 0;
+    return WAV_APIRESULT_OK;
+  }
+
+  num_read = WAVParser_GetPcmFrames(&stream->parser, &stream->format,
+      stream->staging, stream->num_staging_samples, data, 0, num_request);
+
+  /* ファイルが途中で切れていたらそこを終端とする */
+  stream->num_remain_samples = (num_read < num_request) ? 0 : (stream->num_remain_samples - num_read);
+
+  *num_read_frames = num_read;
+  return WAV_APIRESULT_OK;
+}
+
+/* ストリーミング読み込みを終了してファイルを閉じる */
+void WAV_CloseReadStream(struct WAVReadStream* stream)
+{
+  if (stream != NULL) {
+    WAVParser_Finalize(&stream->parser);
+    if (stream->fp != NULL) {
+      fclose(stream->fp);
+    }
+    if (stream->staging != NULL) {
+      free(stream->staging);
+    }
+    free(stream);
+  }
+}
+
 /* フォーマットを指定して新規にWAVファイルハンドルを作成 */
 struct WAVFile* WAV_Create(const struct WAVFileFormat* format)
 {
@@ -464,7 +1067,7 @@ static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uin
 
   /* 初回読み込み */
   if (buf->byte_pos == -1) {
-      if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+      if ((buf->num_bytes = (int32_t)fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp)) == 0) {
         return WAV_ERROR_IO;
       }
       buf->byte_pos   = 0;
@@ -486,7 +1089,7 @@ static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uin
 
     /* バッファが一杯ならば、再度読み込み */
     if (buf->byte_pos == WAVBITBUFFER_BUFFER_SIZE) {
-      if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+      if ((buf->num_bytes = (int32_t)fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp)) == 0) {
         return WAV_ERROR_IO;
       }
       buf->byte_pos = 0;
@@ -503,8 +1106,22 @@ static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uin
 }
 
 /* シーク（fseek準拠） */
+/* 補足）現在位置から前方へのシークは読み捨てで行う（パイプ等シークできない入力に対応するため） */
 static WAVError WAVParser_Seek(struct WAVParser* parser, int32_t offset, int32_t wherefrom)
 {
+  if ((wherefrom == SEEK_CUR) && (offset >= 0) && WAVParser_IsByteAligned(parser)) {
+    uint8_t skip_bytes[256];
+    while (offset > 0) {
+      const uint32_t num_skip
+        = ((uint32_t)offset < sizeof(skip_bytes)) ? (uint32_t)offset : (uint32_t)sizeof(skip_bytes);
+      if (WAVParser_GetBytes(parser, skip_bytes, num_skip) < num_skip) {
+        return WAV_ERROR_IO;
+      }
+      offset -= (int32_t)num_skip;
+    }
+    return WAV_ERROR_OK;
+  }
+
   if (parser->buffer.byte_pos != -1) {
     /* バッファに取り込んだ分先読みしているので戻す */
     offset -= (WAVBITBUFFER_BUFFER_SIZE - (parser->buffer.byte_pos + 1));
@@ -517,6 +1134,68 @@ static WAVError WAVParser_Seek(struct WAVParser* parser, int32_t offset, int32_t
   return WAV_ERROR_OK;
 }
 
+/* バイト境界にいるか判定 */
+static uint8_t WAVParser_IsByteAligned(const struct WAVParser* parser)
+{
+  /* 補足）バッファ読み込み直後は現在バイトが未読（bit_count == 8）、 */
+  /*       バイトを読み切った直後は次のバイトから未読（bit_count == 0） */
+  return ((parser->buffer.byte_pos == -1)
+      || (parser->buffer.bit_count == 8) || (parser->buffer.bit_count == 0)) ? 1 : 0;
+}
+
+/* 次に読むバイトのファイル先頭からの位置を取得（ftell準拠） */
+static int32_t WAVParser_Tell(const struct WAVParser* parser)
+{
+  long pos;
+  const struct WAVBitBuffer *buf = &(parser->buffer);
+
+  assert(parser != NULL);
+  assert(WAVParser_IsByteAligned(parser));
+
+  if ((pos = ftell(parser->fp)) < 0) {
+    return -1;
+  }
+
+  /* バッファに取り込んだ未読の分だけ戻す */
+  if (buf->byte_pos != -1) {
+    const int32_t head = (buf->bit_count == 8) ? buf->byte_pos : (buf->byte_pos + 1);
+    pos -= (long)(buf->num_bytes - head);
+  }
+
+  return (int32_t)pos;
+}
+
+/* バイト列を一括で取得 取得できたバイト数を返す */
+static uint32_t WAVParser_GetBytes(struct WAVParser* parser, uint8_t* bytes, uint32_t nbytes)
+{
+  uint32_t num_copy = 0;
+  struct WAVBitBuffer *buf = &(parser->buffer);
+
+  assert((parser != NULL) && (bytes != NULL));
+  assert(WAVParser_IsByteAligned(parser));
+
+  /* ビットバッファに残っている分を先に使う */
+  if (buf->byte_pos != -1) {
+    const int32_t head = (buf->bit_count == 8) ? buf->byte_pos : (buf->byte_pos + 1);
+    if (head < buf->num_bytes) {
+      num_copy = (uint32_t)(buf->num_bytes - head);
+      num_copy = (num_copy < nbytes) ? num_copy : nbytes;
+      memcpy(bytes, &(buf->bytes[head]), num_copy);
+    }
+    /* 残りを使い切ったらバッファを空に、そうでなければ読み込み位置を進める */
+    if ((uint32_t)(buf->num_bytes - head) <= num_copy) {
+      buf->byte_pos = -1;
+    } else {
+      buf->byte_pos = head + (int32_t)num_copy;
+      buf->bit_count = 8;
+      return num_copy;
+    }
+  }
+
+  /* 残りはファイルから直接読み込む */
+  return num_copy + (uint32_t)fread(&bytes[num_copy], sizeof(uint8_t), nbytes - num_copy, parser->fp);
+}
+
 /* WAVファイルハンドルを破棄 */
 void WAV_Destroy(struct WAVFile* wavfile)
 {
@@ -629,6 +1308,60 @@ static WAVError WAVWriter_PutWAVHeader(
 /* ライタを使用してPCMデータ出力 */
 static WAVError WAVWriter_PutWAVPcmData(
     struct WAVWriter* writer, const struct WAVFile* wavfile)
+{
+  uint32_t  num_staging_samples;
+  uint8_t*  staging;
+  WAVError  err;
+
+  /* 対応するフォーマットでなければ、あるいはバイト境界にいなければビット単位で出力 */
+  num_staging_samples = WAV_GetNumStagingSamples(&wavfile->format);
+  if ((num_staging_samples == 0) || (writer->bit_count != 8)) {
+    return WAVWriter_PutWAVPcmDataByBits(writer, wavfile);
+  }
+
+  /* 作業領域確保 */
+  if ((staging = WAV_AllocateStaging(&wavfile->format, num_staging_samples)) == NULL) {
+    return WAVWriter_PutWAVPcmDataByBits(writer, wavfile);
+  }
+
+  /* 作業領域でインターリーブしてから一括で書き出し */
+  err = WAVWriter_PutPcmFrames(writer, &wavfile->format, staging, num_staging_samples,
+      wavfile->data, 0, wavfile->format.num_samples);
+
+  free(staging);
+  return err;
+}
+
+/* ライタを使用してdata[ch][offset]からnum_samplesサンプル分のPCMデータを作業領域経由で出力 */
+static WAVError WAVWriter_PutPcmFrames(
+    struct WAVWriter* writer, const struct WAVFileFormat* format,
+    uint8_t* staging, uint32_t num_staging_samples,
+    WAVPcmData* const* data, uint32_t offset, uint32_t num_samples)
+{
+  uint32_t progress;
+  WAVError err;
+  const uint32_t bytes_per_sample = format->bits_per_sample / 8;
+  const uint32_t bytes_per_frame = bytes_per_sample * format->num_channels;
+
+  assert((writer != NULL) && (staging != NULL) && (data != NULL));
+  assert(num_staging_samples > 0);
+
+  for (progress = 0; progress < num_samples; progress += num_staging_samples) {
+    const uint32_t num_write_samples
+      = (num_samples - progress < num_staging_samples) ? (num_samples - progress) : num_staging_samples;
+    WAV_InterleavePCM(data, offset + progress,
+        bytes_per_sample, format->num_channels, num_write_samples, staging);
+    if ((err = WAVWriter_PutBytes(writer, staging, num_write_samples * bytes_per_frame)) != WAV_ERROR_OK) {
+      return err;
+    }
+  }
+
+  return WAV_ERROR_OK;
+}
+
+/* ライタを使用してPCMデータを1サンプルずつビット単位で出力 */
+static WAVError WAVWriter_PutWAVPcmDataByBits(
+    struct WAVWriter* writer, const struct WAVFile* wavfile)
 {
   uint32_t  ch, sample, bytes_per_sample;
   int32_t   (*convert_sint32_to_pcmdata_func)(int32_t);
@@ -709,6 +1442,174 @@ WAVApiResult WAV_WriteToFile(
   return WAV_APIRESULT_OK;
 }
 
+/* フォーマットに従ったヘッダ（WAV_HEADER_SIZEバイト）をメモリに書き出し */
+WAVApiResult WAV_PutWAVHeaderToMemory(
+    const struct WAVFileFormat* format, uint8_t* data, uint32_t data_size)
+{
+  struct WAVWriter writer;
+
+  /* 引数チェック */
+  if (format == NULL || data == NULL) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+  if (data_size < WAV_HEADER_SIZE) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  /* ヘッダはライタのバッファに収まるのでファイルには書き出されない */
+  WAVWriter_Initialize(&writer, NULL);
+  if (WAVWriter_PutWAVHeader(&writer, format) != WAV_ERROR_OK) {
+    return WAV_APIRESULT_INVALID_FORMAT;
+  }
+  assert(writer.buffer.byte_pos == WAV_HEADER_SIZE);
+  memcpy(data, writer.buffer.bytes, WAV_HEADER_SIZE);
+
+  return WAV_APIRESULT_OK;
+}
+
+/* ファイルを開いてストリーミング書き込みを開始 */
+struct WAVWriteStream* WAV_OpenWriteStream(
+    const char* filename, const struct WAVFileFormat* format)
+{
+  FILE* fp;
+  struct WAVWriteStream* stream;
+
+  /* 引数チェック */
+  if (filename == NULL || format == NULL) {
+    return NULL;
+  }
+
+  /* 一括変換できるフォーマットのみ対応 */
+  if ((format->data_format != WAV_DATA_FORMAT_PCM) || (WAV_GetNumStagingSamples(format) == 0)) {
+    return NULL;
+  }
+
+  /* wavファイルを開く */
+  fp = fopen(filename, "wb");
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  if ((stream = WAV_OpenWriteStreamToFilePointer(fp, format)) == NULL) {
+    fclose(fp);
+    return NULL;
+  }
+
+  return stream;
+}
+
+/* 開いているファイルポインタへストリーミング書き込みを開始 */
+struct WAVWriteStream* WAV_OpenWriteStreamToFilePointer(
+    FILE* fp, const struct WAVFileFormat* format)
+{
+  struct WAVWriteStream* stream;
+
+  /* 引数チェック */
+  if (fp == NULL || format == NULL) {
+    return NULL;
+  }
+
+  /* 一括変換できるフォーマットのみ対応 */
+  if ((format->data_format != WAV_DATA_FORMAT_PCM) || (WAV_GetNumStagingSamples(format) == 0)) {
+    return NULL;
+  }
+
+  /* ハンドル作成 */
+  stream = (struct WAVWriteStream *)malloc(sizeof(struct WAVWriteStream));
+  if (stream == NULL) {
+    return NULL;
+  }
+  stream->format = (*format);
+  stream->num_written_samples = 0;
+  stream->num_staging_samples = WAV_GetNumStagingSamples(format);
+  if ((stream->staging = WAV_AllocateStaging(format, stream->num_staging_samples)) == NULL) {
+    free(stream);
+    return NULL;
+  }
+
+  /* パイプ等シークできない出力ではヘッダを後から書き換えられない */
+  stream->fp = fp;
+  stream->seekable = (fseek(fp, 0, SEEK_CUR) == 0) ? 1 : 0;
+
+  /* ライタ初期化 */
+  WAVWriter_Initialize(&stream->writer, stream->fp);
+
+  /* 指定されたサンプル数でヘッダ書き出し */
+  if (WAVWriter_PutWAVHeader(&stream->writer, &stream->format) != WAV_ERROR_OK) {
+    WAVWriter_Finalize(&stream->writer);
+    free(stream->staging);
+    free(stream);
+    return NULL;
+  }
+
+  return stream;
+}
+
+/* ストリーミング書き込みでdata[ch][0]からnum_framesサンプル分を書き出し */
+WAVApiResult WAV_WriteFrames(
+    struct WAVWriteStream* stream, WAVPcmData* const* data, uint32_t num_frames)
+{
+  /* 引数チェック */
+  if (stream == NULL || data == NULL) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  /* 書き出し */
+  if (WAVWriter_PutPcmFrames(&stream->writer, &stream->format,
+        stream->staging, stream->num_staging_samples, data, 0, num_frames) != WAV_ERROR_OK) {
+    return WAV_APIRESULT_IOERROR;
+  }
+  stream->num_written_samples += num_frames;
+
+  return WAV_APIRESULT_OK;
+}
+
+/* ストリーミング書き込みを終了してファイルを閉じる */
+WAVApiResult WAV_FinalizeWriteStream(struct WAVWriteStream* stream)
+{
+  WAVApiResult ret = WAV_APIRESULT_OK;
+
+  /* 引数チェック */
+  if (stream == NULL) {
+    return WAV_APIRESULT_INVALID_PARAMETER;
+  }
+
+  /* バッファに残ったデータを書き出し */
+  if (WAVWriter_Flush(&stream->writer) != WAV_ERROR_OK) {
+    ret = WAV_APIRESULT_IOERROR;
+  }
+  WAVWriter_Finalize(&stream->writer);
+
+  /* ヘッダに書いたサイズと異なる場合はRIFF・dataチャンクのサイズを書き換え */
+  if ((ret == WAV_APIRESULT_OK) && stream->seekable
+      && (stream->num_written_samples != stream->format.num_samples)) {
+    uint8_t size_bytes[2][4];
+    uint32_t i;
+    const uint32_t pcm_data_size
+      = stream->num_written_samples * (stream->format.bits_per_sample / 8) * stream->format.num_channels;
+    for (i = 0; i < 4; i++) {
+      /* ファイルサイズ-8 = PCMデータサイズ + 36 */
+      size_bytes[0][i] = (uint8_t)(((pcm_data_size + 36) >> (8 * i)) & 0xFFU);
+      size_bytes[1][i] = (uint8_t)((pcm_data_size >> (8 * i)) & 0xFFU);
+    }
+    if ((fseek(stream->fp, 4, SEEK_SET) != 0)
+        || (fwrite(size_bytes[0], sizeof(uint8_t), 4, stream->fp) < 4)
+        || (fseek(stream->fp, 40, SEEK_SET) != 0)
+        || (fwrite(size_bytes[1], sizeof(uint8_t), 4, stream->fp) < 4)) {
+      ret = WAV_APIRESULT_IOERROR;
+    }
+  }
+
+  /* ファイルを閉じる */
+  if (fclose(stream->fp) != 0) {
+    ret = WAV_APIRESULT_IOERROR;
+  }
+  free(stream->staging);
+  free(stream);
+
+  return ret;
+}
+
 /* ライタの初期化 */
 static void WAVWriter_Initialize(struct WAVWriter* writer, FILE* fp)
 {
@@ -824,6 +1725,30 @@ static WAVError WAVWriter_Flush(struct WAVWriter* writer)
   return WAV_ERROR_OK;
 }
 
+/* バイト列を一括で書き込む */
+static WAVError WAVWriter_PutBytes(struct WAVWriter* writer, const uint8_t* bytes, uint32_t nbytes)
+{
+  assert((writer != NULL) && (bytes != NULL));
+  assert(writer->bit_count == 8);
+
+  /* バッファに収まるなら追記 */
+  if ((uint32_t)writer->buffer.byte_pos + nbytes <= WAVBITBUFFER_BUFFER_SIZE) {
+    memcpy(&(writer->buffer.bytes[writer->buffer.byte_pos]), bytes, nbytes);
+    writer->buffer.byte_pos += (int32_t)nbytes;
+    return WAV_ERROR_OK;
+  }
+
+  /* バッファにたまった分を書き出してから直接書き込み */
+  if (WAVWriter_Flush(writer) != WAV_ERROR_OK) {
+    return WAV_ERROR_IO;
+  }
+  if (fwrite(bytes, sizeof(uint8_t), nbytes, writer->fp) < nbytes) {
+    return WAV_ERROR_IO;
+  }
+
+  return WAV_ERROR_OK;
+}
+
 /* リトルエンディアンでビットパターンを取得 */
 static WAVError WAVParser_GetLittleEndianBytes(
     struct WAVParser* parser, uint32_t nbytes, uint64_t* bitsbuf)
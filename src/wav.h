@@ -2,6 +2,10 @@
 #define WAV_INCLUDED
 
 #include <stdint.h>
+#include <stdio.h>
+
+/* 本モジュールが書き出すヘッダのサイズ */
+#define WAV_HEADER_SIZE 44
 
 /* PCM型 - ファイルのビット深度如何によらず、メモリ上では全て符号付き32bitで取り扱う */
 typedef int32_t WAVPcmData;
@@ -35,6 +39,12 @@ struct WAVFile {
   WAVPcmData**          data;     /* 実データ     */
 };
 
+/* ストリーミング読み込みハンドル */
+struct WAVReadStream;
+
+/* ストリーミング書き込みハンドル */
+struct WAVWriteStream;
+
 /* アクセサ */
 #define WAVFile_PCM(wavfile, samp, ch)  (wavfile->data[(ch)][(samp)])
 
@@ -59,6 +69,55 @@ WAVApiResult WAV_WriteToFile(
 WAVApiResult WAV_GetWAVFormatFromFile(
     const char* filename, struct WAVFileFormat* format);
 
+/* ファイルからWAVファイルフォーマットとPCMデータ先頭のファイル内オフセットを読み取り */
+/* 補足）ファイルをメモリマップしてPCMデータを直接参照するときに使う */
+WAVApiResult WAV_GetWAVFormatAndDataOffsetFromFile(
+    const char* filename, struct WAVFileFormat* format, uint32_t* data_offset);
+
+/* フォーマットに従ったヘッダ（WAV_HEADER_SIZEバイト）をメモリに書き出し */
+/* 補足）PCMデータサイズはformat->num_samplesから計算する */
+WAVApiResult WAV_PutWAVHeaderToMemory(
+    const struct WAVFileFormat* format, uint8_t* data, uint32_t data_size);
+
+/* ファイルを開いてストリーミング読み込みを開始 */
+/* 補足）formatにファイルのフォーマットを取得する。ビット深度は8/16/24/32のみ対応 */
+struct WAVReadStream* WAV_OpenReadStream(
+    const char* filename, struct WAVFileFormat* format);
+
+/* 開いているファイルポインタからストリーミング読み込みを開始 */
+/* 補足）標準入力などシークできない入力でも読める。成功時はfpの所有権がハンドルに移り、 */
+/*       WAV_CloseReadStreamで閉じられる。失敗時はfpを閉じない */
+struct WAVReadStream* WAV_OpenReadStreamFromFilePointer(
+    FILE* fp, struct WAVFileFormat* format);
+
+/* ストリーミング読み込みで次のnum_framesサンプル分を読み込み */
+/* 補足）data[ch][0]から格納し、num_read_framesに読み込めたサンプル数を返す */
+/*       データの終端に達した後は0サンプルを返す */
+WAVApiResult WAV_ReadFrames(
+    struct WAVReadStream* stream, WAVPcmData** data, uint32_t num_frames, uint32_t* num_read_frames);
+
+/* ストリーミング読み込みを終了してファイルを閉じる */
+void WAV_CloseReadStream(struct WAVReadStream* stream);
+
+/* ファイルを開いてストリーミング書き込みを開始 */
+/* 補足）format->num_samplesのサイズでヘッダを書き出す。総サンプル数が未定ならば0でよい */
+struct WAVWriteStream* WAV_OpenWriteStream(
+    const char* filename, const struct WAVFileFormat* format);
+
+/* 開いているファイルポインタへストリーミング書き込みを開始 */
+/* 補足）標準出力などシークできない出力では、終了時にヘッダのサイズを書き換えない。 */
+/*       成功時はfpの所有権がハンドルに移り、WAV_FinalizeWriteStreamで閉じられる。失敗時はfpを閉じない */
+struct WAVWriteStream* WAV_OpenWriteStreamToFilePointer(
+    FILE* fp, const struct WAVFileFormat* format);
+
+/* ストリーミング書き込みでdata[ch][0]からnum_framesサンプル分を書き出し */
+WAVApiResult WAV_WriteFrames(
+    struct WAVWriteStream* stream, WAVPcmData* const* data, uint32_t num_frames);
+
+/* ストリーミング書き込みを終了してファイルを閉じる */
+/* 補足）書き出したサンプル数がヘッダと異なる場合はRIFF・dataチャンクのサイズを書き換える（シークできる出力のみ） */
+WAVApiResult WAV_FinalizeWriteStream(struct WAVWriteStream* stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,188 @@
+#include "work_stealing_pool.h"
+
+#include <stdlib.h>
+#include <pthread.h>
+
+/* コスト付きのジョブ */
+struct WorkStealingPoolJob {
+  uint64_t cost;  /* コスト */
+  uint32_t job;   /* ジョブ番号 */
+};
+
+/* ワーカごとのジョブ列 */
+/* 補足）先頭から所有ワーカが取り出し、末尾から他のワーカが奪う */
+struct WorkStealingPoolDeque {
+  uint32_t        *jobs;  /* ジョブ番号の列（コストの降順） */
+  uint32_t        head;   /* 先頭位置                       */
+  uint32_t        tail;   /* 末尾位置（含まない）           */
+  pthread_mutex_t mutex;  /* 取り出しの排他                 */
+};
+
+/* ワーカ */
+struct WorkStealingPoolWorker {
+  struct WorkStealingPoolDeque  *deques;        /* 全ワーカのジョブ列 */
+  uint32_t                      num_workers;    /* ワーカ数           */
+  uint32_t                      index;          /* 自身の番号         */
+  WorkStealingPoolJobFunction   job_function;   /* ジョブ処理関数     */
+  void                          *arg;           /* ジョブ処理の引数   */
+};
+
+/* コストの降順（同じならジョブ番号の昇順）に並べる比較関数 */
+static int WorkStealingPool_CompareJob(const void *a, const void *b)
+{
+  const struct WorkStealingPoolJob *job_a = (const struct WorkStealingPoolJob *)a;
+  const struct WorkStealingPoolJob *job_b = (const struct WorkStealingPoolJob *)b;
+
+  if (job_a->cost != job_b->cost) {
+    return (job_a->cost > job_b->cost) ? -1 : 1;
+  }
+  if (job_a->job != job_b->job) {
+    return (job_a->job < job_b->job) ? -1 : 1;
+  }
+  return 0;
+}
+
+/* ジョブ列の先頭（from_head=1）または末尾から1つ取り出す 空なら0を返す */
+static int WorkStealingPoolDeque_Pop(struct WorkStealingPoolDeque *deque, int from_head, uint32_t *job)
+{
+  int popped = 0;
+
+  pthread_mutex_lock(&deque->mutex);
+  if (deque->head < deque->tail) {
+    if (from_head) {
+      (*job) = deque->jobs[deque->head];
+      deque->head++;
+    } else {
+      deque->tail--;
+      (*job) = deque->jobs[deque->tail];
+    }
+    popped = 1;
+  }
+  pthread_mutex_unlock(&deque->mutex);
+
+  return popped;
+}
+
+/* ワーカの処理 自分のジョブ列が尽きたら他のワーカから奪い、全て空になったら終了 */
+static void *WorkStealingPoolWorker_Run(void *arg)
+{
+  uint32_t i, job = 0;
+  int found;
+  struct WorkStealingPoolWorker *worker = (struct WorkStealingPoolWorker *)arg;
+
+  while (1) {
+    /* 自分のジョブ列の先頭（コストの大きいジョブ）から取り出す */
+    found = WorkStealingPoolDeque_Pop(&worker->deques[worker->index], 1, &job);
+
+    /* 尽きていたら隣のワーカから順に、残っているジョブ列の末尾を奪う */
+    for (i = 1; (i < worker->num_workers) && !found; i++) {
+      found = WorkStealingPoolDeque_Pop(&worker->deques[(worker->index + i) % worker->num_workers], 0, &job);
+    }
+
+    /* 全てのジョブ列が空 */
+    if (!found) {
+      break;
+    }
+
+    worker->job_function(worker->arg, job);
+  }
+
+  return NULL;
+}
+
+/* num_jobs個のジョブをnum_workers個のワーカで実行 全ジョブの終了まで戻らない */
+WorkStealingPoolApiResult WorkStealingPool_Run(
+    uint32_t num_workers, const uint64_t *job_costs, uint32_t num_jobs,
+    WorkStealingPoolJobFunction job_function, void *const *worker_args)
+{
+  uint32_t i, num_mutex_initialized = 0;
+  struct WorkStealingPoolJob *sorted_jobs = NULL;
+  struct WorkStealingPoolDeque *deques = NULL;
+  struct WorkStealingPoolWorker *workers = NULL;
+  pthread_t *threads = NULL;
+  uint8_t *thread_created = NULL;
+  WorkStealingPoolApiResult ret = WORK_STEALING_POOL_APIRESULT_OK;
+
+  /* 引数チェック */
+  if ((num_workers == 0) || (job_function == NULL) || (worker_args == NULL)) {
+    return WORK_STEALING_POOL_APIRESULT_INVALID_ARGUMENT;
+  }
+
+  if (num_jobs == 0) {
+    return WORK_STEALING_POOL_APIRESULT_OK;
+  }
+
+  /* 領域確保 */
+  sorted_jobs = (struct WorkStealingPoolJob *)malloc(sizeof(struct WorkStealingPoolJob) * num_jobs);
+  deques = (struct WorkStealingPoolDeque *)calloc(num_workers, sizeof(struct WorkStealingPoolDeque));
+  workers = (struct WorkStealingPoolWorker *)malloc(sizeof(struct WorkStealingPoolWorker) * num_workers);
+  threads = (pthread_t *)malloc(sizeof(pthread_t) * num_workers);
+  thread_created = (uint8_t *)malloc(sizeof(uint8_t) * num_workers);
+  if ((sorted_jobs == NULL) || (deques == NULL) || (workers == NULL)
+      || (threads == NULL) || (thread_created == NULL)) {
+    ret = WORK_STEALING_POOL_APIRESULT_NG;
+    goto EXIT;
+  }
+
+  /* コストの降順に並べる */
+  for (i = 0; i < num_jobs; i++) {
+    sorted_jobs[i].cost = (job_costs != NULL) ? job_costs[i] : 0;
+    sorted_jobs[i].job = i;
+  }
+  qsort(sorted_jobs, num_jobs, sizeof(struct WorkStealingPoolJob), WorkStealingPool_CompareJob);
+
+  /* 大きい順に各ワーカへ配る 各ワーカのジョブ列もコストの降順になる */
+  for (i = 0; i < num_workers; i++) {
+    struct WorkStealingPoolDeque *deque = &deques[i];
+    deque->jobs = (uint32_t *)malloc(sizeof(uint32_t) * (num_jobs / num_workers + 1));
+    if ((deque->jobs == NULL) || (pthread_mutex_init(&deque->mutex, NULL) != 0)) {
+      ret = WORK_STEALING_POOL_APIRESULT_NG;
+      goto EXIT;
+    }
+    num_mutex_initialized++;
+    deque->head = deque->tail = 0;
+  }
+  for (i = 0; i < num_jobs; i++) {
+    struct WorkStealingPoolDeque *deque = &deques[i % num_workers];
+    deque->jobs[deque->tail] = sorted_jobs[i].job;
+    deque->tail++;
+  }
+
+  for (i = 0; i < num_workers; i++) {
+    struct WorkStealingPoolWorker *worker = &workers[i];
+    worker->deques        = deques;
+    worker->num_workers   = num_workers;
+    worker->index         = i;
+    worker->job_function  = job_function;
+    worker->arg           = worker_args[i];
+  }
+
+  /* 先頭以外のワーカをスレッドで起動 先頭は呼び出しスレッドで処理 */
+  /* 補足）スレッドが作れなかったワーカのジョブは他のワーカが奪って処理する */
+  for (i = 1; i < num_workers; i++) {
+    thread_created[i] = (pthread_create(&threads[i], NULL, WorkStealingPoolWorker_Run, &workers[i]) == 0) ? 1 : 0;
+  }
+  WorkStealingPoolWorker_Run(&workers[0]);
+  for (i = 1; i < num_workers; i++) {
+    if (thread_created[i] == 1) {
+      pthread_join(threads[i], NULL);
+    }
+  }
+
+EXIT:
+  if (deques != NULL) {
+    for (i = 0; i < num_workers; i++) {
+      if (i < num_mutex_initialized) {
+        pthread_mutex_destroy(&deques[i].mutex);
+      }
+      free(deques[i].jobs);
+    }
+  }
+  free(sorted_jobs);
+  free(deques);
+  free(workers);
+  free(threads);
+  free(thread_created);
+
+  return ret;
+}
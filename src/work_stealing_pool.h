@@ -0,0 +1,32 @@
+#ifndef WORK_STEALING_POOL_H_INCLUDED
+#define WORK_STEALING_POOL_H_INCLUDED
+
+#include <stdint.h>
+
+/* API結果型 */
+typedef enum WorkStealingPoolApiResultTag {
+  WORK_STEALING_POOL_APIRESULT_OK = 0,            /* 成功 */
+  WORK_STEALING_POOL_APIRESULT_INVALID_ARGUMENT,  /* 無効な引数 */
+  WORK_STEALING_POOL_APIRESULT_NG                 /* 分類不能な失敗（領域確保失敗等） */
+} WorkStealingPoolApiResult;
+
+/* ジョブ処理関数 worker_argはワーカごとの引数、jobはジョブ番号 */
+typedef void (*WorkStealingPoolJobFunction)(void *worker_arg, uint32_t job);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* num_jobs個のジョブをnum_workers個のワーカで実行 全ジョブの終了まで戻らない */
+/* 補足）各ワーカは割り当てられたジョブをコスト(job_costs)の大きい順に処理し、 */
+/*       自分の分が尽きたら他のワーカの残りの末尾（コストの小さいジョブ）を奪って処理する */
+/*       job_costsがNULLなら全ジョブ同じコストとみなす */
+WorkStealingPoolApiResult WorkStealingPool_Run(
+    uint32_t num_workers, const uint64_t *job_costs, uint32_t num_jobs,
+    WorkStealingPoolJobFunction job_function, void *const *worker_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WORK_STEALING_POOL_H_INCLUDED */
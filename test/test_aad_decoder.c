@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <sys/stat.h>
 #include <assert.h>
+#include <math.h>
 
 /* テスト対象のモジュール */
 #include "../src/aad_decoder.c"
@@ -15,6 +16,1047 @@
 #include "../src/wav.h"
 
 /* テストのセットアップ関数 */
+/* 並列デコードと逐次デコードの結果が一致するか確認 一致時は1を返す */
+static uint8_t AADDecoderTest_CheckParallelDecode(const uint8_t *data, uint32_t data_size)
+{
+  uint32_t ch, i, smpl;
+  uint8_t is_ok;
+  struct AADDecoder *decoder;
+  struct AADHeaderInfo header;
+  int32_t *reference[AAD_MAX_NUM_CHANNELS];
+  int32_t *decoded[AAD_MAX_NUM_CHANNELS];
+  const uint32_t num_threads_list[] = { 1, 2, 3, 4, 7, 64 };
+
+  assert(data != NULL);
+
+  if (AADDecoder_DecodeHeader(data, data_size, &header) != AAD_APIRESULT_OK) {
+    return 0;
+  }
+
+  decoder = AADDecoder_Create(NULL, 0);
+  for (ch = 0; ch < header.num_channels; ch++) {
+    reference[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+    decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+  }
+
+  /* 逐次デコード結果をリファレンスとする */
+  if (AADDecoder_DecodeWhole(decoder,
+        data, data_size, reference, header.num_channels, header.num_samples) != AAD_APIRESULT_OK) {
+    is_ok = 0;
+    goto CHECK_END;
+  }
+
+  /* スレッド数を変えながら一致確認 */
+  is_ok = 1;
+  for (i = 0; i < sizeof(num_threads_list) / sizeof(num_threads_list[0]); i++) {
+    for (ch = 0; ch < header.num_channels; ch++) {
+      memset(decoded[ch], 0xCD, sizeof(int32_t) * header.num_samples);
+    }
+    if (AADDecoder_DecodeWholeParallel(decoder,
+          data, data_size, decoded, header.num_channels, header.num_samples,
+          num_threads_list[i]) != AAD_APIRESULT_OK) {
+      is_ok = 0;
+      goto CHECK_END;
+    }
+    for (ch = 0; ch < header.num_channels; ch++) {
+      for (smpl = 0; smpl < header.num_samples; smpl++) {
+        if (decoded[ch][smpl] != reference[ch][smpl]) {
+          is_ok = 0;
+          goto CHECK_END;
+        }
+      }
+    }
+  }
+
+CHECK_END:
+  for (ch = 0; ch < header.num_channels; ch++) {
+    free(reference[ch]);
+    free(decoded[ch]);
+  }
+  AADDecoder_Destroy(decoder);
+
+  return is_ok;
+}
+
+/* 並列デコードテスト */
+static void AADDecoderTest_DecodeParallelTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 引数が不正 */
+  {
+    uint8_t data[AAD_HEADER_SIZE] = { 0, };
+    int32_t buf[1];
+    int32_t *buffer[AAD_MAX_NUM_CHANNELS];
+    struct AADDecoder *decoder = AADDecoder_Create(NULL, 0);
+
+    buffer[0] = buffer[1] = buf;
+
+    Test_AssertEqual(AADDecoder_DecodeWholeParallel(NULL, data, sizeof(data), buffer, 1, 1, 1), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeWholeParallel(decoder, NULL, sizeof(data), buffer, 1, 1, 1), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeWholeParallel(decoder, data, sizeof(data), NULL, 1, 1, 1), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeWholeParallel(decoder, data, sizeof(data), buffer, 1, 1, 0), AAD_APIRESULT_INVALID_ARGUMENT);
+
+    AADDecoder_Destroy(decoder);
+  }
+
+  /* ファイルをデコードし逐次処理と一致するか */
+  {
+    const char *test_files[] = { "sin300Hz_mono.aad", "sin300Hz.aad" };
+    uint32_t i;
+
+    for (i = 0; i < sizeof(test_files) / sizeof(test_files[0]); i++) {
+      FILE *fp;
+      struct stat fstat;
+      uint8_t *data;
+      uint32_t data_size;
+
+      stat(test_files[i], &fstat);
+      data_size = (uint32_t)fstat.st_size;
+      data = (uint8_t *)malloc(data_size);
+      fp = fopen(test_files[i], "rb");
+      assert(fp != NULL);
+      fread(data, sizeof(uint8_t), data_size, fp);
+      fclose(fp);
+
+      Test_AssertEqual(AADDecoderTest_CheckParallelDecode(data, data_size), 1);
+
+      free(data);
+    }
+  }
+
+  /* 多数のブロックからなるデータ */
+  {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  10000
+    uint32_t ch, smpl, buffer_size;
+    uint64_t output_size;
+    int32_t *input[NUM_CHANNELS];
+    uint8_t *data;
+    struct AADEncoder *encoder;
+    struct AADEncodeParameter enc_param;
+
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[ch][smpl] = (int32_t)(INT16_MAX * sin(0.01 * (ch + 1) * smpl));
+      }
+    }
+    buffer_size = sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES;
+    data = (uint8_t *)malloc(buffer_size);
+
+    enc_param.num_channels      = NUM_CHANNELS;
+    enc_param.sampling_rate     = 8000;
+    enc_param.bits_per_sample   = 3;
+    enc_param.max_block_size    = 128;
+    enc_param.ch_process_method = AAD_CH_PROCESS_METHOD_MS;
+    enc_param.num_encode_trials = 1;
+    enc_param.search_method = AAD_SEARCH_METHOD_SEQUENTIAL;
+    encoder = AADEncoder_Create(enc_param.max_block_size, NULL, 0);
+    Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &enc_param), AAD_APIRESULT_OK);
+    Test_AssertEqual(AADEncoder_EncodeWhole(encoder,
+          (const int32_t *const *)input, NUM_SAMPLES, data, buffer_size, &output_size), AAD_APIRESULT_OK);
+
+    Test_AssertEqual(AADDecoderTest_CheckParallelDecode(data, output_size), 1);
+
+    AADEncoder_Destroy(encoder);
+    free(data);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      free(input[ch]);
+    }
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+  }
+}
+
+/* ストリーミングデコードと一括デコードの結果が一致するか確認 一致時は1を返す */
+static uint8_t AADDecoderTest_CheckStreamDecode(
+    const uint8_t *data, uint32_t data_size, uint32_t feed_size, uint32_t output_num_samples)
+{
+  uint32_t ch, smpl, read_offset, write_offset;
+  uint8_t is_ok;
+  struct AADDecoder *decoder;
+  struct AADHeaderInfo header;
+  int32_t *reference[AAD_MAX_NUM_CHANNELS];
+  int32_t *decoded[AAD_MAX_NUM_CHANNELS];
+  int32_t *output[AAD_MAX_NUM_CHANNELS];
+
+  assert(data != NULL);
+
+  if (AADDecoder_DecodeHeader(data, data_size, &header) != AAD_APIRESULT_OK) {
+    return 0;
+  }
+
+  decoder = AADDecoder_Create(NULL, 0);
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    reference[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+    decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+    output[ch] = (int32_t *)malloc(sizeof(int32_t) * output_num_samples);
+  }
+
+  /* 一括デコード結果をリファレンスとする */
+  if (AADDecoder_DecodeWhole(decoder,
+        data, data_size, reference, header.num_channels, header.num_samples) != AAD_APIRESULT_OK) {
+    is_ok = 0;
+    goto CHECK_END;
+  }
+
+  /* 断片ごとに入力しながらデコード */
+  is_ok = 0;
+  if (AADDecoder_BeginDecodeStream(decoder) != AAD_APIRESULT_OK) {
+    goto CHECK_END;
+  }
+  read_offset = write_offset = 0;
+  while (write_offset < header.num_samples) {
+    uint32_t feed, consumed, num_decoded;
+    feed = AAD_MIN_VAL(feed_size, data_size - read_offset);
+    if (AADDecoder_DecodeStream(decoder, &data[read_offset], feed, &consumed,
+          output, AAD_MAX_NUM_CHANNELS, output_num_samples, &num_decoded) != AAD_APIRESULT_OK) {
+      goto CHECK_END;
+    }
+    /* 進まなくなったら失敗 */
+    if ((consumed == 0) && (num_decoded == 0)) {
+      goto CHECK_END;
+    }
+    if (write_offset + num_decoded > header.num_samples) {
+      goto CHECK_END;
+    }
+    for (ch = 0; ch < header.num_channels; ch++) {
+      memcpy(&decoded[ch][write_offset], output[ch], sizeof(int32_t) * num_decoded);
+    }
+    read_offset += consumed;
+    write_offset += num_decoded;
+  }
+
+  /* 全サンプル出力されているか */
+  if (write_offset != header.num_samples) {
+    goto CHECK_END;
+  }
+
+  /* 一致確認 */
+  is_ok = 1;
+  for (ch = 0; ch < header.num_channels; ch++) {
+    for (smpl = 0; smpl < header.num_samples; smpl++) {
+      if (decoded[ch][smpl] != reference[ch][smpl]) {
+        is_ok = 0;
+        goto CHECK_END;
+      }
+    }
+  }
+
+CHECK_END:
+  for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+    free(reference[ch]);
+    free(decoded[ch]);
+    free(output[ch]);
+  }
+  AADDecoder_Destroy(decoder);
+
+  return is_ok;
+}
+
+/* ストリーミングデコードテスト */
+static void AADDecoderTest_DecodeStreamTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 引数が不正 */
+  {
+    uint8_t data[AAD_HEADER_SIZE] = { 0, };
+    int32_t buf[1];
+    int32_t *buffer[AAD_MAX_NUM_CHANNELS];
+    uint32_t consumed, num_decoded;
+    struct AADHeaderInfo header;
+    struct AADDecoder *decoder = AADDecoder_Create(NULL, 0);
+
+    buffer[0] = buffer[1] = buf;
+
+    Test_AssertEqual(AADDecoder_BeginDecodeStream(NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeStream(NULL, data, sizeof(data), &consumed, buffer, 1, 1, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeStream(decoder, NULL, sizeof(data), &consumed, buffer, 1, 1, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeStream(decoder, data, sizeof(data), NULL, buffer, 1, 1, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeStream(decoder, data, sizeof(data), &consumed, NULL, 1, 1, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeStream(decoder, data, sizeof(data), &consumed, buffer, 1, 1, NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_GetHeader(NULL, &header), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_GetHeader(decoder, NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+
+    /* ヘッダが揃うまでは取得できない */
+    Test_AssertEqual(AADDecoder_GetHeader(decoder, &header), AAD_APIRESULT_PARAMETER_NOT_SET);
+
+    /* 不正なヘッダ */
+    Test_AssertEqual(AADDecoder_BeginDecodeStream(decoder), AAD_APIRESULT_OK);
+    Test_AssertEqual(AADDecoder_DecodeStream(decoder, data, sizeof(data), &consumed, buffer, 1, 1, &num_decoded), AAD_APIRESULT_INVALID_FORMAT);
+
+    AADDecoder_Destroy(decoder);
+  }
+
+  /* ファイルを様々な断片サイズ・出力バッファサイズでデコードし一括デコードと一致するか */
+  {
+    const char *test_files[] = { "sin300Hz_mono.aad", "sin300Hz.aad" };
+    const uint32_t feed_size_list[] = { 1, 2, 3, 17, 100, 4096, UINT32_MAX };
+    const uint32_t output_size_list[] = { 4, 7, 8, 1000 };
+    uint32_t i, j, k;
+
+    for (i = 0; i < sizeof(test_files) / sizeof(test_files[0]); i++) {
+      FILE *fp;
+      struct stat fstat;
+      uint8_t *data;
+      uint32_t data_size;
+      struct AADHeaderInfo header;
+      uint32_t consumed, num_decoded;
+      int32_t buf[2][AAD_FILTER_ORDER];
+      int32_t *buffer[AAD_MAX_NUM_CHANNELS];
+      struct AADDecoder *decoder;
+
+      stat(test_files[i], &fstat);
+      data_size = (uint32_t)fstat.st_size;
+      data = (uint8_t *)malloc(data_size);
+      fp = fopen(test_files[i], "rb");
+      assert(fp != NULL);
+      fread(data, sizeof(uint8_t), data_size, fp);
+      fclose(fp);
+
+      for (j = 0; j < sizeof(feed_size_list) / sizeof(feed_size_list[0]); j++) {
+        for (k = 0; k < sizeof(output_size_list) / sizeof(output_size_list[0]); k++) {
+          Test_AssertEqual(AADDecoderTest_CheckStreamDecode(data, data_size, feed_size_list[j], output_size_list[k]), 1);
+        }
+      }
+
+      /* ヘッダ直後・ブロックヘッダ到着時点でサンプルが得られるか */
+      buffer[0] = buf[0]; buffer[1] = buf[1];
+      decoder = AADDecoder_Create(NULL, 0);
+      Test_AssertEqual(AADDecoder_BeginDecodeStream(decoder), AAD_APIRESULT_OK);
+      Test_AssertEqual(AADDecoder_DecodeStream(decoder, data, AAD_HEADER_SIZE, &consumed,
+            buffer, AAD_MAX_NUM_CHANNELS, AAD_FILTER_ORDER, &num_decoded), AAD_APIRESULT_OK);
+      Test_AssertEqual(consumed, AAD_HEADER_SIZE);
+      Test_AssertEqual(num_decoded, 0);
+      Test_AssertEqual(AADDecoder_GetHeader(decoder, &header), AAD_APIRESULT_OK);
+      Test_AssertEqual(AADDecoder_DecodeStream(decoder, &data[AAD_HEADER_SIZE], AAD_BLOCK_HEADER_SIZE(header.num_channels), &consumed,
+            buffer, AAD_MAX_NUM_CHANNELS, AAD_FILTER_ORDER, &num_decoded), AAD_APIRESULT_OK);
+      Test_AssertEqual(consumed, AAD_BLOCK_HEADER_SIZE(header.num_channels));
+      Test_AssertEqual(num_decoded, AAD_FILTER_ORDER);
+      /* 出力バッファに空きがなければ1単位だけ消費してデコーダ内に保持する */
+      Test_AssertEqual(AADDecoder_DecodeStream(decoder, &data[AAD_HEADER_SIZE + AAD_BLOCK_HEADER_SIZE(header.num_channels)], header.block_size, &consumed,
+            buffer, AAD_MAX_NUM_CHANNELS, 0, &num_decoded), AAD_APIRESULT_OK);
+      Test_AssertEqual(consumed, header.num_channels);
+      Test_AssertEqual(num_decoded, 0);
+      Test_AssertEqual(AADDecoder_DecodeStream(decoder, data, 0, &consumed,
+            buffer, AAD_MAX_NUM_CHANNELS, AAD_FILTER_ORDER, &num_decoded), AAD_APIRESULT_OK);
+      Test_AssertEqual(consumed, 0);
+      Test_AssertEqual(num_decoded, 8 / header.bits_per_sample);
+      AADDecoder_Destroy(decoder);
+
+      free(data);
+    }
+  }
+
+  /* 様々なパラメータで生成したデータ */
+  {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  5001
+    uint32_t ch, smpl, buffer_size, i;
+    uint64_t output_size;
+    int32_t *input[NUM_CHANNELS];
+    uint8_t *data;
+    struct AADEncoder *encoder;
+    struct AADEncodeParameter enc_param;
+    const struct {
+      uint16_t num_channels;
+      uint8_t bits_per_sample;
+      uint32_t max_block_size;
+      AADChannelProcessMethod ch_process_method;
+    } param_list[] = {
+      { 1, 4, 128, AAD_CH_PROCESS_METHOD_NONE },
+      { 1, 3, 100, AAD_CH_PROCESS_METHOD_NONE },
+      { 1, 2, 64,  AAD_CH_PROCESS_METHOD_NONE },
+      { 2, 4, 256, AAD_CH_PROCESS_METHOD_MS },
+      { 2, 3, 128, AAD_CH_PROCESS_METHOD_MS },
+      { 2, 2, 512, AAD_CH_PROCESS_METHOD_NONE },
+    };
+
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[ch][smpl] = (int32_t)(INT16_MAX * sin(0.01 * (ch + 1) * smpl));
+      }
+    }
+    buffer_size = sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES;
+    data = (uint8_t *)malloc(buffer_size);
+
+    for (i = 0; i < sizeof(param_list) / sizeof(param_list[0]); i++) {
+      enc_param.num_channels      = param_list[i].num_channels;
+      enc_param.sampling_rate     = 8000;
+      enc_param.bits_per_sample   = param_list[i].bits_per_sample;
+      enc_param.max_block_size    = param_list[i].max_block_size;
+      enc_param.ch_process_method = param_list[i].ch_process_method;
+      enc_param.num_encode_trials = 1;
+      enc_param.search_method = AAD_SEARCH_METHOD_SEQUENTIAL;
+      encoder = AADEncoder_Create(enc_param.max_block_size, NULL, 0);
+      Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &enc_param), AAD_APIRESULT_OK);
+      Test_AssertEqual(AADEncoder_EncodeWhole(encoder,
+            (const int32_t *const *)input, NUM_SAMPLES, data, buffer_size, &output_size), AAD_APIRESULT_OK);
+
+      Test_AssertEqual(AADDecoderTest_CheckStreamDecode(data, output_size, 1, 3), 1);
+      Test_AssertEqual(AADDecoderTest_CheckStreamDecode(data, output_size, 5, 64), 1);
+      Test_AssertEqual(AADDecoderTest_CheckStreamDecode(data, output_size, 333, NUM_SAMPLES), 1);
+
+      AADEncoder_Destroy(encoder);
+    }
+
+    free(data);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      free(input[ch]);
+    }
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+  }
+}
+
+/* 範囲デコードと一括デコードの結果が一致するか確認 一致時は1を返す */
+static uint8_t AADDecoderTest_CheckRangeDecode(const uint8_t *data, uint32_t data_size)
+{
+  uint32_t ch, smpl, i, j;
+  uint8_t is_ok;
+  struct AADDecoder *decoder;
+  struct AADHeaderInfo header;
+  int32_t *reference[AAD_MAX_NUM_CHANNELS];
+  int32_t *decoded[AAD_MAX_NUM_CHANNELS];
+  uint32_t start_list[9];
+  const uint64_t length_list[] = { 1, 3, 4, 5, 9, 100, 1000, UINT32_MAX, UINT64_MAX };
+
+  assert(data != NULL);
+
+  if (AADDecoder_DecodeHeader(data, data_size, &header) != AAD_APIRESULT_OK) {
+    return 0;
+  }
+
+  /* 開始位置はブロック境界の前後と末尾を中心に選ぶ */
+  start_list[0] = 0;
+  start_list[1] = 1;
+  start_list[2] = AAD_FILTER_ORDER;
+  start_list[3] = AAD_FILTER_ORDER + 1;
+  start_list[4] = header.num_samples_per_block - 1;
+  start_list[5] = header.num_samples_per_block;
+  start_list[6] = header.num_samples_per_block + 5;
+  start_list[7] = header.num_samples / 2;
+  start_list[8] = header.num_samples - 1;
+
+  decoder = AADDecoder_Create(NULL, 0);
+  for (ch = 0; ch < header.num_channels; ch++) {
+    reference[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+    decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+  }
+
+  /* 一括デコード結果をリファレンスとする */
+  if (AADDecoder_DecodeWhole(decoder,
+        data, data_size, reference, header.num_channels, header.num_samples) != AAD_APIRESULT_OK) {
+    is_ok = 0;
+    goto CHECK_END;
+  }
+
+  is_ok = 1;
+  for (i = 0; i < sizeof(start_list) / sizeof(start_list[0]); i++) {
+    for (j = 0; j < sizeof(length_list) / sizeof(length_list[0]); j++) {
+      uint64_t num_decoded, num_expected;
+      if (start_list[i] >= header.num_samples) {
+        continue;
+      }
+      num_expected = AAD_MIN_VAL(length_list[j], header.num_samples - start_list[i]);
+      if (AADDecoder_DecodeRange(decoder, data, data_size, start_list[i], length_list[j],
+            decoded, header.num_channels, header.num_samples, &num_decoded) != AAD_APIRESULT_OK) {
+        is_ok = 0;
+        goto CHECK_END;
+      }
+      if (num_decoded != num_expected) {
+        is_ok = 0;
+        goto CHECK_END;
+      }
+      for (ch = 0; ch < header.num_channels; ch++) {
+        for (smpl = 0; smpl < num_expected; smpl++) {
+          if (decoded[ch][smpl] != reference[ch][start_list[i] + smpl]) {
+            is_ok = 0;
+            goto CHECK_END;
+          }
+        }
+      }
+    }
+  }
+
+CHECK_END:
+  for (ch = 0; ch < header.num_channels; ch++) {
+    free(reference[ch]);
+    free(decoded[ch]);
+  }
+  AADDecoder_Destroy(decoder);
+
+  return is_ok;
+}
+
+/* 範囲デコードテスト */
+static void AADDecoderTest_DecodeRangeTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* シーク位置計算 */
+  {
+    struct AADHeaderInfo header;
+    uint64_t offset, block_start;
+
+    header.format_version = AAD_FORMAT_VERSION;
+    header.codec_version = AAD_CODEC_VERSION;
+    header.num_channels = 2;
+    header.sampling_rate = 8000;
+    header.bits_per_sample = 4;
+    header.num_samples = 1000;
+    header.block_size = 64;
+    header.num_samples_per_block = 4 + 2 * (64 - AAD_BLOCK_HEADER_SIZE(2)) / 2;
+    header.ch_process_method = AAD_CH_PROCESS_METHOD_MS;
+
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(NULL, 0, &offset, &block_start), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, 0, NULL, &block_start), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, 0, &offset, NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, 1000, &offset, &block_start), AAD_APIRESULT_INVALID_ARGUMENT);
+
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, 0, &offset, &block_start), AAD_APIRESULT_OK);
+    Test_AssertEqual(offset, AAD_HEADER_SIZE);
+    Test_AssertEqual(block_start, 0);
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, header.num_samples_per_block - 1, &offset, &block_start), AAD_APIRESULT_OK);
+    Test_AssertEqual(offset, AAD_HEADER_SIZE);
+    Test_AssertEqual(block_start, 0);
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, 3 * header.num_samples_per_block + 1, &offset, &block_start), AAD_APIRESULT_OK);
+    Test_AssertEqual(offset, AAD_HEADER_SIZE + 3 * header.block_size);
+    Test_AssertEqual(block_start, 3 * header.num_samples_per_block);
+
+    /* 32bitを超える位置 */
+    header.num_samples = (uint64_t)1 << 48;
+    Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, ((uint64_t)1 << 36) * header.num_samples_per_block + 1, &offset, &block_start), AAD_APIRESULT_OK);
+    Test_AssertEqual(offset, AAD_HEADER_SIZE + ((uint64_t)1 << 36) * header.block_size);
+    Test_AssertEqual(block_start, ((uint64_t)1 << 36) * header.num_samples_per_block);
+  }
+
+  /* 引数が不正 */
+  {
+    FILE *fp;
+    struct stat fstat;
+    uint8_t *data;
+    uint32_t data_size;
+    uint64_t num_decoded;
+    int32_t buf[2][16];
+    int32_t *buffer[AAD_MAX_NUM_CHANNELS];
+    struct AADDecoder *decoder = AADDecoder_Create(NULL, 0);
+
+    buffer[0] = buf[0]; buffer[1] = buf[1];
+
+    stat("sin300Hz.aad", &fstat);
+    data_size = (uint32_t)fstat.st_size;
+    data = (uint8_t *)malloc(data_size);
+    fp = fopen("sin300Hz.aad", "rb");
+    assert(fp != NULL);
+    fread(data, sizeof(uint8_t), data_size, fp);
+    fclose(fp);
+
+    Test_AssertEqual(AADDecoder_DecodeRange(NULL, data, data_size, 0, 16, buffer, 2, 16, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeRange(decoder, NULL, data_size, 0, 16, buffer, 2, 16, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, data_size, 0, 16, NULL, 2, 16, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, data_size, 0, 16, buffer, 2, 16, NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+
+    /* 範囲外の開始位置 */
+    Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, data_size, UINT32_MAX, 16, buffer, 2, 16, &num_decoded), AAD_APIRESULT_INVALID_ARGUMENT);
+
+    /* バッファ不足 */
+    Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, data_size, 0, 17, buffer, 2, 16, &num_decoded), AAD_APIRESULT_INSUFFICIENT_BUFFER);
+    Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, data_size, 0, 16, buffer, 1, 16, &num_decoded), AAD_APIRESULT_INSUFFICIENT_BUFFER);
+
+    /* データ不足 */
+    Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, AAD_HEADER_SIZE, 0, 16, buffer, 2, 16, &num_decoded), AAD_APIRESULT_INSUFFICIENT_DATA);
+
+    free(data);
+    AADDecoder_Destroy(decoder);
+  }
+
+  /* ファイルをデコードし一括デコードと一致するか */
+  {
+    const char *test_files[] = { "sin300Hz_mono.aad", "sin300Hz.aad" };
+    uint32_t i;
+
+    for (i = 0; i < sizeof(test_files) / sizeof(test_files[0]); i++) {
+      FILE *fp;
+      struct stat fstat;
+      uint8_t *data;
+      uint32_t data_size;
+
+      stat(test_files[i], &fstat);
+      data_size = (uint32_t)fstat.st_size;
+      data = (uint8_t *)malloc(data_size);
+      fp = fopen(test_files[i], "rb");
+      assert(fp != NULL);
+      fread(data, sizeof(uint8_t), data_size, fp);
+      fclose(fp);
+
+      Test_AssertEqual(AADDecoderTest_CheckRangeDecode(data, data_size), 1);
+
+      free(data);
+    }
+  }
+
+  /* 様々なパラメータで生成したデータ */
+  {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  5001
+    uint32_t ch, smpl, buffer_size, i;
+    uint64_t output_size;
+    int32_t *input[NUM_CHANNELS];
+    uint8_t *data;
+    struct AADEncoder *encoder;
+    struct AADEncodeParameter enc_param;
+    const struct {
+      uint16_t num_channels;
+      uint8_t bits_per_sample;
+      uint32_t max_block_size;
+      AADChannelProcessMethod ch_process_method;
+    } param_list[] = {
+      { 1, 4, 128, AAD_CH_PROCESS_METHOD_NONE },
+      { 1, 3, 100, AAD_CH_PROCESS_METHOD_NONE },
+      { 1, 2, 64,  AAD_CH_PROCESS_METHOD_NONE },
+      { 2, 4, 256, AAD_CH_PROCESS_METHOD_MS },
+      { 2, 3, 128, AAD_CH_PROCESS_METHOD_MS },
+      { 2, 2, 512, AAD_CH_PROCESS_METHOD_NONE },
+    };
+
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[ch][smpl] = (int32_t)(INT16_MAX * sin(0.01 * (ch + 1) * smpl));
+      }
+    }
+    buffer_size = sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES;
+    data = (uint8_t *)malloc(buffer_size);
+
+    for (i = 0; i < sizeof(param_list) / sizeof(param_list[0]); i++) {
+      enc_param.num_channels      = param_list[i].num_channels;
+      enc_param.sampling_rate     = 8000;
+      enc_param.bits_per_sample   = param_list[i].bits_per_sample;
+      enc_param.max_block_size    = param_list[i].max_block_size;
+      enc_param.ch_process_method = param_list[i].ch_process_method;
+      enc_param.num_encode_trials = 1;
+      enc_param.search_method = AAD_SEARCH_METHOD_SEQUENTIAL;
+      encoder = AADEncoder_Create(enc_param.max_block_size, NULL, 0);
+      Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &enc_param), AAD_APIRESULT_OK);
+      Test_AssertEqual(AADEncoder_EncodeWhole(encoder,
+            (const int32_t *const *)input, NUM_SAMPLES, data, buffer_size, &output_size), AAD_APIRESULT_OK);
+
+      Test_AssertEqual(AADDecoderTest_CheckRangeDecode(data, output_size), 1);
+
+      AADEncoder_Destroy(encoder);
+    }
+
+    free(data);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      free(input[ch]);
+    }
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+  }
+}
+
+/* 複数ブロックデコードが単一ブロックデコードの繰り返しと一致するか確認 一致時は1を返す */
+static uint8_t AADDecoderTest_CheckDecodeBlocks(const uint8_t *data, uint32_t data_size)
+{
+  uint32_t ch, smpl, progress, read_offset, num_blocks, num_decoded;
+  uint64_t num_blocks_decoded;
+  uint8_t is_ok;
+  struct AADDecoder *decoder;
+  struct AADHeaderInfo header;
+  int32_t *reference[AAD_MAX_NUM_CHANNELS];
+  int32_t *decoded[AAD_MAX_NUM_CHANNELS];
+  int32_t *buffer_ptr[AAD_MAX_NUM_CHANNELS];
+
+  assert(data != NULL);
+
+  if (AADDecoder_DecodeHeader(data, data_size, &header) != AAD_APIRESULT_OK) {
+    return 0;
+  }
+
+  decoder = AADDecoder_Create(NULL, 0);
+  for (ch = 0; ch < header.num_channels; ch++) {
+    reference[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+    decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+  }
+
+  /* 単一ブロックデコードの繰り返しをリファレンスとする */
+  is_ok = 0;
+  if (AADDecoder_SetHeader(decoder, &header) != AAD_APIRESULT_OK) {
+    goto CHECK_END;
+  }
+  progress = 0;
+  read_offset = AAD_HEADER_SIZE;
+  while ((progress < header.num_samples) && (read_offset < data_size)) {
+    for (ch = 0; ch < header.num_channels; ch++) {
+      buffer_ptr[ch] = &reference[ch][progress];
+    }
+    if (AADDecoder_DecodeBlock(decoder, &data[read_offset], AAD_MIN_VAL(header.block_size, data_size - read_offset),
+          buffer_ptr, header.num_channels, header.num_samples - progress, &num_decoded) != AAD_APIRESULT_OK) {
+      goto CHECK_END;
+    }
+    progress += num_decoded;
+    read_offset += header.block_size;
+  }
+
+  /* 複数ブロックをまとめてデコード */
+  num_blocks = (header.num_samples + header.num_samples_per_block - 1) / header.num_samples_per_block;
+  if (AADDecoder_DecodeBlocks(decoder, &data[AAD_HEADER_SIZE], data_size - AAD_HEADER_SIZE, num_blocks,
+        decoded, header.num_channels, header.num_samples, &num_blocks_decoded) != AAD_APIRESULT_OK) {
+    goto CHECK_END;
+  }
+  if (num_blocks_decoded != progress) {
+    goto CHECK_END;
+  }
+
+  /* 一致確認 */
+  is_ok = 1;
+  for (ch = 0; ch < header.num_channels; ch++) {
+    for (smpl = 0; smpl < header.num_samples; smpl++) {
+      if (decoded[ch][smpl] != reference[ch][smpl]) {
+        is_ok = 0;
+        goto CHECK_END;
+      }
+    }
+  }
+
+CHECK_END:
+  for (ch = 0; ch < header.num_channels; ch++) {
+    free(reference[ch]);
+    free(decoded[ch]);
+  }
+  AADDecoder_Destroy(decoder);
+
+  return is_ok;
+}
+
+/* 複数ブロックデコードテスト */
+static void AADDecoderTest_DecodeBlocksTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+#if AAD_DECODER_USE_AVX2
+  /* 不整合なヘッダではAVX2を使わない */
+  if (__builtin_cpu_supports("avx2")) {
+    struct AADHeaderInfo header;
+    header.num_channels = 2;
+    header.bits_per_sample = 4;
+    header.block_size = 64;
+    header.num_samples_per_block = 4 + 2 * (64 - AAD_BLOCK_HEADER_SIZE(2)) / 2;
+    Test_AssertEqual(AADDecoder_CanDecodeBlocksAVX2(&header), 1);
+    header.num_samples_per_block += 2;
+    Test_AssertEqual(AADDecoder_CanDecodeBlocksAVX2(&header), 0);
+    header.num_samples_per_block = 3;
+    Test_AssertEqual(AADDecoder_CanDecodeBlocksAVX2(&header), 0);
+  }
+#endif
+
+  /* 様々なパラメータ・信号で生成したデータ */
+  {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  20001
+    uint32_t ch, smpl, buffer_size, i;
+    uint64_t output_size;
+    int32_t *input[NUM_CHANNELS];
+    uint8_t *data;
+    struct AADEncoder *encoder;
+    struct AADEncodeParameter enc_param;
+    const struct {
+      uint16_t num_channels;
+      uint8_t bits_per_sample;
+      uint32_t max_block_size;
+      AADChannelProcessMethod ch_process_method;
+    } param_list[] = {
+      { 1, 4, 64,   AAD_CH_PROCESS_METHOD_NONE },
+      { 1, 3, 100,  AAD_CH_PROCESS_METHOD_NONE },
+      { 1, 2, 1024, AAD_CH_PROCESS_METHOD_NONE },
+      { 2, 4, 256,  AAD_CH_PROCESS_METHOD_MS },
+      { 2, 3, 128,  AAD_CH_PROCESS_METHOD_MS },
+      { 2, 2, 512,  AAD_CH_PROCESS_METHOD_NONE },
+      { 2, 4, 40,   AAD_CH_PROCESS_METHOD_NONE },
+    };
+
+    /* 振幅が大きくクリップの起こる信号とノイズを混ぜる */
+    srand(0);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        double val = 1.5 * sin(0.003 * (ch + 1) * smpl) + 0.3 * ((double)rand() / RAND_MAX - 0.5);
+        input[ch][smpl] = (int32_t)(INT16_MAX * AAD_INNER_VAL(val, -1.0, 1.0));
+      }
+    }
+    buffer_size = sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES;
+    data = (uint8_t *)malloc(buffer_size);
+
+    for (i = 0; i < sizeof(param_list) / sizeof(param_list[0]); i++) {
+      enc_param.num_channels      = param_list[i].num_channels;
+      enc_param.sampling_rate     = 8000;
+      enc_param.bits_per_sample   = param_list[i].bits_per_sample;
+      enc_param.max_block_size    = param_list[i].max_block_size;
+      enc_param.ch_process_method = param_list[i].ch_process_method;
+      enc_param.num_encode_trials = 1;
+      enc_param.search_method = AAD_SEARCH_METHOD_SEQUENTIAL;
+      encoder = AADEncoder_Create(enc_param.max_block_size, NULL, 0);
+      Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &enc_param), AAD_APIRESULT_OK);
+      Test_AssertEqual(AADEncoder_EncodeWhole(encoder,
+            (const int32_t *const *)input, NUM_SAMPLES, data, buffer_size, &output_size), AAD_APIRESULT_OK);
+
+      Test_AssertEqual(AADDecoderTest_CheckDecodeBlocks(data, output_size), 1);
+
+      AADEncoder_Destroy(encoder);
+    }
+
+    free(data);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      free(input[ch]);
+    }
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+  }
+}
+
+/* 総サンプル数が不明なデータのデコードテスト */
+static void AADDecoderTest_DecodeUnknownLengthTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 引数が不正 */
+  {
+    struct AADHeaderInfo header;
+    uint64_t num_samples;
+
+    header.format_version = AAD_FORMAT_VERSION;
+    header.codec_version = AAD_CODEC_VERSION;
+    header.num_channels = 1;
+    header.sampling_rate = 8000;
+    header.bits_per_sample = 4;
+    header.num_samples = AAD_NUM_SAMPLES_UNKNOWN;
+    header.block_size = 64;
+    header.num_samples_per_block = 4 + 2 * (64 - AAD_BLOCK_HEADER_SIZE(1));
+    header.ch_process_method = AAD_CH_PROCESS_METHOD_NONE;
+
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(NULL, AAD_HEADER_SIZE, &num_samples), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE, NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE - 1, &num_samples), AAD_APIRESULT_INSUFFICIENT_DATA);
+
+    /* ブロックヘッダ・データ単位が揃った分だけ数える */
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE, &num_samples), AAD_APIRESULT_OK);
+    Test_AssertEqual(num_samples, 0);
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE + AAD_BLOCK_HEADER_SIZE(1) - 1, &num_samples), AAD_APIRESULT_OK);
+    Test_AssertEqual(num_samples, 0);
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE + AAD_BLOCK_HEADER_SIZE(1) + 3, &num_samples), AAD_APIRESULT_OK);
+    Test_AssertEqual(num_samples, AAD_FILTER_ORDER + 6);
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE + 2 * 64 + 1, &num_samples), AAD_APIRESULT_OK);
+    Test_AssertEqual(num_samples, 2 * header.num_samples_per_block);
+
+    /* 総サンプル数が分かっていればそのまま */
+    header.num_samples = 1000;
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE, &num_samples), AAD_APIRESULT_OK);
+    Test_AssertEqual(num_samples, 1000);
+
+    /* 不正なヘッダ */
+    header.num_samples = 0;
+    Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, AAD_HEADER_SIZE, &num_samples), AAD_APIRESULT_INVALID_FORMAT);
+  }
+
+  /* ストリーミングエンコードの開始時のヘッダのままでデコードできるか */
+  {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  20001
+    uint32_t ch, smpl, i, buffer_size, output_size, header_size;
+    uint64_t num_samples, num_decoded, offset, block_start;
+    int32_t *input[NUM_CHANNELS], *reference[NUM_CHANNELS], *decoded[NUM_CHANNELS];
+    uint8_t *data, header_data[AAD_HEADER_SIZE];
+    uint8_t is_ok;
+    struct AADEncoder *encoder;
+    struct AADDecoder *decoder;
+    struct AADEncodeParameter enc_param;
+    struct AADHeaderInfo header;
+    const struct {
+      uint16_t num_channels;
+      uint8_t bits_per_sample;
+      uint32_t max_block_size;
+      AADChannelProcessMethod ch_process_method;
+    } param_list[] = {
+      { 1, 4, 64,   AAD_CH_PROCESS_METHOD_NONE },
+      { 1, 3, 100,  AAD_CH_PROCESS_METHOD_NONE },
+      { 2, 2, 512,  AAD_CH_PROCESS_METHOD_NONE },
+      { 2, 4, 256,  AAD_CH_PROCESS_METHOD_MS },
+    };
+
+    srand(0);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      reference[ch] = (int32_t *)malloc(sizeof(int32_t) * (NUM_SAMPLES + 8));
+      decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * (NUM_SAMPLES + 8));
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        double val = sin(0.003 * (ch + 1) * smpl) + 0.1 * ((double)rand() / RAND_MAX - 0.5);
+        input[ch][smpl] = (int32_t)(INT16_MAX * AAD_INNER_VAL(val, -1.0, 1.0));
+      }
+    }
+    buffer_size = sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES;
+    data = (uint8_t *)malloc(buffer_size);
+    decoder = AADDecoder_Create(NULL, 0);
+
+    for (i = 0; i < sizeof(param_list) / sizeof(param_list[0]); i++) {
+      enc_param.num_channels      = param_list[i].num_channels;
+      enc_param.sampling_rate     = 8000;
+      enc_param.bits_per_sample   = param_list[i].bits_per_sample;
+      enc_param.max_block_size    = param_list[i].max_block_size;
+      enc_param.ch_process_method = param_list[i].ch_process_method;
+      enc_param.num_encode_trials = 1;
+      enc_param.search_method = AAD_SEARCH_METHOD_SEQUENTIAL;
+      encoder = AADEncoder_Create(enc_param.max_block_size, NULL, 0);
+      Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &enc_param), AAD_APIRESULT_OK);
+
+      /* ヘッダを書き換えずにストリーミングエンコード */
+      Test_AssertEqual(AADEncoder_BeginEncodeStream(encoder, data, buffer_size, &header_size), AAD_APIRESULT_OK);
+      Test_AssertEqual(AADEncoder_EncodeStream(encoder, (const int32_t *const *)input, NUM_SAMPLES,
+            &data[header_size], buffer_size - header_size, &output_size), AAD_APIRESULT_OK);
+      header_size += output_size;
+      Test_AssertEqual(AADEncoder_FinishEncodeStream(encoder, &data[header_size], buffer_size - header_size, &output_size,
+            header_data, sizeof(header_data)), AAD_APIRESULT_OK);
+      header_size += output_size;
+
+      Test_AssertEqual(AADDecoder_DecodeHeader(data, header_size, &header), AAD_APIRESULT_OK);
+      Test_AssertEqual(header.num_samples, AAD_NUM_SAMPLES_UNKNOWN);
+
+      /* 最終ブロックはデータ単位に切り上げたサンプル数になる */
+      Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, header_size, &num_samples), AAD_APIRESULT_OK);
+      Test_AssertCondition((num_samples >= NUM_SAMPLES) && (num_samples < NUM_SAMPLES + 8));
+
+      /* 総サンプル数を確定したヘッダでのデコード結果と一致するか */
+      Test_AssertEqual(AADDecoder_DecodeWhole(decoder, data, header_size,
+            decoded, NUM_CHANNELS, num_samples), AAD_APIRESULT_OK);
+      memcpy(data, header_data, AAD_HEADER_SIZE);
+      Test_AssertEqual(AADDecoder_DecodeWhole(decoder, data, header_size,
+            reference, NUM_CHANNELS, NUM_SAMPLES), AAD_APIRESULT_OK);
+      is_ok = 1;
+      for (ch = 0; ch < param_list[i].num_channels; ch++) {
+        if (memcmp(decoded[ch], reference[ch], sizeof(int32_t) * NUM_SAMPLES) != 0) {
+          is_ok = 0;
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+
+      /* 途中で切れたデータはあるところまでデコード */
+      ByteArray_WriteUint64BE(&data[14], AAD_NUM_SAMPLES_UNKNOWN);
+      Test_AssertEqual(AADDecoder_CalculateNumSamples(&header, header_size / 2, &num_samples), AAD_APIRESULT_OK);
+      Test_AssertCondition((num_samples > 0) && (num_samples < NUM_SAMPLES));
+      Test_AssertEqual(AADDecoder_DecodeWholeParallel(decoder, data, header_size / 2,
+            decoded, NUM_CHANNELS, num_samples, 4), AAD_APIRESULT_OK);
+      is_ok = 1;
+      for (ch = 0; ch < param_list[i].num_channels; ch++) {
+        if (memcmp(decoded[ch], reference[ch], sizeof(int32_t) * num_samples) != 0) {
+          is_ok = 0;
+        }
+      }
+      Test_AssertEqual(is_ok, 1);
+
+      /* データの末尾を超える範囲 */
+      Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, header_size / 2, num_samples - 1, 100,
+            decoded, NUM_CHANNELS, 100, &num_decoded), AAD_APIRESULT_OK);
+      Test_AssertEqual(num_decoded, 1);
+      Test_AssertEqual(decoded[0][0], reference[0][num_samples - 1]);
+      Test_AssertEqual(AADDecoder_DecodeRange(decoder, data, header_size / 2, num_samples, 100,
+            decoded, NUM_CHANNELS, 100, &num_decoded), AAD_APIRESULT_INSUFFICIENT_DATA);
+
+      /* シーク位置はサンプル数によらず計算できる */
+      Test_AssertEqual(AADDecoder_CalculateSeekPosition(&header, (uint64_t)1 << 40, &offset, &block_start), AAD_APIRESULT_OK);
+      Test_AssertEqual(block_start % header.num_samples_per_block, 0);
+
+      /* ストリーミングデコードはデータがある限り続く */
+      {
+        uint32_t consumed, num_stream_decoded;
+        Test_AssertEqual(AADDecoder_BeginDecodeStream(decoder), AAD_APIRESULT_OK);
+        Test_AssertEqual(AADDecoder_DecodeStream(decoder, data, header_size / 2, &consumed,
+              decoded, NUM_CHANNELS, NUM_SAMPLES + 8, &num_stream_decoded), AAD_APIRESULT_OK);
+        Test_AssertEqual(consumed, header_size / 2);
+        Test_AssertEqual(num_stream_decoded, num_samples);
+        is_ok = 1;
+        for (ch = 0; ch < param_list[i].num_channels; ch++) {
+          if (memcmp(decoded[ch], reference[ch], sizeof(int32_t) * num_samples) != 0) {
+            is_ok = 0;
+          }
+        }
+        Test_AssertEqual(is_ok, 1);
+      }
+
+      AADEncoder_Destroy(encoder);
+    }
+
+    AADDecoder_Destroy(decoder);
+    free(data);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+      free(input[ch]);
+      free(reference[ch]);
+      free(decoded[ch]);
+    }
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+  }
+}
+
+/* 符号展開テスト */
+static void AADDecoderTest_UnpackCodesTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 既知のデータ単位の展開 */
+  {
+    const uint8_t data[3] = { 0x12, 0x34, 0x56 };
+    uint8_t codes[12];
+
+    AADDecoder_UnpackCodes(data, 1, 4, codes);
+    Test_AssertCondition((codes[0] == 0x1) && (codes[1] == 0x2));
+
+    /* 0x123456 = 000 100 100 011 010 001 010 110 */
+    AADDecoder_UnpackCodes(data, 3, 3, codes);
+    Test_AssertCondition((codes[0] == 0) && (codes[1] == 4) && (codes[2] == 4) && (codes[3] == 3)
+        && (codes[4] == 2) && (codes[5] == 1) && (codes[6] == 2) && (codes[7] == 6));
+
+    /* 0x12 = 00 01 00 10 */
+    AADDecoder_UnpackCodes(data, 1, 2, codes);
+    Test_AssertCondition((codes[0] == 0) && (codes[1] == 1) && (codes[2] == 0) && (codes[3] == 2));
+  }
+
+  /* 逐次処理との一致確認 */
+  {
+#define MAX_DATA_SIZE 99
+    uint8_t data[MAX_DATA_SIZE];
+    uint8_t codes[(MAX_DATA_SIZE * 8) / 2], ref_codes[(MAX_DATA_SIZE * 8) / 2];
+    uint32_t i, bits, data_size;
+    uint8_t is_ok;
+
+    for (i = 0; i < MAX_DATA_SIZE; i++) {
+      data[i] = (uint8_t)((i * 149 + 37) & 0xFF);
+    }
+
+    is_ok = 1;
+    for (bits = 2; bits <= 4; bits++) {
+      /* 8符号単位になるサイズで確認 */
+      for (data_size = 0; data_size <= MAX_DATA_SIZE; data_size += bits) {
+        const uint32_t num_codes = (data_size * 8) / bits;
+        memset(codes, 0xFF, sizeof(codes));
+        AADDecoder_UnpackCodes(data, data_size, (uint8_t)bits, codes);
+        AADDecoder_UnpackCodesScalar(data, data_size, (uint8_t)bits, ref_codes);
+        if (memcmp(codes, ref_codes, num_codes) != 0) {
+          is_ok = 0;
+        }
+        /* 出力範囲外に書き込んでいない */
+        if ((num_codes < sizeof(codes)) && (codes[num_codes] != 0xFF)) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+#undef MAX_DATA_SIZE
+  }
+}
+
 void AADDecoderTest_Setup(void);
 
 static int AADDecoderTest_Initialize(void *obj)
@@ -128,52 +1170,52 @@ static void AADDecoderTest_DecodeHeaderTest(void *obj)
     /* 異常なサンプル数 */
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint32BE(&data[14], 0);
+    ByteArray_WriteUint64BE(&data[14], 0);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
 
     /* 異常なサンプリングレート */
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint32BE(&data[18], 0);
+    ByteArray_WriteUint32BE(&data[22], 0);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
 
     /* 異常なサンプルあたりビット数 */
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint16BE(&data[22], 0);
+    ByteArray_WriteUint16BE(&data[26], 0);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint16BE(&data[22], AAD_MAX_BITS_PER_SAMPLE + 1);
+    ByteArray_WriteUint16BE(&data[26], AAD_MAX_BITS_PER_SAMPLE + 1);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
 
     /* 異常なブロックサイズ */
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint16BE(&data[24], 0);
+    ByteArray_WriteUint32BE(&data[28], 0);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint16BE(&data[24], AAD_BLOCK_HEADER_SIZE(header.num_channels) - 1);
+    ByteArray_WriteUint32BE(&data[28], AAD_BLOCK_HEADER_SIZE(header.num_channels) - 1);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
 
     /* 異常なブロックあたりサンプル数 */
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint32BE(&data[26], 0);
+    ByteArray_WriteUint32BE(&data[32], 0);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
 
     /* 異常なチャンネル処理法 */
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
-    ByteArray_WriteUint8(&data[30], AAD_CH_PROCESS_METHOD_INVALID);
+    ByteArray_WriteUint8(&data[36], AAD_CH_PROCESS_METHOD_INVALID);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
 
@@ -181,7 +1223,7 @@ static void AADDecoderTest_DecodeHeaderTest(void *obj)
     memcpy(data, valid_data, sizeof(valid_data));
     memset(&getheader, 0xCD, sizeof(getheader));
     ByteArray_WriteUint16BE(&data[12], 1);
-    ByteArray_WriteUint8(&data[30], AAD_CH_PROCESS_METHOD_MS);
+    ByteArray_WriteUint8(&data[36], AAD_CH_PROCESS_METHOD_MS);
     Test_AssertEqual(AADDecoder_DecodeHeader(data, sizeof(data), &getheader), AAD_APIRESULT_OK);
     Test_AssertEqual(AADDecoder_CheckHeaderFormat(&getheader), AAD_ERROR_INVALID_FORMAT);
   }
@@ -347,4 +1389,10 @@ void AADDecoderTest_Setup(void)
   Test_AddTest(suite, AADDecoderTest_DecodeHeaderTest);
   Test_AddTest(suite, AADDecoderTest_CreateDestroyTest);
   Test_AddTest(suite, AADDecoderTest_DecodeTest);
+  Test_AddTest(suite, AADDecoderTest_DecodeParallelTest);
+  Test_AddTest(suite, AADDecoderTest_DecodeStreamTest);
+  Test_AddTest(suite, AADDecoderTest_DecodeRangeTest);
+  Test_AddTest(suite, AADDecoderTest_DecodeBlocksTest);
+  Test_AddTest(suite, AADDecoderTest_DecodeUnknownLengthTest);
+  Test_AddTest(suite, AADDecoderTest_UnpackCodesTest);
 }
@@ -74,7 +74,8 @@ static uint8_t AADEncodeDecodeTest_EncodeDecodeCheckForPcmData(
     double rms_epsilon)
 {
   int32_t *decoded[AAD_MAX_NUM_CHANNELS];
-  uint32_t ch, smpl, buffer_size, output_size;
+  uint32_t ch, smpl, buffer_size;
+  uint64_t output_size;
   uint8_t *buffer;
   double rms_error;
   uint8_t is_ok;
@@ -175,7 +176,8 @@ static uint8_t AADEncodeDecodeTest_EncodeDecodeCheckForWavFile(
   int32_t *input[AAD_MAX_NUM_CHANNELS];
   int32_t *decoded[AAD_MAX_NUM_CHANNELS];
   uint8_t is_ok;
-  uint32_t ch, smpl, buffer_size, output_size;
+  uint32_t ch, smpl, buffer_size;
+  uint64_t output_size;
   uint32_t num_channels, num_samples;
   uint8_t *buffer;
   double rms_error;
@@ -219,6 +221,7 @@ static uint8_t AADEncodeDecodeTest_EncodeDecodeCheckForWavFile(
   enc_param.max_block_size    = block_size;
   enc_param.ch_process_method = ch_process_method;
   enc_param.num_encode_trials = num_encode_trials;
+  enc_param.search_method = AAD_SEARCH_METHOD_SEQUENTIAL;
   if (AADEncoder_SetEncodeParameter(encoder, &enc_param) != AAD_APIRESULT_OK) {
     is_ok = 0;
     goto CHECK_END;
@@ -337,6 +340,10 @@ static void AADEncodeDecodeTest_EncodeDecodeTest(void *obj)
       { MAX_NUM_SAMPLES, { 1, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_NONE, 1 }, 8.0e-2 },
       { MAX_NUM_SAMPLES, { 2, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_NONE, 1 }, 8.0e-2 },
       { MAX_NUM_SAMPLES, { 2, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_MS,   1 }, 8.0e-2 },
+      { MAX_NUM_SAMPLES, { 1, 8000, 4,  128, AAD_CH_PROCESS_METHOD_NONE, 4, AAD_SEARCH_METHOD_INDEPENDENT }, 5.0e-2 },
+      { MAX_NUM_SAMPLES, { 2, 8000, 4,  128, AAD_CH_PROCESS_METHOD_MS,   4, AAD_SEARCH_METHOD_INDEPENDENT }, 5.0e-2 },
+      { MAX_NUM_SAMPLES, { 2, 8000, 3, 1024, AAD_CH_PROCESS_METHOD_NONE, 16, AAD_SEARCH_METHOD_INDEPENDENT }, 6.0e-2 },
+      { MAX_NUM_SAMPLES, { 1, 8000, 2,  128, AAD_CH_PROCESS_METHOD_NONE, 1, AAD_SEARCH_METHOD_INDEPENDENT }, 8.0e-2 },
     };
 
     /* 白色雑音向けテストケースリスト */
@@ -377,6 +384,10 @@ static void AADEncodeDecodeTest_EncodeDecodeTest(void *obj)
       { MAX_NUM_SAMPLES, { 1, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_NONE, 1 }, 2.4e-1 },
       { MAX_NUM_SAMPLES, { 2, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_NONE, 1 }, 2.4e-1 },
       { MAX_NUM_SAMPLES, { 2, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_MS,   1 }, 2.4e-1 },
+      { MAX_NUM_SAMPLES, { 1, 8000, 4,  128, AAD_CH_PROCESS_METHOD_NONE, 4, AAD_SEARCH_METHOD_INDEPENDENT }, 1.0e-1 },
+      { MAX_NUM_SAMPLES, { 2, 8000, 4,  128, AAD_CH_PROCESS_METHOD_MS,   4, AAD_SEARCH_METHOD_INDEPENDENT }, 1.0e-1 },
+      { MAX_NUM_SAMPLES, { 2, 8000, 3, 1024, AAD_CH_PROCESS_METHOD_NONE, 16, AAD_SEARCH_METHOD_INDEPENDENT }, 1.5e-1 },
+      { MAX_NUM_SAMPLES, { 1, 8000, 2,  128, AAD_CH_PROCESS_METHOD_NONE, 1, AAD_SEARCH_METHOD_INDEPENDENT }, 2.4e-1 },
     };
 
     /* ナイキスト振動波向けテストケースリスト */
@@ -417,6 +428,10 @@ static void AADEncodeDecodeTest_EncodeDecodeTest(void *obj)
       { MAX_NUM_SAMPLES, { 1, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_NONE, 1 }, 2.3e-1 },
       { MAX_NUM_SAMPLES, { 2, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_NONE, 1 }, 2.3e-1 },
       { MAX_NUM_SAMPLES, { 2, 8000, 2, 1024, AAD_CH_PROCESS_METHOD_MS,   1 }, 2.3e-1 },
+      { MAX_NUM_SAMPLES, { 1, 8000, 4,  128, AAD_CH_PROCESS_METHOD_NONE, 4, AAD_SEARCH_METHOD_INDEPENDENT }, 1.2e-1 },
+      { MAX_NUM_SAMPLES, { 2, 8000, 4,  128, AAD_CH_PROCESS_METHOD_MS,   4, AAD_SEARCH_METHOD_INDEPENDENT }, 1.2e-1 },
+      { MAX_NUM_SAMPLES, { 2, 8000, 3, 1024, AAD_CH_PROCESS_METHOD_NONE, 16, AAD_SEARCH_METHOD_INDEPENDENT }, 1.6e-1 },
+      { MAX_NUM_SAMPLES, { 1, 8000, 2,  128, AAD_CH_PROCESS_METHOD_NONE, 1, AAD_SEARCH_METHOD_INDEPENDENT }, 2.3e-1 },
     };
 
     /* 出力データの領域割当て */
@@ -636,6 +651,815 @@ static void AADEncodeDecodeTest_EncodeDecodeTest(void *obj)
   }
 }
 
+/* 新規に作成したエンコーダで並列エンコード（num_threadsが0のときは逐次エンコード） */
+static AADApiResult AADEncodeDecodeTest_EncodeByNewEncoder(
+    const int32_t *const *input, uint32_t num_samples, const struct AADEncodeParameter *enc_param,
+    uint8_t *data, uint32_t data_size, uint64_t *output_size,
+    uint32_t num_threads, uint32_t num_warmup_blocks)
+{
+  AADApiResult ret;
+  struct AADEncoder *encoder;
+
+  /* エンコーダの状態はエンコードを跨いで引き継がれるため、毎回作成する */
+  encoder = AADEncoder_Create(enc_param->max_block_size, NULL, 0);
+  if ((ret = AADEncoder_SetEncodeParameter(encoder, enc_param)) == AAD_APIRESULT_OK) {
+    if (num_threads == 0) {
+      ret = AADEncoder_EncodeWhole(encoder, input, num_samples, data, data_size, output_size);
+    } else {
+      ret = AADEncoder_EncodeWholeParallel(encoder, input, num_samples,
+          data, data_size, output_size, num_threads, num_warmup_blocks);
+    }
+  }
+  AADEncoder_Destroy(encoder);
+
+  return ret;
+}
+
+/* 並列エンコードテスト */
+static void AADEncodeDecodeTest_EncodeParallelTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  {
+#define NUM_SAMPLES 10000
+    int32_t *input[AAD_MAX_NUM_CHANNELS], *decoded[AAD_MAX_NUM_CHANNELS];
+    uint8_t *serial_data, *parallel_data;
+    uint32_t ch, smpl, i;
+    uint64_t serial_size, parallel_size;
+    const uint32_t buffer_size = NUM_SAMPLES * AAD_MAX_NUM_CHANNELS * sizeof(int32_t);
+    struct AADEncoder *encoder;
+    struct AADDecoder *decoder;
+    struct AADHeaderInfo header;
+    double rms_error;
+    uint8_t is_ok;
+    const struct AADEncodeParameter enc_param_list[] = {
+      { 1, 8000, 4,  128, AAD_CH_PROCESS_METHOD_NONE, 1 },
+      { 2, 8000, 3,  128, AAD_CH_PROCESS_METHOD_MS,   1 },
+      { 2, 8000, 2,  256, AAD_CH_PROCESS_METHOD_NONE, 2 },
+      { 2, 8000, 3, 1024, AAD_CH_PROCESS_METHOD_MS,   0 },
+      { 2, 8000, 4,  256, AAD_CH_PROCESS_METHOD_NONE, 4, AAD_SEARCH_METHOD_INDEPENDENT },
+    };
+    const uint32_t num_params = sizeof(enc_param_list) / sizeof(enc_param_list[0]);
+
+    /* 入力・出力領域割当て */
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+    }
+    serial_data = (uint8_t *)malloc(buffer_size);
+    parallel_data = (uint8_t *)malloc(buffer_size);
+
+    /* チャンネル間で位相をずらした正弦波 */
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[ch][smpl] = (int32_t)(INT16_MAX * 0.5 * sin(440.0 * (2 * 3.1415 * smpl + ch) / 8000.0));
+      }
+    }
+
+    encoder = AADEncoder_Create(1024, NULL, 0);
+    decoder = AADDecoder_Create(NULL, 0);
+
+    /* 引数が不正 */
+    Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &enc_param_list[0]), AAD_APIRESULT_OK);
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeParallel(NULL, (const int32_t *const *)input, NUM_SAMPLES,
+          parallel_data, buffer_size, &parallel_size, 2, 2),
+        AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeParallel(encoder, NULL, NUM_SAMPLES,
+          parallel_data, buffer_size, &parallel_size, 2, 2),
+        AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeParallel(encoder, (const int32_t *const *)input, NUM_SAMPLES,
+          NULL, buffer_size, &parallel_size, 2, 2),
+        AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeParallel(encoder, (const int32_t *const *)input, NUM_SAMPLES,
+          parallel_data, buffer_size, NULL, 2, 2),
+        AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeParallel(encoder, (const int32_t *const *)input, NUM_SAMPLES,
+          parallel_data, buffer_size, &parallel_size, 0, 2),
+        AAD_APIRESULT_INVALID_ARGUMENT);
+
+    /* 出力領域不足 */
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeParallel(encoder, (const int32_t *const *)input, NUM_SAMPLES,
+          parallel_data, 1024, &parallel_size, 2, 2),
+        AAD_APIRESULT_INSUFFICIENT_BUFFER);
+
+    /* パラメータ未セット */
+    {
+      struct AADEncoder *tmp_encoder = AADEncoder_Create(1024, NULL, 0);
+      Test_AssertEqual(
+          AADEncoder_EncodeWholeParallel(tmp_encoder, (const int32_t *const *)input, NUM_SAMPLES,
+            parallel_data, buffer_size, &parallel_size, 2, 2),
+          AAD_APIRESULT_PARAMETER_NOT_SET);
+      AADEncoder_Destroy(tmp_encoder);
+    }
+
+    /* 逐次エンコード結果と比較 */
+    is_ok = 1;
+    for (i = 0; i < num_params; i++) {
+      const struct AADEncodeParameter *enc_param = &enc_param_list[i];
+      uint32_t num_blocks;
+
+      if (AADEncodeDecodeTest_EncodeByNewEncoder((const int32_t *const *)input, NUM_SAMPLES, enc_param,
+            serial_data, buffer_size, &serial_size, 0, 0) != AAD_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+      if (AADDecoder_DecodeHeader(serial_data, serial_size, &header) != AAD_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+      num_blocks = (NUM_SAMPLES + header.num_samples_per_block - 1) / header.num_samples_per_block;
+
+      /* 1スレッドなら逐次処理と一致 */
+      if ((AADEncodeDecodeTest_EncodeByNewEncoder((const int32_t *const *)input, NUM_SAMPLES, enc_param,
+              parallel_data, buffer_size, &parallel_size, 1, 0) != AAD_APIRESULT_OK)
+          || (parallel_size != serial_size) || (memcmp(serial_data, parallel_data, serial_size) != 0)) {
+        is_ok = 0;
+        break;
+      }
+
+      /* ウォームアップが先頭まで届けば逐次処理と一致 */
+      if ((AADEncodeDecodeTest_EncodeByNewEncoder((const int32_t *const *)input, NUM_SAMPLES, enc_param,
+              parallel_data, buffer_size, &parallel_size, 4, num_blocks) != AAD_APIRESULT_OK)
+          || (parallel_size != serial_size) || (memcmp(serial_data, parallel_data, serial_size) != 0)) {
+        is_ok = 0;
+        break;
+      }
+
+      /* 短いウォームアップでもサイズは一致し、誤差は許容範囲内 */
+      if ((AADEncodeDecodeTest_EncodeByNewEncoder((const int32_t *const *)input, NUM_SAMPLES, enc_param,
+              parallel_data, buffer_size, &parallel_size, 3, 2) != AAD_APIRESULT_OK)
+          || (parallel_size != serial_size)) {
+        is_ok = 0;
+        break;
+      }
+      if (AADDecoder_DecodeWhole(decoder, parallel_data, parallel_size,
+            decoded, enc_param->num_channels, NUM_SAMPLES) != AAD_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+      rms_error = 0.0;
+      for (ch = 0; ch < enc_param->num_channels; ch++) {
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+          double diff = (double)(input[ch][smpl] - decoded[ch][smpl]) / INT16_MAX;
+          rms_error += diff * diff;
+        }
+      }
+      rms_error = sqrt(rms_error / (NUM_SAMPLES * enc_param->num_channels));
+      if (rms_error >= 8.0e-2) {
+        is_ok = 0;
+        break;
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    AADEncoder_Destroy(encoder);
+    AADDecoder_Destroy(decoder);
+    free(serial_data);
+    free(parallel_data);
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      free(input[ch]);
+      free(decoded[ch]);
+    }
+#undef NUM_SAMPLES
+  }
+}
+
+/* サンプルバッファ記述子経由のエンコード・デコードテスト */
+static void AADEncodeDecodeTest_SampleBufferTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 記述子経由の結果が従来のint32_tプレーナ配列と一致するか */
+  {
+#define NUM_SAMPLES 5000
+    int32_t *input[AAD_MAX_NUM_CHANNELS], *decoded[AAD_MAX_NUM_CHANNELS];
+    int16_t *interleaved;
+    float *planar_float;
+    uint8_t *ref_data, *data;
+    uint32_t ch, smpl, i;
+    uint64_t ref_size, output_size;
+    const uint32_t buffer_size = NUM_SAMPLES * AAD_MAX_NUM_CHANNELS * sizeof(int32_t);
+    struct AADEncoder *encoder;
+    struct AADDecoder *decoder;
+    struct AADSampleBuffer buffer;
+    uint8_t is_ok;
+    const struct AADEncodeParameter enc_param_list[] = {
+      { 1, 8000, 4,  128, AAD_CH_PROCESS_METHOD_NONE, 1 },
+      { 2, 8000, 3,  256, AAD_CH_PROCESS_METHOD_MS,   1 },
+      { 2, 8000, 2,  128, AAD_CH_PROCESS_METHOD_NONE, 0 },
+    };
+    const uint32_t num_params = sizeof(enc_param_list) / sizeof(enc_param_list[0]);
+
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[ch][smpl] = (int32_t)(INT16_MAX * 0.5 * sin(440.0 * (2 * 3.1415 * smpl + ch) / 8000.0));
+      }
+    }
+    interleaved = (int16_t *)malloc(sizeof(int16_t) * NUM_SAMPLES * AAD_MAX_NUM_CHANNELS);
+    planar_float = (float *)malloc(sizeof(float) * NUM_SAMPLES * AAD_MAX_NUM_CHANNELS);
+    ref_data = (uint8_t *)malloc(buffer_size);
+    data = (uint8_t *)malloc(buffer_size);
+
+    decoder = AADDecoder_Create(NULL, 0);
+
+    is_ok = 1;
+    for (i = 0; i < num_params; i++) {
+      const struct AADEncodeParameter *enc_param = &enc_param_list[i];
+      const uint32_t num_channels = enc_param->num_channels;
+
+      /* 従来の配列でエンコード・デコード */
+      if ((AADEncodeDecodeTest_EncodeByNewEncoder((const int32_t *const *)input, NUM_SAMPLES, enc_param,
+              ref_data, buffer_size, &ref_size, 0, 0) != AAD_APIRESULT_OK)
+          || (AADDecoder_DecodeWhole(decoder, ref_data, ref_size,
+              decoded, num_channels, NUM_SAMPLES) != AAD_APIRESULT_OK)) {
+        is_ok = 0;
+        break;
+      }
+
+      /* 16bitインターリーブからエンコード */
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        for (ch = 0; ch < num_channels; ch++) {
+          interleaved[smpl * num_channels + ch] = (int16_t)input[ch][smpl];
+        }
+      }
+      memset(&buffer, 0, sizeof(buffer));
+      buffer.format = AAD_SAMPLE_FORMAT_INT16;
+      buffer.layout = AAD_SAMPLE_LAYOUT_INTERLEAVED;
+      buffer.channels[0] = interleaved;
+      buffer.num_channels = num_channels;
+      buffer.num_samples = NUM_SAMPLES;
+      buffer.stride = num_channels;
+      /* エンコーダの状態はエンコードを跨いで引き継がれるため、毎回作成する */
+      encoder = AADEncoder_Create(enc_param->max_block_size, NULL, 0);
+      if ((AADEncoder_SetEncodeParameter(encoder, enc_param) != AAD_APIRESULT_OK)
+          || (AADEncoder_EncodeWholeFromBuffer(encoder, &buffer, data, buffer_size, &output_size) != AAD_APIRESULT_OK)
+          || (output_size != ref_size) || (memcmp(ref_data, data, ref_size) != 0)) {
+        AADEncoder_Destroy(encoder);
+        is_ok = 0;
+        break;
+      }
+      AADEncoder_Destroy(encoder);
+
+      /* 16bitインターリーブへデコード（逐次・並列） */
+      memset(interleaved, 0, sizeof(int16_t) * NUM_SAMPLES * AAD_MAX_NUM_CHANNELS);
+      if (AADDecoder_DecodeWholeToBuffer(decoder, ref_data, ref_size, &buffer) != AAD_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        for (ch = 0; ch < num_channels; ch++) {
+          if (interleaved[smpl * num_channels + ch] != decoded[ch][smpl]) {
+            is_ok = 0;
+          }
+        }
+      }
+      memset(interleaved, 0, sizeof(int16_t) * NUM_SAMPLES * AAD_MAX_NUM_CHANNELS);
+      if (AADDecoder_DecodeWholeParallelToBuffer(decoder, ref_data, ref_size, &buffer, 3) != AAD_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        for (ch = 0; ch < num_channels; ch++) {
+          if (interleaved[smpl * num_channels + ch] != decoded[ch][smpl]) {
+            is_ok = 0;
+          }
+        }
+      }
+
+      /* 浮動小数プレーナで往復 */
+      memset(&buffer, 0, sizeof(buffer));
+      buffer.format = AAD_SAMPLE_FORMAT_FLOAT32;
+      buffer.layout = AAD_SAMPLE_LAYOUT_PLANAR;
+      for (ch = 0; ch < num_channels; ch++) {
+        buffer.channels[ch] = &planar_float[ch * NUM_SAMPLES];
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+          planar_float[ch * NUM_SAMPLES + smpl] = (float)input[ch][smpl] / 32768.0f;
+        }
+      }
+      buffer.num_channels = num_channels;
+      buffer.num_samples = NUM_SAMPLES;
+      buffer.stride = 1;
+      encoder = AADEncoder_Create(enc_param->max_block_size, NULL, 0);
+      if ((AADEncoder_SetEncodeParameter(encoder, enc_param) != AAD_APIRESULT_OK)
+          || (AADEncoder_EncodeWholeParallelFromBuffer(encoder, &buffer,
+              data, buffer_size, &output_size, 2, NUM_SAMPLES) != AAD_APIRESULT_OK)
+          || (output_size != ref_size) || (memcmp(ref_data, data, ref_size) != 0)) {
+        AADEncoder_Destroy(encoder);
+        is_ok = 0;
+        break;
+      }
+      AADEncoder_Destroy(encoder);
+      if (AADDecoder_DecodeWholeToBuffer(decoder, ref_data, ref_size, &buffer) != AAD_APIRESULT_OK) {
+        is_ok = 0;
+        break;
+      }
+      for (ch = 0; ch < num_channels; ch++) {
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+          if (planar_float[ch * NUM_SAMPLES + smpl] != (float)decoded[ch][smpl] / 32768.0f) {
+            is_ok = 0;
+          }
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 不正な記述子 */
+    encoder = AADEncoder_Create(1024, NULL, 0);
+    Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &enc_param_list[1]), AAD_APIRESULT_OK);
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.format = AAD_SAMPLE_FORMAT_INT16;
+    buffer.layout = AAD_SAMPLE_LAYOUT_INTERLEAVED;
+    buffer.channels[0] = interleaved;
+    buffer.num_channels = 1;
+    buffer.num_samples = NUM_SAMPLES;
+    buffer.stride = 1;
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeFromBuffer(encoder, NULL, data, buffer_size, &output_size),
+        AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(
+        AADEncoder_EncodeWholeFromBuffer(encoder, &buffer, data, buffer_size, &output_size),
+        AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(
+        AADEncodeDecodeTest_EncodeByNewEncoder((const int32_t *const *)input, NUM_SAMPLES, &enc_param_list[1],
+          ref_data, buffer_size, &ref_size, 0, 0), AAD_APIRESULT_OK);
+    Test_AssertEqual(AADDecoder_DecodeWholeToBuffer(decoder, ref_data, ref_size, NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADDecoder_DecodeWholeToBuffer(decoder, ref_data, ref_size, &buffer),
+        AAD_APIRESULT_INSUFFICIENT_BUFFER);
+    buffer.num_channels = 2;
+    buffer.num_samples = NUM_SAMPLES - 1;
+    buffer.stride = 2;
+    Test_AssertEqual(AADDecoder_DecodeWholeParallelToBuffer(decoder, ref_data, ref_size, &buffer, 2),
+        AAD_APIRESULT_INSUFFICIENT_BUFFER);
+
+    AADEncoder_Destroy(encoder);
+    AADDecoder_Destroy(decoder);
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      free(input[ch]);
+      free(decoded[ch]);
+    }
+    free(interleaved);
+    free(planar_float);
+    free(ref_data);
+    free(data);
+#undef NUM_SAMPLES
+  }
+}
+
+/* 1サンプルずつビット単位で出力する経路でwavを書き出す */
+static uint8_t AADEncodeDecodeTest_WriteWAVByBits(const char *filename, const struct WAVFile *wav)
+{
+  FILE *fp;
+  struct WAVWriter writer;
+  uint8_t is_ok = 1;
+
+  if ((fp = fopen(filename, "wb")) == NULL) {
+    return 0;
+  }
+  WAVWriter_Initialize(&writer, fp);
+  if ((WAVWriter_PutWAVHeader(&writer, &wav->format) != WAV_ERROR_OK)
+      || (WAVWriter_PutWAVPcmDataByBits(&writer, wav) != WAV_ERROR_OK)) {
+    is_ok = 0;
+  }
+  WAVWriter_Finalize(&writer);
+  fclose(fp);
+
+  return is_ok;
+}
+
+/* ファイル内容をすべて読み込む 失敗時はNULLを返す */
+static uint8_t *AADEncodeDecodeTest_LoadFile(const char *filename, uint32_t *file_size)
+{
+  FILE *fp;
+  long size;
+  uint8_t *data = NULL;
+
+  if ((fp = fopen(filename, "rb")) == NULL) {
+    return NULL;
+  }
+  if ((fseek(fp, 0, SEEK_END) == 0) && ((size = ftell(fp)) > 0)
+      && (fseek(fp, 0, SEEK_SET) == 0)
+      && ((data = (uint8_t *)malloc((size_t)size)) != NULL)) {
+    if (fread(data, sizeof(uint8_t), (size_t)size, fp) != (size_t)size) {
+      free(data);
+      data = NULL;
+    } else {
+      (*file_size) = (uint32_t)size;
+    }
+  }
+  fclose(fp);
+
+  return data;
+}
+
+/* wavの書き出し・読み込みテスト */
+static void AADEncodeDecodeTest_WAVReadWriteTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 各ビット深度・チャンネル数で書き出した値がそのまま読めるか */
+  {
+#define NUM_SAMPLES 1037
+#define TEST_FILENAME "wav_read_write_test.wav"
+    uint32_t i, ch, smpl;
+    uint8_t is_ok = 1;
+    struct WAVFile *wav, *readwav;
+    struct WAVFileFormat format;
+    const uint32_t bits_per_sample_list[] = { 8, 16, 24, 32 };
+    const uint32_t num_bps = sizeof(bits_per_sample_list) / sizeof(bits_per_sample_list[0]);
+
+    for (i = 0; i < num_bps * 3; i++) {
+      const uint32_t bits_per_sample = bits_per_sample_list[i % num_bps];
+      format.data_format = WAV_DATA_FORMAT_PCM;
+      format.num_channels = i / num_bps + 1;
+      format.sampling_rate = 44100;
+      format.bits_per_sample = bits_per_sample;
+      format.num_samples = NUM_SAMPLES;
+      wav = WAV_Create(&format);
+      /* 下位ビットを落とした値（端の値を含む）で埋める */
+      for (ch = 0; ch < format.num_channels; ch++) {
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+          const uint32_t val = (smpl * 2654435761UL + ch * 40503UL) & 0xFFFFFFFFUL;
+          WAVFile_PCM(wav, smpl, ch) = (int32_t)(val & ~((1UL << (32 - bits_per_sample)) - 1) & 0xFFFFFFFFUL);
+        }
+        WAVFile_PCM(wav, 0, ch) = INT32_MIN;
+        WAVFile_PCM(wav, 1, ch) = (int32_t)(0x7FFFFFFFUL & ~((1UL << (32 - bits_per_sample)) - 1));
+      }
+      if ((WAV_WriteToFile(TEST_FILENAME, wav) != WAV_APIRESULT_OK)
+          || ((readwav = WAV_CreateFromFile(TEST_FILENAME)) == NULL)) {
+        WAV_Destroy(wav);
+        is_ok = 0;
+        break;
+      }
+      if ((readwav->format.num_channels != format.num_channels)
+          || (readwav->format.num_samples != format.num_samples)
+          || (readwav->format.bits_per_sample != format.bits_per_sample)) {
+        is_ok = 0;
+      } else {
+        for (ch = 0; ch < format.num_channels; ch++) {
+          if (memcmp(wav->data[ch], readwav->data[ch], sizeof(WAVPcmData) * NUM_SAMPLES) != 0) {
+            is_ok = 0;
+          }
+        }
+      }
+      WAV_Destroy(wav);
+      WAV_Destroy(readwav);
+    }
+    remove(TEST_FILENAME);
+    Test_AssertEqual(is_ok, 1);
+#undef NUM_SAMPLES
+#undef TEST_FILENAME
+  }
+
+  /* 一括書き出しの結果が1サンプルずつ書き出した結果とバイト単位で一致するか */
+  {
+#define TEST_FILENAME "wav_write_test.wav"
+#define REF_FILENAME  "wav_write_test_ref.wav"
+    uint32_t i, j, ch, smpl, test_size, ref_size;
+    uint8_t is_ok = 1;
+    uint8_t *test_data, *ref_data;
+    struct WAVFile *wav;
+    struct WAVFileFormat format;
+    const uint32_t bits_per_sample_list[] = { 8, 16, 24, 32 };
+    const uint32_t num_bps = sizeof(bits_per_sample_list) / sizeof(bits_per_sample_list[0]);
+    /* ベクトル幅に満たない端数や、作業領域の境界をまたぐ長さを含める */
+    const uint32_t num_samples_list[] = { 1, 15, 1037, WAV_PCM_STAGING_BUFFER_SIZE + 3 };
+    const uint32_t num_lengths = sizeof(num_samples_list) / sizeof(num_samples_list[0]);
+
+    for (i = 0; (i < num_bps * 2) && (is_ok == 1); i++) {
+      for (j = 0; (j < num_lengths) && (is_ok == 1); j++) {
+        const uint32_t bits_per_sample = bits_per_sample_list[i % num_bps];
+        format.data_format = WAV_DATA_FORMAT_PCM;
+        format.num_channels = i / num_bps + 1;
+        format.sampling_rate = 44100;
+        format.bits_per_sample = bits_per_sample;
+        format.num_samples = num_samples_list[j];
+        wav = WAV_Create(&format);
+        /* 下位ビットを落としていない値も含めて埋める */
+        for (ch = 0; ch < format.num_channels; ch++) {
+          for (smpl = 0; smpl < format.num_samples; smpl++) {
+            const uint32_t val = (smpl * 2654435761UL + ch * 40503UL) & 0xFFFFFFFFUL;
+            WAVFile_PCM(wav, smpl, ch) = (int32_t)val;
+          }
+          WAVFile_PCM(wav, 0, ch) = (ch == 0) ? INT32_MIN : INT32_MAX;
+        }
+        test_data = ref_data = NULL;
+        if ((WAV_WriteToFile(TEST_FILENAME, wav) != WAV_APIRESULT_OK)
+            || (AADEncodeDecodeTest_WriteWAVByBits(REF_FILENAME, wav) != 1)
+            || ((test_data = AADEncodeDecodeTest_LoadFile(TEST_FILENAME, &test_size)) == NULL)
+            || ((ref_data = AADEncodeDecodeTest_LoadFile(REF_FILENAME, &ref_size)) == NULL)
+            || (test_size != ref_size)
+            || (memcmp(test_data, ref_data, ref_size) != 0)) {
+          is_ok = 0;
+        }
+        free(test_data);
+        free(ref_data);
+        WAV_Destroy(wav);
+      }
+    }
+    remove(TEST_FILENAME);
+    remove(REF_FILENAME);
+    Test_AssertEqual(is_ok, 1);
+#undef TEST_FILENAME
+#undef REF_FILENAME
+  }
+}
+
+/* WAVのストリーミング読み書きのテスト */
+static void AADEncodeDecodeTest_WAVStreamTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 区間ごとに書き出したファイルが一括で書き出したものと一致し、区間ごとに読み戻せるか */
+  {
+#define NUM_SAMPLES 1037
+#define WRITE_CHUNK 100
+#define READ_CHUNK  77
+#define STREAM_FILENAME "wav_stream_test.wav"
+#define WHOLE_FILENAME  "wav_stream_test_whole.wav"
+    uint32_t i, ch, smpl, progress, num_read;
+    uint8_t is_ok = 1;
+    struct WAVFile *wav;
+    struct WAVFileFormat format, readformat;
+    struct WAVWriteStream *wstream;
+    struct WAVReadStream *rstream;
+    WAVPcmData *data[3];
+    WAVPcmData buffer[3][READ_CHUNK];
+    const uint32_t bits_per_sample_list[] = { 8, 16, 24, 32 };
+    const uint32_t num_bps = sizeof(bits_per_sample_list) / sizeof(bits_per_sample_list[0]);
+
+    for (i = 0; i < num_bps * 3; i++) {
+      const uint32_t bits_per_sample = bits_per_sample_list[i % num_bps];
+      format.data_format = WAV_DATA_FORMAT_PCM;
+      format.num_channels = i / num_bps + 1;
+      format.sampling_rate = 44100;
+      format.bits_per_sample = bits_per_sample;
+      format.num_samples = NUM_SAMPLES;
+      wav = WAV_Create(&format);
+      for (ch = 0; ch < format.num_channels; ch++) {
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+          const uint32_t val = (smpl * 2654435761UL + ch * 40503UL) & 0xFFFFFFFFUL;
+          WAVFile_PCM(wav, smpl, ch) = (int32_t)(val & ~((1UL << (32 - bits_per_sample)) - 1) & 0xFFFFFFFFUL);
+        }
+      }
+      if (WAV_WriteToFile(WHOLE_FILENAME, wav) != WAV_APIRESULT_OK) {
+        WAV_Destroy(wav);
+        is_ok = 0;
+        break;
+      }
+
+      /* サンプル数未定（0）で開き、終了時にサイズを書き換える */
+      format.num_samples = 0;
+      if ((wstream = WAV_OpenWriteStream(STREAM_FILENAME, &format)) == NULL) {
+        WAV_Destroy(wav);
+        is_ok = 0;
+        break;
+      }
+      for (progress = 0; progress < NUM_SAMPLES; progress += WRITE_CHUNK) {
+        const uint32_t num_write = (NUM_SAMPLES - progress < WRITE_CHUNK) ? (NUM_SAMPLES - progress) : WRITE_CHUNK;
+        for (ch = 0; ch < format.num_channels; ch++) {
+          data[ch] = &wav->data[ch][progress];
+        }
+        if (WAV_WriteFrames(wstream, data, num_write) != WAV_APIRESULT_OK) {
+          is_ok = 0;
+        }
+      }
+      if (WAV_FinalizeWriteStream(wstream) != WAV_APIRESULT_OK) {
+        is_ok = 0;
+      }
+
+      /* ファイルが一致するか */
+      {
+        FILE *fp1 = fopen(STREAM_FILENAME, "rb"), *fp2 = fopen(WHOLE_FILENAME, "rb");
+        int c1, c2;
+        if ((fp1 == NULL) || (fp2 == NULL)) {
+          is_ok = 0;
+        } else {
+          do {
+            c1 = fgetc(fp1);
+            c2 = fgetc(fp2);
+            if (c1 != c2) {
+              is_ok = 0;
+              break;
+            }
+          } while (c1 != EOF);
+        }
+        if (fp1 != NULL) { fclose(fp1); }
+        if (fp2 != NULL) { fclose(fp2); }
+      }
+
+      /* 区間ごとに読み戻す */
+      if ((rstream = WAV_OpenReadStream(STREAM_FILENAME, &readformat)) == NULL) {
+        WAV_Destroy(wav);
+        is_ok = 0;
+        break;
+      }
+      if ((readformat.num_samples != NUM_SAMPLES)
+          || (readformat.num_channels != format.num_channels)
+          || (readformat.bits_per_sample != format.bits_per_sample)) {
+        is_ok = 0;
+      }
+      for (ch = 0; ch < format.num_channels; ch++) {
+        data[ch] = buffer[ch];
+      }
+      progress = 0;
+      while ((WAV_ReadFrames(rstream, data, READ_CHUNK, &num_read) == WAV_APIRESULT_OK) && (num_read > 0)) {
+        if (progress + num_read > NUM_SAMPLES) {
+          is_ok = 0;
+          break;
+        }
+        for (ch = 0; ch < format.num_channels; ch++) {
+          if (memcmp(&wav->data[ch][progress], buffer[ch], sizeof(WAVPcmData) * num_read) != 0) {
+            is_ok = 0;
+          }
+        }
+        progress += num_read;
+      }
+      if (progress != NUM_SAMPLES) {
+        is_ok = 0;
+      }
+      WAV_CloseReadStream(rstream);
+      WAV_Destroy(wav);
+    }
+    remove(STREAM_FILENAME);
+    remove(WHOLE_FILENAME);
+    Test_AssertEqual(is_ok, 1);
+#undef NUM_SAMPLES
+#undef WRITE_CHUNK
+#undef READ_CHUNK
+#undef STREAM_FILENAME
+#undef WHOLE_FILENAME
+  }
+
+  /* ファイルポインタから、途中のチャンクと長さ不明のdataチャンクを読めるか */
+  {
+#define NUM_SAMPLES 300
+#define STREAM_FILENAME "wav_stream_test.wav"
+    FILE *fp;
+    uint32_t smpl, num_read, progress;
+    uint8_t header[WAV_HEADER_SIZE], is_ok = 1;
+    struct WAVFileFormat format;
+    struct WAVReadStream *rstream;
+    WAVPcmData buffer[NUM_SAMPLES];
+    WAVPcmData *data[1];
+    const uint8_t list_chunk[] = { 'L', 'I', 'S', 'T', 6, 0, 0, 0, 'a', 'b', 'c', 'd', 'e', 'f' };
+
+    format.data_format = WAV_DATA_FORMAT_PCM;
+    format.num_channels = 1;
+    format.sampling_rate = 8000;
+    format.bits_per_sample = 16;
+    format.num_samples = NUM_SAMPLES;
+    Test_AssertEqual(WAV_PutWAVHeaderToMemory(&format, header, sizeof(header)), WAV_APIRESULT_OK);
+    /* dataチャンクのサイズを最大値にする（パイプ出力のwavに見られる） */
+    memset(&header[40], 0xFF, 4);
+
+    /* fmtチャンクとdataチャンクの間にLISTチャンクを挟む */
+    fp = fopen(STREAM_FILENAME, "wb");
+    fwrite(header, sizeof(uint8_t), 36, fp);
+    fwrite(list_chunk, sizeof(uint8_t), sizeof(list_chunk), fp);
+    fwrite(&header[36], sizeof(uint8_t), WAV_HEADER_SIZE - 36, fp);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+      uint8_t pcm[2];
+      pcm[0] = (uint8_t)(smpl & 0xFF);
+      pcm[1] = (uint8_t)(smpl >> 8);
+      fwrite(pcm, sizeof(uint8_t), 2, fp);
+    }
+    fclose(fp);
+
+    fp = fopen(STREAM_FILENAME, "rb");
+    Test_AssertCondition(WAV_OpenReadStreamFromFilePointer(NULL, &format) == NULL);
+    Test_AssertCondition(WAV_OpenReadStreamFromFilePointer(fp, NULL) == NULL);
+    rstream = WAV_OpenReadStreamFromFilePointer(fp, &format);
+    Test_AssertCondition(rstream != NULL);
+    Test_AssertEqual(format.num_channels, 1);
+    Test_AssertEqual(format.bits_per_sample, 16);
+
+    /* データの終端まで読める */
+    data[0] = buffer;
+    progress = 0;
+    while ((WAV_ReadFrames(rstream, data, 64, &num_read) == WAV_APIRESULT_OK) && (num_read > 0)) {
+      for (smpl = 0; smpl < num_read; smpl++) {
+        if (buffer[smpl] != (int32_t)((progress + smpl) << 16)) {
+          is_ok = 0;
+        }
+      }
+      progress += num_read;
+    }
+    Test_AssertEqual(progress, NUM_SAMPLES);
+    Test_AssertEqual(is_ok, 1);
+    WAV_CloseReadStream(rstream);
+
+    /* 失敗時はファイルポインタを閉じない */
+    fp = fopen(STREAM_FILENAME, "rb");
+    fseek(fp, 1, SEEK_SET);
+    Test_AssertCondition(WAV_OpenReadStreamFromFilePointer(fp, &format) == NULL);
+    Test_AssertEqual(fclose(fp), 0);
+
+    /* ファイルポインタへの書き出し（シークできればサイズは書き換わる） */
+    {
+      struct WAVWriteStream *wstream;
+      format.num_samples = 0;
+      fp = fopen(STREAM_FILENAME, "wb");
+      Test_AssertCondition(WAV_OpenWriteStreamToFilePointer(NULL, &format) == NULL);
+      wstream = WAV_OpenWriteStreamToFilePointer(fp, &format);
+      Test_AssertCondition(wstream != NULL);
+      Test_AssertEqual(WAV_WriteFrames(wstream, data, NUM_SAMPLES), WAV_APIRESULT_OK);
+      Test_AssertEqual(WAV_FinalizeWriteStream(wstream), WAV_APIRESULT_OK);
+      Test_AssertEqual(WAV_GetWAVFormatFromFile(STREAM_FILENAME, &format), WAV_APIRESULT_OK);
+      Test_AssertEqual(format.num_samples, NUM_SAMPLES);
+    }
+
+    remove(STREAM_FILENAME);
+#undef NUM_SAMPLES
+#undef STREAM_FILENAME
+  }
+
+  /* 失敗ケース */
+  {
+    struct WAVFileFormat format;
+    uint32_t num_read;
+
+    Test_AssertCondition(WAV_OpenReadStream(NULL, &format) == NULL);
+    Test_AssertCondition(WAV_OpenReadStream("no_such_file.wav", &format) == NULL);
+    Test_AssertEqual(WAV_ReadFrames(NULL, NULL, 1, &num_read), WAV_APIRESULT_INVALID_PARAMETER);
+    Test_AssertEqual(WAV_WriteFrames(NULL, NULL, 1), WAV_APIRESULT_INVALID_PARAMETER);
+    Test_AssertEqual(WAV_FinalizeWriteStream(NULL), WAV_APIRESULT_INVALID_PARAMETER);
+
+    /* 対応していないビット深度 */
+    format.data_format = WAV_DATA_FORMAT_PCM;
+    format.num_channels = 1;
+    format.sampling_rate = 44100;
+    format.bits_per_sample = 12;
+    format.num_samples = 0;
+    Test_AssertCondition(WAV_OpenWriteStream("wav_stream_test.wav", &format) == NULL);
+  }
+}
+
+/* WAVヘッダのメモリ書き出し・PCMデータ位置取得のテスト */
+static void AADEncodeDecodeTest_WAVHeaderTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* メモリに書き出したヘッダがファイル書き出しの先頭と一致し、PCMデータ位置がヘッダ直後か */
+  {
+#define TEST_FILENAME "wav_header_test.wav"
+    struct WAVFile *wav;
+    struct WAVFileFormat format, readformat;
+    uint8_t header[WAV_HEADER_SIZE], file_header[WAV_HEADER_SIZE];
+    uint32_t data_offset;
+    FILE *fp;
+
+    format.data_format = WAV_DATA_FORMAT_PCM;
+    format.num_channels = 2;
+    format.sampling_rate = 48000;
+    format.bits_per_sample = 16;
+    format.num_samples = 123;
+    wav = WAV_Create(&format);
+    Test_AssertEqual(WAV_WriteToFile(TEST_FILENAME, wav), WAV_APIRESULT_OK);
+    Test_AssertEqual(WAV_PutWAVHeaderToMemory(&format, header, sizeof(header)), WAV_APIRESULT_OK);
+
+    fp = fopen(TEST_FILENAME, "rb");
+    Test_AssertCondition(fp != NULL);
+    Test_AssertEqual(fread(file_header, sizeof(uint8_t), WAV_HEADER_SIZE, fp), WAV_HEADER_SIZE);
+    fclose(fp);
+    Test_AssertEqual(memcmp(header, file_header, WAV_HEADER_SIZE), 0);
+
+    Test_AssertEqual(WAV_GetWAVFormatAndDataOffsetFromFile(TEST_FILENAME, &readformat, &data_offset), WAV_APIRESULT_OK);
+    Test_AssertEqual(data_offset, WAV_HEADER_SIZE);
+    Test_AssertEqual(readformat.num_samples, 123);
+    Test_AssertEqual(readformat.num_channels, 2);
+
+    WAV_Destroy(wav);
+    remove(TEST_FILENAME);
+#undef TEST_FILENAME
+  }
+
+  /* 失敗ケース */
+  {
+    struct WAVFileFormat format;
+    uint8_t header[WAV_HEADER_SIZE];
+    uint32_t data_offset;
+
+    format.data_format = WAV_DATA_FORMAT_PCM;
+    format.num_channels = 1;
+    format.sampling_rate = 44100;
+    format.bits_per_sample = 16;
+    format.num_samples = 0;
+    Test_AssertEqual(WAV_PutWAVHeaderToMemory(NULL, header, sizeof(header)), WAV_APIRESULT_INVALID_PARAMETER);
+    Test_AssertEqual(WAV_PutWAVHeaderToMemory(&format, NULL, sizeof(header)), WAV_APIRESULT_INVALID_PARAMETER);
+    Test_AssertEqual(WAV_PutWAVHeaderToMemory(&format, header, WAV_HEADER_SIZE - 1), WAV_APIRESULT_INVALID_PARAMETER);
+    Test_AssertEqual(WAV_GetWAVFormatAndDataOffsetFromFile(NULL, &format, &data_offset), WAV_APIRESULT_INVALID_PARAMETER);
+    Test_AssertEqual(WAV_GetWAVFormatAndDataOffsetFromFile("no_such_file.wav", &format, &data_offset), WAV_APIRESULT_NG);
+  }
+}
+
 void AADEncodeDecodeTest_Setup(void)
 {
   struct TestSuite *suite
@@ -644,4 +1468,9 @@ void AADEncodeDecodeTest_Setup(void)
 
   Test_AddTest(suite, AADEncodeDecodeTest_EncodeDecodeHeaderTest);
   Test_AddTest(suite, AADEncodeDecodeTest_EncodeDecodeTest);
+  Test_AddTest(suite, AADEncodeDecodeTest_EncodeParallelTest);
+  Test_AddTest(suite, AADEncodeDecodeTest_SampleBufferTest);
+  Test_AddTest(suite, AADEncodeDecodeTest_WAVReadWriteTest);
+  Test_AddTest(suite, AADEncodeDecodeTest_WAVStreamTest);
+  Test_AddTest(suite, AADEncodeDecodeTest_WAVHeaderTest);
 }
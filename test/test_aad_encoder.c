@@ -1,6 +1,7 @@
 #include "test.h"
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 /* テスト対象のモジュール */
 #include "../src/aad_encoder.c"
@@ -27,7 +28,7 @@ static void AADEncoderTest_CalculateBlockSizeTest(void *obj)
 
   /* 計算値チェック */
   {
-    uint16_t block_size;
+    uint32_t block_size;
     uint32_t num_samples_per_block;
 
     Test_AssertEqual(AADEncoder_CalculateBlockSize(32, 1, 4, &block_size, &num_samples_per_block), AAD_APIRESULT_OK);
@@ -65,7 +66,7 @@ static void AADEncoderTest_CalculateBlockSizeTest(void *obj)
 
   /* 失敗例 */
   {
-    uint16_t block_size;
+    uint32_t block_size;
     uint32_t num_samples_per_block;
 
     /* 引数が不正 */
@@ -281,6 +282,7 @@ static void AADEncoderTest_SetEncodeParameterTest(void *obj)
     p__param->max_block_size  = 256;                          \
     p__param->ch_process_method = AAD_CH_PROCESS_METHOD_NONE; \
     p__param->num_encode_trials = 1;                          \
+    p__param->search_method = AAD_SEARCH_METHOD_SEQUENTIAL;   \
 }
 
   /* 成功例 */
@@ -329,10 +331,561 @@ static void AADEncoderTest_SetEncodeParameterTest(void *obj)
     param.max_block_size = AAD_BLOCK_HEADER_SIZE(param.num_channels) - 1;
     Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &param), AAD_APIRESULT_INVALID_FORMAT);
 
+    /* 探索法が異常 */
+    AAD_SetValidParameter(&param);
+    param.search_method = AAD_SEARCH_METHOD_INVALID;
+    Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &param), AAD_APIRESULT_INVALID_FORMAT);
+
     AADEncoder_Destroy(encoder);
   }
 }
 
+/* ストリーミングで入力を分割してエンコードし、一括エンコード結果と一致するか確認 成功時は1を返す */
+static uint8_t AADEncoderTest_CheckEncodeStream(
+    const struct AADEncodeParameter *param,
+    const int32_t *const *input, uint32_t num_samples, uint32_t num_samples_per_feed)
+{
+  struct AADEncoder *encoder;
+  uint8_t *whole_data, *stream_data;
+  uint8_t header_data[AAD_HEADER_SIZE];
+  uint32_t ch, progress, stream_size, output_size;
+  uint64_t whole_size;
+  const int32_t *input_ptr[AAD_MAX_NUM_CHANNELS];
+  const uint32_t data_size = num_samples * param->num_channels * sizeof(int32_t);
+  uint8_t is_ok = 0;
+
+  whole_data = (uint8_t *)malloc(data_size);
+  stream_data = (uint8_t *)malloc(data_size);
+
+  /* 一括エンコード */
+  encoder = AADEncoder_Create(param->max_block_size, NULL, 0);
+  if ((AADEncoder_SetEncodeParameter(encoder, param) != AAD_APIRESULT_OK)
+      || (AADEncoder_EncodeWhole(encoder, input, num_samples, whole_data, data_size, &whole_size) != AAD_APIRESULT_OK)) {
+    goto EXIT;
+  }
+  AADEncoder_Destroy(encoder);
+
+  /* ストリーミングエンコード */
+  encoder = AADEncoder_Create(param->max_block_size, NULL, 0);
+  if ((AADEncoder_SetEncodeParameter(encoder, param) != AAD_APIRESULT_OK)
+      || (AADEncoder_BeginEncodeStream(encoder, stream_data, data_size, &stream_size) != AAD_APIRESULT_OK)) {
+    goto EXIT;
+  }
+  for (progress = 0; progress < num_samples; progress += num_samples_per_feed) {
+    const uint32_t num_feed = AAD_MIN_VAL(num_samples_per_feed, num_samples - progress);
+    for (ch = 0; ch < param->num_channels; ch++) {
+      input_ptr[ch] = &input[ch][progress];
+    }
+    if (AADEncoder_EncodeStream(encoder, input_ptr, num_feed,
+          &stream_data[stream_size], data_size - stream_size, &output_size) != AAD_APIRESULT_OK) {
+      goto EXIT;
+    }
+    stream_size += output_size;
+    /* 内部に保持するのは1ブロック未満 */
+    if (encoder->stream_num_buffered_samples >= encoder->header.num_samples_per_block) {
+      goto EXIT;
+    }
+  }
+  if (AADEncoder_FinishEncodeStream(encoder, &stream_data[stream_size], data_size - stream_size, &output_size,
+        header_data, sizeof(header_data)) != AAD_APIRESULT_OK) {
+    goto EXIT;
+  }
+  stream_size += output_size;
+  memcpy(stream_data, header_data, AAD_HEADER_SIZE);
+
+  /* 一致確認 */
+  if ((whole_size == stream_size) && (memcmp(whole_data, stream_data, whole_size) == 0)) {
+    is_ok = 1;
+  }
+
+EXIT:
+  AADEncoder_Destroy(encoder);
+  free(whole_data);
+  free(stream_data);
+  return is_ok;
+}
+
+/* ストリーミングエンコードテスト */
+static void AADEncoderTest_EncodeStreamTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 失敗ケース */
+  {
+    struct AADEncoder *encoder;
+    struct AADEncodeParameter param;
+    uint8_t data[1024], header_data[AAD_HEADER_SIZE];
+    int32_t samples[256] = { 0, };
+    const int32_t *input[1];
+    uint32_t output_size;
+
+    input[0] = samples;
+    AAD_SetValidParameter(&param);
+    encoder = AADEncoder_Create(param.max_block_size, NULL, 0);
+
+    /* パラメータ未セット */
+    Test_AssertEqual(AADEncoder_BeginEncodeStream(encoder, data, sizeof(data), &output_size), AAD_APIRESULT_PARAMETER_NOT_SET);
+    Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &param), AAD_APIRESULT_OK);
+
+    /* 開始前の入力・終了 */
+    Test_AssertEqual(AADEncoder_EncodeStream(encoder, input, 1, data, sizeof(data), &output_size), AAD_APIRESULT_NG);
+    Test_AssertEqual(
+        AADEncoder_FinishEncodeStream(encoder, data, sizeof(data), &output_size, header_data, sizeof(header_data)),
+        AAD_APIRESULT_NG);
+
+    /* 引数が不正 */
+    Test_AssertEqual(AADEncoder_BeginEncodeStream(NULL, data, sizeof(data), &output_size), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncoder_BeginEncodeStream(encoder, NULL, sizeof(data), &output_size), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncoder_BeginEncodeStream(encoder, data, sizeof(data), NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+
+    /* 開始するとヘッダが出力され、総サンプル数は不明 */
+    Test_AssertEqual(AADEncoder_BeginEncodeStream(encoder, data, sizeof(data), &output_size), AAD_APIRESULT_OK);
+    Test_AssertEqual(output_size, AAD_HEADER_SIZE);
+    Test_AssertEqual(ByteArray_ReadUint64BE(&data[14]), AAD_NUM_SAMPLES_UNKNOWN);
+
+    Test_AssertEqual(AADEncoder_EncodeStream(NULL, input, 1, data, sizeof(data), &output_size), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncoder_EncodeStream(encoder, NULL, 1, data, sizeof(data), &output_size), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncoder_EncodeStream(encoder, input, 1, NULL, sizeof(data), &output_size), AAD_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncoder_EncodeStream(encoder, input, 1, data, sizeof(data), NULL), AAD_APIRESULT_INVALID_ARGUMENT);
+
+    /* ブロックが揃わない入力では出力されない */
+    Test_AssertEqual(AADEncoder_EncodeStream(encoder, input, 1, data, 0, &output_size), AAD_APIRESULT_OK);
+    Test_AssertEqual(output_size, 0);
+    Test_AssertEqual(encoder->stream_num_buffered_samples, 1);
+
+    /* 出力領域不足のときは入力を消費しない */
+    Test_AssertEqual(
+        AADEncoder_EncodeStream(encoder, input, encoder->header.num_samples_per_block, data, encoder->header.block_size - 1, &output_size),
+        AAD_APIRESULT_INSUFFICIENT_BUFFER);
+    Test_AssertEqual(encoder->stream_num_buffered_samples, 1);
+    Test_AssertEqual(encoder->stream_num_samples, 1);
+
+    /* 終了すると総サンプル数が確定したヘッダが得られる */
+    Test_AssertEqual(
+        AADEncoder_FinishEncodeStream(encoder, data, sizeof(data), &output_size, header_data, sizeof(header_data)),
+        AAD_APIRESULT_OK);
+    Test_AssertEqual(output_size, AAD_BLOCK_HEADER_SIZE(1));
+    Test_AssertEqual(ByteArray_ReadUint64BE(&header_data[14]), 1);
+    Test_AssertEqual(encoder->stream_begun, 0);
+
+    AADEncoder_Destroy(encoder);
+  }
+
+  /* 一括エンコードとの一致確認 */
+  {
+#define NUM_SAMPLES 5000
+    int32_t *input[AAD_MAX_NUM_CHANNELS];
+    uint32_t ch, smpl, i, j, seed;
+    uint8_t is_ok;
+    const struct AADEncodeParameter param_list[] = {
+      { 1, 8000, 4,  128, AAD_CH_PROCESS_METHOD_NONE, 0 },
+      { 1, 8000, 3,  256, AAD_CH_PROCESS_METHOD_NONE, 1 },
+      { 2, 8000, 2,  128, AAD_CH_PROCESS_METHOD_NONE, 2 },
+      { 2, 8000, 4,  256, AAD_CH_PROCESS_METHOD_MS,   1 },
+      { 2, 8000, 3, 1024, AAD_CH_PROCESS_METHOD_MS,   2 },
+    };
+    const uint32_t num_samples_per_feed_list[] = { 1, 7, 100, 1024, NUM_SAMPLES };
+    const uint32_t num_params = sizeof(param_list) / sizeof(param_list[0]);
+    const uint32_t num_feeds = sizeof(num_samples_per_feed_list) / sizeof(num_samples_per_feed_list[0]);
+
+    /* 擬似乱数を重ねたのこぎり波 */
+    seed = 1;
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        seed = seed * 1103515245 + 12345;
+        input[ch][smpl] = (int32_t)((smpl * (ch + 3) * 97) % 20000) - 10000 + (int32_t)((seed >> 16) % 2001) - 1000;
+      }
+    }
+
+    is_ok = 1;
+    for (i = 0; i < num_params; i++) {
+      uint32_t block_size;
+      uint32_t num_samples_per_block;
+      Test_AssertEqual(AADEncoder_CalculateBlockSize(param_list[i].max_block_size,
+            param_list[i].num_channels, param_list[i].bits_per_sample,
+            &block_size, &num_samples_per_block), AAD_APIRESULT_OK);
+      for (j = 0; j < num_feeds; j++) {
+        /* 総サンプル数がブロックの倍数の場合も確認 */
+        if ((AADEncoderTest_CheckEncodeStream(&param_list[i],
+                (const int32_t *const *)input, NUM_SAMPLES, num_samples_per_feed_list[j]) != 1)
+            || (AADEncoderTest_CheckEncodeStream(&param_list[i],
+                (const int32_t *const *)input, (NUM_SAMPLES / num_samples_per_block) * num_samples_per_block,
+                num_samples_per_feed_list[j]) != 1)) {
+          is_ok = 0;
+          break;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      free(input[ch]);
+    }
+#undef NUM_SAMPLES
+  }
+}
+
+/* 直前ブロックの変換済み入力の再利用テスト */
+static void AADEncoderTest_PrevInputBufferTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 毎ブロック直前ブロックを変換し直した結果と一致するか */
+  {
+#define NUM_SAMPLES 3000
+    struct AADEncoder *encoder;
+    int32_t *input[AAD_MAX_NUM_CHANNELS];
+    struct AADSampleBuffer input_buffer;
+    uint8_t *whole_data, *block_data;
+    uint32_t ch, smpl, i, progress, block_size, output_size;
+    uint64_t whole_size;
+    const struct AADEncodeParameter param_list[] = {
+      { 1, 8000, 4,  128, AAD_CH_PROCESS_METHOD_NONE, 2 },
+      { 2, 8000, 3,  256, AAD_CH_PROCESS_METHOD_NONE, 1 },
+      { 2, 8000, 4,  256, AAD_CH_PROCESS_METHOD_MS,   2 },
+    };
+    const uint32_t num_params = sizeof(param_list) / sizeof(param_list[0]);
+    const uint32_t data_size = NUM_SAMPLES * AAD_MAX_NUM_CHANNELS * sizeof(int32_t);
+
+    whole_data = (uint8_t *)malloc(data_size);
+    block_data = (uint8_t *)malloc(data_size);
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[ch][smpl] = (int32_t)((smpl * (ch + 5) * 131) % 30000) - 15000;
+      }
+    }
+
+    for (i = 0; i < num_params; i++) {
+      /* 一括エンコード */
+      encoder = AADEncoder_Create(param_list[i].max_block_size, NULL, 0);
+      Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &param_list[i]), AAD_APIRESULT_OK);
+      Test_AssertEqual(
+          AADEncoder_EncodeWhole(encoder, (const int32_t *const *)input, NUM_SAMPLES, whole_data, data_size, &whole_size),
+          AAD_APIRESULT_OK);
+      Test_AssertEqual(encoder->prev_input_buffered, 1);
+      AADEncoder_Destroy(encoder);
+
+      /* 保持フラグを下ろしながらブロック単位でエンコード */
+      encoder = AADEncoder_Create(param_list[i].max_block_size, NULL, 0);
+      Test_AssertEqual(AADEncoder_SetEncodeParameter(encoder, &param_list[i]), AAD_APIRESULT_OK);
+      Test_AssertEqual(encoder->prev_input_buffered, 0);
+      encoder->header.num_samples = NUM_SAMPLES;
+      Test_AssertEqual(AADEncoder_EncodeHeader(&(encoder->header), block_data, data_size), AAD_APIRESULT_OK);
+      block_size = AAD_HEADER_SIZE;
+      AADSampleBuffer_SetPlanarInt32(&input_buffer, input, param_list[i].num_channels, NUM_SAMPLES);
+      for (progress = 0; progress < NUM_SAMPLES; progress += encoder->header.num_samples_per_block) {
+        encoder->prev_input_buffered = 0;
+        Test_AssertEqual(AADEncoder_SearchAndEncodeBlockAt(encoder, &input_buffer, progress,
+              &block_data[block_size], data_size - block_size, &output_size), AAD_APIRESULT_OK);
+        block_size += output_size;
+      }
+      AADEncoder_Destroy(encoder);
+
+      Test_AssertEqual(whole_size, block_size);
+      Test_AssertEqual(memcmp(whole_data, block_data, whole_size), 0);
+    }
+
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      free(input[ch]);
+    }
+    free(whole_data);
+    free(block_data);
+#undef NUM_SAMPLES
+  }
+}
+
+/* 誤差計測のテスト */
+static void AADEncoderTest_CalculateSumSquaredErrorTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 引数が不正 */
+  {
+    int32_t input[16] = { 0, };
+    uint64_t sum;
+    struct AADEncodeProcessor processor;
+
+    Test_AssertEqual(AADEncodeProcessor_CalculateSumSquaredError(NULL, input, 16, 4, UINT64_MAX, &sum), AAD_ERROR_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncodeProcessor_CalculateSumSquaredError(&processor, NULL, 16, 4, UINT64_MAX, &sum), AAD_ERROR_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncodeProcessor_CalculateSumSquaredError(&processor, input, 16, 4, UINT64_MAX, NULL), AAD_ERROR_INVALID_ARGUMENT);
+  }
+
+  /* 上限を超えたら打ち切られるか */
+  {
+#define NUM_SAMPLES 1024
+    uint32_t smpl;
+    int32_t input[NUM_SAMPLES];
+    uint64_t full_sum, sum;
+    struct AADEncodeProcessor initial, processor;
+
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+      input[smpl] = (int32_t)(INT16_MAX * sin(0.05 * smpl));
+    }
+    memset(&initial, 0, sizeof(struct AADEncodeProcessor));
+    AADTable_Initialize(&initial.table, 4);
+
+    /* 上限なし */
+    processor = initial;
+    Test_AssertEqual(AADEncodeProcessor_CalculateSumSquaredError(&processor, input, NUM_SAMPLES, 4, UINT64_MAX, &full_sum), AAD_ERROR_OK);
+    Test_AssertCondition(full_sum > 0);
+
+    /* 上限ちょうどでは打ち切られない */
+    processor = initial;
+    Test_AssertEqual(AADEncodeProcessor_CalculateSumSquaredError(&processor, input, NUM_SAMPLES, 4, full_sum, &sum), AAD_ERROR_OK);
+    Test_AssertCondition(sum == full_sum);
+
+    /* 上限を下回れば途中で打ち切られ、上限より大きく全体未満の誤差和を返す */
+    processor = initial;
+    Test_AssertEqual(AADEncodeProcessor_CalculateSumSquaredError(&processor, input, NUM_SAMPLES, 4, full_sum / 2, &sum), AAD_ERROR_OK);
+    Test_AssertCondition(sum > full_sum / 2);
+    Test_AssertCondition(sum < full_sum);
+#undef NUM_SAMPLES
+  }
+}
+
+/* 複数レーンの誤差計測のテスト */
+static void AADEncoderTest_CalculateSumSquaredErrorLanesTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 失敗ケース */
+  {
+    int32_t input[16] = { 0, };
+    struct AADEncodeProcessor processor;
+    struct AADEncodeLane lanes[AAD_ENCODER_NUM_LANES + 1];
+
+    lanes[0].processor = &processor;
+    lanes[0].input = input;
+    lanes[0].num_samples = 16;
+    lanes[0].max_sum_squared_error = UINT64_MAX;
+    Test_AssertEqual(AADEncoder_CalculateSumSquaredErrorLanes(NULL, 1, 4), AAD_ERROR_INVALID_ARGUMENT);
+    Test_AssertEqual(AADEncoder_CalculateSumSquaredErrorLanes(lanes, AAD_ENCODER_NUM_LANES + 1, 4), AAD_ERROR_INVALID_ARGUMENT);
+    lanes[0].processor = NULL;
+    Test_AssertEqual(AADEncoder_CalculateSumSquaredErrorLanes(lanes, 1, 4), AAD_ERROR_INVALID_ARGUMENT);
+    lanes[0].processor = &processor;
+    lanes[0].input = NULL;
+    Test_AssertEqual(AADEncoder_CalculateSumSquaredErrorLanes(lanes, 1, 4), AAD_ERROR_INVALID_ARGUMENT);
+  }
+
+  /* レーンごとに計測した結果と一致するか */
+  {
+#define NUM_SAMPLES 700
+    uint32_t lane, smpl, bits, num_lanes, seed;
+    uint8_t is_ok;
+    int32_t input[AAD_ENCODER_NUM_LANES][NUM_SAMPLES];
+    struct AADEncodeProcessor initial[AAD_ENCODER_NUM_LANES];
+    struct AADEncodeProcessor processor[AAD_ENCODER_NUM_LANES];
+    struct AADEncodeLane lanes[AAD_ENCODER_NUM_LANES];
+    const uint32_t num_samples_list[AAD_ENCODER_NUM_LANES] = { NUM_SAMPLES, NUM_SAMPLES - 37, 3, NUM_SAMPLES - 1 };
+
+    /* 擬似乱数を重ねた大振幅ののこぎり波 */
+    seed = 1;
+    for (lane = 0; lane < AAD_ENCODER_NUM_LANES; lane++) {
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        seed = seed * 1103515245 + 12345;
+        input[lane][smpl] = (int32_t)((smpl * (lane + 3) * 577) % 65536) - 32768 + (int32_t)((seed >> 16) % 4001) - 2000;
+        input[lane][smpl] = AAD_INNER_VAL(input[lane][smpl], INT16_MIN, INT16_MAX);
+      }
+    }
+
+    is_ok = 1;
+    for (bits = AAD_MIN_BITS_PER_SAMPLE; bits <= AAD_MAX_BITS_PER_SAMPLE; bits++) {
+      for (num_lanes = 1; num_lanes <= AAD_ENCODER_NUM_LANES; num_lanes++) {
+        for (lane = 0; lane < num_lanes; lane++) {
+          AADEncodeProcessor_Reset(&initial[lane]);
+          AADTable_Initialize(&initial[lane].table, (uint16_t)bits);
+          initial[lane].quantize_error = 0;
+          initial[lane].table.stepsize_index = (int16_t)AAD_TABLES_INDEX_TO_FLOAT(lane * 40);
+          for (smpl = 0; smpl < AAD_FILTER_ORDER; smpl++) {
+            initial[lane].history[smpl] = (int16_t)(smpl * 1000 + lane);
+            initial[lane].weight[smpl] = (int32_t)(lane * 3000) - (int32_t)(smpl * 2000);
+          }
+          processor[lane] = initial[lane];
+          lanes[lane].processor = &processor[lane];
+          lanes[lane].input = input[lane];
+          lanes[lane].num_samples = num_samples_list[lane];
+          lanes[lane].max_sum_squared_error = UINT64_MAX;
+        }
+        if (AADEncoder_CalculateSumSquaredErrorLanes(lanes, num_lanes, (uint8_t)bits) != AAD_ERROR_OK) {
+          is_ok = 0;
+        }
+        for (lane = 0; lane < num_lanes; lane++) {
+          uint64_t sum;
+          struct AADEncodeProcessor ref = initial[lane];
+          if (AADEncodeProcessor_CalculateSumSquaredError(&ref, input[lane],
+                num_samples_list[lane], (uint8_t)bits, UINT64_MAX, &sum) != AAD_ERROR_OK) {
+            is_ok = 0;
+          }
+          if ((sum != lanes[lane].sum_squared_error)
+              || (ref.table.stepsize_index != processor[lane].table.stepsize_index)
+              || (ref.quantize_error != processor[lane].quantize_error)
+              || (memcmp(ref.weight, processor[lane].weight, sizeof(ref.weight)) != 0)
+              || (memcmp(ref.history, processor[lane].history, sizeof(ref.history)) != 0)) {
+            is_ok = 0;
+          }
+        }
+        /* 打ち切り値を超えたら、全体の誤差和を超えない範囲で打ち切り値より大きい値を返す */
+        for (lane = 0; lane < num_lanes; lane++) {
+          processor[lane] = initial[lane];
+          lanes[lane].max_sum_squared_error = lanes[lane].sum_squared_error / 2;
+        }
+        if (AADEncoder_CalculateSumSquaredErrorLanes(lanes, num_lanes, (uint8_t)bits) != AAD_ERROR_OK) {
+          is_ok = 0;
+        }
+        for (lane = 0; lane < num_lanes; lane++) {
+          if ((lanes[lane].max_sum_squared_error > 0)
+              && (lanes[lane].sum_squared_error <= lanes[lane].max_sum_squared_error)) {
+            is_ok = 0;
+          }
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+#undef NUM_SAMPLES
+  }
+}
+
+#if AAD_ENCODER_USE_AVX2
+/* チャンネルをレーンに割り当てたエンコードのテスト */
+static void AADEncoderTest_EncodeUnitLanesAVX2Test(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* AVX2非対応環境では確認しない */
+  if (!__builtin_cpu_supports("avx2")) {
+    return;
+  }
+
+  /* チャンネルごとに逐次エンコードした結果と一致するか */
+  {
+#define NUM_SAMPLES 1000
+    uint32_t ch, smpl, k, bits, num_unit_samples, seed;
+    uint8_t is_ok;
+    int32_t *input[AAD_MAX_NUM_CHANNELS];
+    uint8_t code[AAD_MAX_NUM_CHANNELS * 8];
+    struct AADEncodeProcessor processor[AAD_MAX_NUM_CHANNELS];
+    struct AADEncodeProcessor ref[AAD_MAX_NUM_CHANNELS];
+    struct AADEncodeLaneTablesAVX2 tables;
+    struct AADEncodeLaneStateAVX2 state;
+
+    /* 擬似乱数を重ねた大振幅ののこぎり波 */
+    seed = 1;
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+      for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        seed = seed * 1103515245 + 12345;
+        input[ch][smpl] = (int32_t)((smpl * (ch + 3) * 577) % 65536) - 32768 + (int32_t)((seed >> 16) % 4001) - 2000;
+        input[ch][smpl] = AAD_INNER_VAL(input[ch][smpl], INT16_MIN, INT16_MAX);
+      }
+    }
+
+    is_ok = 1;
+    for (bits = AAD_MIN_BITS_PER_SAMPLE; bits <= AAD_MAX_BITS_PER_SAMPLE; bits++) {
+      num_unit_samples = (bits == 3) ? 8 : (8 / bits);
+      for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+        AADEncodeProcessor_Reset(&processor[ch]);
+        AADTable_Initialize(&processor[ch].table, (uint16_t)bits);
+        processor[ch].quantize_error = 0;
+        processor[ch].table.stepsize_index = (int16_t)AAD_TABLES_INDEX_TO_FLOAT(ch * 100);
+        ref[ch] = processor[ch];
+      }
+      AADEncoder_InitializeLaneTablesAVX2(&tables, &processor[0].table, (uint8_t)bits);
+      AADEncoder_LoadLaneStateAVX2(&state, processor, AAD_MAX_NUM_CHANNELS);
+      for (smpl = 0; (smpl + num_unit_samples) <= NUM_SAMPLES; smpl += num_unit_samples) {
+        AADEncoder_EncodeUnitLanesAVX2(&state, &tables,
+            (const int32_t *const *)input, AAD_MAX_NUM_CHANNELS, smpl, num_unit_samples, code);
+        for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+          uint8_t ref_code[8];
+          switch (bits) {
+            case 4: AADEncodeProcessor_EncodeUnit4bit(&ref[ch], &input[ch][smpl], ref_code); break;
+            case 3: AADEncodeProcessor_EncodeUnit3bit(&ref[ch], &input[ch][smpl], ref_code); break;
+            case 2: AADEncodeProcessor_EncodeUnit2bit(&ref[ch], &input[ch][smpl], ref_code); break;
+            default: AAD_ASSERT(0);
+          }
+          for (k = 0; k < num_unit_samples; k++) {
+            if (code[ch * num_unit_samples + k] != ref_code[k]) {
+              is_ok = 0;
+            }
+          }
+        }
+      }
+      AADEncoder_StoreLaneStateAVX2(&state, processor, AAD_MAX_NUM_CHANNELS);
+      for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+        if ((ref[ch].table.stepsize_index != processor[ch].table.stepsize_index)
+            || (ref[ch].quantize_error != processor[ch].quantize_error)
+            || (memcmp(ref[ch].weight, processor[ch].weight, sizeof(ref[ch].weight)) != 0)
+            || (memcmp(ref[ch].history, processor[ch].history, sizeof(ref[ch].history)) != 0)) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    for (ch = 0; ch < AAD_MAX_NUM_CHANNELS; ch++) {
+      free(input[ch]);
+    }
+#undef NUM_SAMPLES
+  }
+}
+#endif
+
+/* 符号の詰め込みテスト */
+static void AADEncoderTest_PackCodesTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 既知のデータ単位の詰め込み */
+  {
+    const uint8_t codes4[2] = { 0x1, 0x2 };
+    const uint8_t codes3[8] = { 0, 4, 4, 3, 2, 1, 2, 6 };
+    const uint8_t codes2[4] = { 0, 1, 0, 2 };
+    uint8_t data[3];
+
+    AADEncoder_PackCodes(codes4, 2, 4, data);
+    Test_AssertEqual(data[0], 0x12);
+
+    AADEncoder_PackCodes(codes3, 8, 3, data);
+    Test_AssertCondition((data[0] == 0x12) && (data[1] == 0x34) && (data[2] == 0x56));
+
+    AADEncoder_PackCodes(codes2, 4, 2, data);
+    Test_AssertEqual(data[0], 0x12);
+  }
+
+  /* 逐次処理との一致確認 */
+  {
+#define MAX_NUM_CODES 400
+    uint8_t codes[MAX_NUM_CODES];
+    uint8_t data[MAX_NUM_CODES / 2 + 1], ref_data[MAX_NUM_CODES / 2 + 1];
+    uint32_t i, bits, num_codes;
+    uint8_t is_ok;
+
+    is_ok = 1;
+    for (bits = 2; bits <= 4; bits++) {
+      for (i = 0; i < MAX_NUM_CODES; i++) {
+        codes[i] = (uint8_t)(((i * 149 + 37) >> 2) & ((1U << bits) - 1));
+      }
+      /* 8符号単位で確認 */
+      for (num_codes = 0; num_codes <= MAX_NUM_CODES; num_codes += 8) {
+        const uint32_t data_size = (num_codes * bits) / 8;
+        memset(data, 0xFF, sizeof(data));
+        AADEncoder_PackCodes(codes, num_codes, (uint8_t)bits, data);
+        AADEncoder_PackCodesScalar(codes, num_codes, (uint8_t)bits, ref_data);
+        if (memcmp(data, ref_data, data_size) != 0) {
+          is_ok = 0;
+        }
+        /* 出力範囲外に書き込んでいない */
+        if (data[data_size] != 0xFF) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+#undef MAX_NUM_CODES
+  }
+}
+
 void AADEncoderTest_Setup(void)
 {
   struct TestSuite *suite
@@ -343,4 +896,12 @@ void AADEncoderTest_Setup(void)
   Test_AddTest(suite, AADEncoderTest_CalculateBlockSizeTest);
   Test_AddTest(suite, AADEncoderTest_CreateDestroyTest);
   Test_AddTest(suite, AADEncoderTest_SetEncodeParameterTest);
+  Test_AddTest(suite, AADEncoderTest_EncodeStreamTest);
+  Test_AddTest(suite, AADEncoderTest_PrevInputBufferTest);
+  Test_AddTest(suite, AADEncoderTest_CalculateSumSquaredErrorTest);
+  Test_AddTest(suite, AADEncoderTest_CalculateSumSquaredErrorLanesTest);
+#if AAD_ENCODER_USE_AVX2
+  Test_AddTest(suite, AADEncoderTest_EncodeUnitLanesAVX2Test);
+#endif
+  Test_AddTest(suite, AADEncoderTest_PackCodesTest);
 }
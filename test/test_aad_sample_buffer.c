@@ -0,0 +1,253 @@
+#include "test.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* テスト対象のモジュール */
+#include "../src/aad_sample_buffer.c"
+
+/* テストのセットアップ関数 */
+void AADSampleBufferTest_Setup(void);
+
+static int AADSampleBufferTest_Initialize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+static int AADSampleBufferTest_Finalize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+/* 記述子検査のテスト */
+static void AADSampleBufferTest_CheckTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 成功例 */
+  {
+    int16_t interleaved[2 * 16];
+    int32_t planar[2][16];
+    int32_t *planar_ptr[2];
+    struct AADSampleBuffer buffer;
+
+    /* インターリーブ */
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.format = AAD_SAMPLE_FORMAT_INT16;
+    buffer.layout = AAD_SAMPLE_LAYOUT_INTERLEAVED;
+    buffer.channels[0] = interleaved;
+    buffer.num_channels = 2;
+    buffer.num_samples = 16;
+    buffer.stride = 2;
+    Test_AssertEqual(AADSampleBuffer_Check(&buffer, 2, 16), AAD_ERROR_OK);
+    Test_AssertEqual(AADSampleBuffer_Check(&buffer, 1, 8), AAD_ERROR_OK);
+    Test_AssertEqual(AADSampleBuffer_IsPlanarInt32(&buffer), 0);
+
+    /* プレーナ */
+    planar_ptr[0] = planar[0];
+    planar_ptr[1] = planar[1];
+    AADSampleBuffer_SetPlanarInt32(&buffer, planar_ptr, 2, 16);
+    Test_AssertEqual(AADSampleBuffer_Check(&buffer, 2, 16), AAD_ERROR_OK);
+    Test_AssertEqual(AADSampleBuffer_IsPlanarInt32(&buffer), 1);
+    AADSampleBuffer_SetPlanarInt32(&buffer, planar_ptr, 1, 16);
+    Test_AssertEqual(buffer.channels[1] == NULL, 1);
+  }
+
+  /* 失敗ケース */
+  {
+    int16_t interleaved[2 * 16];
+    struct AADSampleBuffer buffer, tmp;
+
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.format = AAD_SAMPLE_FORMAT_INT16;
+    buffer.layout = AAD_SAMPLE_LAYOUT_INTERLEAVED;
+    buffer.channels[0] = interleaved;
+    buffer.num_channels = 2;
+    buffer.num_samples = 16;
+    buffer.stride = 2;
+
+    Test_AssertEqual(AADSampleBuffer_Check(NULL, 2, 16), AAD_ERROR_INVALID_ARGUMENT);
+
+    /* 型・並び・間隔が不正 */
+    tmp = buffer; tmp.format = AAD_SAMPLE_FORMAT_INVALID;
+    Test_AssertEqual(AADSampleBuffer_Check(&tmp, 2, 16), AAD_ERROR_INVALID_ARGUMENT);
+    tmp = buffer; tmp.layout = AAD_SAMPLE_LAYOUT_INVALID;
+    Test_AssertEqual(AADSampleBuffer_Check(&tmp, 2, 16), AAD_ERROR_INVALID_ARGUMENT);
+    tmp = buffer; tmp.stride = 0;
+    Test_AssertEqual(AADSampleBuffer_Check(&tmp, 2, 16), AAD_ERROR_INVALID_ARGUMENT);
+
+    /* インターリーブで1サンプル分のチャンネルが重なる */
+    tmp = buffer; tmp.stride = 1;
+    Test_AssertEqual(AADSampleBuffer_Check(&tmp, 2, 16), AAD_ERROR_INVALID_ARGUMENT);
+
+    /* 配列がない */
+    tmp = buffer; tmp.channels[0] = NULL;
+    Test_AssertEqual(AADSampleBuffer_Check(&tmp, 2, 16), AAD_ERROR_INVALID_ARGUMENT);
+    tmp = buffer; tmp.layout = AAD_SAMPLE_LAYOUT_PLANAR; tmp.stride = 1;
+    Test_AssertEqual(AADSampleBuffer_Check(&tmp, 2, 16), AAD_ERROR_INVALID_ARGUMENT);
+
+    /* チャンネル数・サンプル数が足りない */
+    Test_AssertEqual(AADSampleBuffer_Check(&buffer, 3, 16), AAD_ERROR_INSUFFICIENT_BUFFER);
+    Test_AssertEqual(AADSampleBuffer_Check(&buffer, 2, 17), AAD_ERROR_INSUFFICIENT_BUFFER);
+  }
+}
+
+/* 読み出し・書き込みのテスト */
+static void AADSampleBufferTest_ReadWriteTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 全形式で書き込んだ値が読み出せるか */
+  {
+#define NUM_SAMPLES 64
+#define STRIDE      3
+    int16_t int16_data[NUM_SAMPLES * STRIDE];
+    int32_t int32_data[NUM_SAMPLES * STRIDE];
+    float float_data[NUM_SAMPLES * STRIDE];
+    int32_t src[NUM_SAMPLES], dst[NUM_SAMPLES];
+    void *data_list[3];
+    struct AADSampleBuffer buffer;
+    uint32_t smpl, i, ch;
+    uint8_t is_ok = 1;
+    const AADSampleFormat format_list[] = {
+      AAD_SAMPLE_FORMAT_INT16, AAD_SAMPLE_FORMAT_INT32, AAD_SAMPLE_FORMAT_INT32_MSB, AAD_SAMPLE_FORMAT_FLOAT32 };
+    const AADSampleLayout layout_list[] = { AAD_SAMPLE_LAYOUT_INTERLEAVED, AAD_SAMPLE_LAYOUT_PLANAR };
+
+    data_list[0] = int16_data;
+    data_list[1] = int32_data;
+    data_list[2] = float_data;
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+      src[smpl] = (int32_t)((smpl * 1021) % 65536) - 32768;
+    }
+    src[0] = INT16_MIN;
+    src[1] = INT16_MAX;
+
+    for (i = 0; i < sizeof(format_list) / sizeof(format_list[0]); i++) {
+      uint32_t l;
+      for (l = 0; l < sizeof(layout_list) / sizeof(layout_list[0]); l++) {
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.format = format_list[i];
+        buffer.layout = layout_list[l];
+        buffer.num_channels = 2;
+        buffer.num_samples = NUM_SAMPLES;
+        buffer.stride = STRIDE;
+        /* プレーナは同じ配列を1要素ずらして共有 */
+        switch (format_list[i]) {
+          case AAD_SAMPLE_FORMAT_INT16:
+            buffer.channels[0] = data_list[0];
+            buffer.channels[1] = &int16_data[1];
+            break;
+          case AAD_SAMPLE_FORMAT_FLOAT32:
+            buffer.channels[0] = data_list[2];
+            buffer.channels[1] = &float_data[1];
+            break;
+          default:
+            buffer.channels[0] = data_list[1];
+            buffer.channels[1] = &int32_data[1];
+            break;
+        }
+        for (ch = 0; ch < 2; ch++) {
+          AADSampleBuffer_WriteChannel(&buffer, ch, 0, NUM_SAMPLES, src);
+          AADSampleBuffer_ReadChannel(&buffer, ch, 0, NUM_SAMPLES, dst);
+          if (memcmp(src, dst, sizeof(int32_t) * NUM_SAMPLES) != 0) {
+            is_ok = 0;
+          }
+          /* 途中からの読み出し */
+          AADSampleBuffer_ReadChannel(&buffer, ch, 5, NUM_SAMPLES - 5, dst);
+          if (memcmp(&src[5], dst, sizeof(int32_t) * (NUM_SAMPLES - 5)) != 0) {
+            is_ok = 0;
+          }
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 格納形式の確認 */
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.format = AAD_SAMPLE_FORMAT_INT32_MSB;
+    buffer.layout = AAD_SAMPLE_LAYOUT_INTERLEAVED;
+    buffer.channels[0] = int32_data;
+    buffer.num_channels = 2;
+    buffer.num_samples = NUM_SAMPLES;
+    buffer.stride = 2;
+    AADSampleBuffer_WriteChannel(&buffer, 1, 0, 2, src);
+    Test_AssertEqual(int32_data[1], INT16_MIN * 65536);
+    Test_AssertEqual(int32_data[3], INT16_MAX * 65536);
+#undef NUM_SAMPLES
+#undef STRIDE
+  }
+
+  /* 範囲外の値のクリップと丸め */
+  {
+    const int32_t int32_in[] = { 40000, -40000, 100, -100 };
+    const float float_in[] = { 2.0f, -2.0f, 0.25f / 32768.0f, 0.5f / 32768.0f, -0.5f / 32768.0f, -1.0f };
+    int32_t int32_out[6];
+    int16_t int16_out[2];
+    struct AADSampleBuffer buffer;
+
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.format = AAD_SAMPLE_FORMAT_INT32;
+    buffer.layout = AAD_SAMPLE_LAYOUT_PLANAR;
+    buffer.channels[0] = (void *)int32_in;
+    buffer.num_channels = 1;
+    buffer.num_samples = 4;
+    buffer.stride = 1;
+    AADSampleBuffer_ReadChannel(&buffer, 0, 0, 4, int32_out);
+    Test_AssertEqual(int32_out[0], INT16_MAX);
+    Test_AssertEqual(int32_out[1], INT16_MIN);
+    Test_AssertEqual(int32_out[2], 100);
+    Test_AssertEqual(int32_out[3], -100);
+
+    buffer.format = AAD_SAMPLE_FORMAT_INT16;
+    buffer.channels[0] = int16_out;
+    buffer.num_samples = 2;
+    AADSampleBuffer_WriteChannel(&buffer, 0, 0, 2, int32_in);
+    Test_AssertEqual(int16_out[0], INT16_MAX);
+    Test_AssertEqual(int16_out[1], INT16_MIN);
+
+    buffer.format = AAD_SAMPLE_FORMAT_FLOAT32;
+    buffer.channels[0] = (void *)float_in;
+    buffer.num_samples = 6;
+    AADSampleBuffer_ReadChannel(&buffer, 0, 0, 6, int32_out);
+    Test_AssertEqual(int32_out[0], INT16_MAX);
+    Test_AssertEqual(int32_out[1], INT16_MIN);
+    Test_AssertEqual(int32_out[2], 0);
+    Test_AssertEqual(int32_out[3], 1);
+    Test_AssertEqual(int32_out[4], -1);
+    Test_AssertEqual(int32_out[5], INT16_MIN);
+  }
+
+  /* NaNは無音として読み込む */
+  {
+    volatile float zero = 0.0f;
+    float float_in[3];
+    int32_t int32_out[3];
+    struct AADSampleBuffer buffer;
+
+    float_in[0] = 0.5f;
+    float_in[1] = zero / zero;
+    float_in[2] = -0.5f;
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.format = AAD_SAMPLE_FORMAT_FLOAT32;
+    buffer.layout = AAD_SAMPLE_LAYOUT_PLANAR;
+    buffer.channels[0] = (void *)float_in;
+    buffer.num_channels = 1;
+    buffer.num_samples = 3;
+    buffer.stride = 1;
+    AADSampleBuffer_ReadChannel(&buffer, 0, 0, 3, int32_out);
+    Test_AssertEqual(int32_out[0], 16384);
+    Test_AssertEqual(int32_out[1], 0);
+    Test_AssertEqual(int32_out[2], -16384);
+  }
+}
+
+void AADSampleBufferTest_Setup(void)
+{
+  struct TestSuite *suite
+    = Test_AddTestSuite("AAD Sample Buffer Test Suite",
+        NULL, AADSampleBufferTest_Initialize, AADSampleBufferTest_Finalize);
+
+  Test_AddTest(suite, AADSampleBufferTest_CheckTest);
+  Test_AddTest(suite, AADSampleBufferTest_ReadWriteTest);
+}
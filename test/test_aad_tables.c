@@ -26,6 +26,90 @@ static void AADTablesTest_Dummy(void *obj)
   TEST_UNUSED_PARAMETER(obj);
 }
 
+/* 量子化差分テーブルのテスト */
+static void AADTablesTest_QuantizedDiffTableTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 全ステップサイズ・全符号で従来の計算式と一致するか */
+  {
+    uint16_t bits_per_sample;
+    int32_t index, code;
+    struct AADTable table;
+    uint8_t is_ok = 1;
+
+    for (bits_per_sample = AAD_MIN_BITS_PER_SAMPLE; bits_per_sample <= AAD_MAX_BITS_PER_SAMPLE; bits_per_sample++) {
+      const int32_t signbit = 1 << (bits_per_sample - 1);
+      const int32_t absmask = signbit - 1;
+      AADTable_Initialize(&table, bits_per_sample);
+      for (index = 0; index <= AAD_TABLES_INDEX_TO_FLOAT(AAD_STEPSIZE_TABLE_SIZE - 1); index++) {
+        table.stepsize_index = (int16_t)index;
+        for (code = 0; code < table.index_table_size; code++) {
+          const int32_t stepsize = AADTable_GetStepSize(&table);
+          int32_t qdiff = (stepsize * (((code & absmask) << 1) + 1)) >> (bits_per_sample - 1);
+          qdiff = (code & signbit) ? -qdiff : qdiff;
+          if (AADTable_GetQuantizedDiff(&table, code) != qdiff) {
+            is_ok = 0;
+          }
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+  }
+}
+
+/* ステップサイズ逆数乗算による除算のテスト */
+static void AADTablesTest_DivideByStepSizeTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 全ステップサイズ・定義域内の全被除数で除算と一致するか */
+  {
+    int32_t index, val;
+    struct AADTable table;
+    uint8_t is_ok = 1;
+
+    AADTable_Initialize(&table, 4);
+    for (index = 0; index < AAD_STEPSIZE_TABLE_SIZE; index++) {
+      int32_t stepsize;
+      table.stepsize_index = (int16_t)AAD_TABLES_INDEX_TO_FLOAT(index);
+      stepsize = AADTable_GetStepSize(&table);
+      for (val = 0; val <= AAD_TABLES_MAX_DIVIDEND; val++) {
+        if (AADTable_DivideByStepSize(&table, val) != (val / stepsize)) {
+          is_ok = 0;
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+  }
+
+  /* 差分の絶対値を2**16で制限しても符号が変わらないか */
+  {
+    uint16_t bits_per_sample;
+    int32_t index, diffabs;
+    struct AADTable table;
+    uint8_t is_ok = 1;
+
+    for (bits_per_sample = AAD_MIN_BITS_PER_SAMPLE; bits_per_sample <= AAD_MAX_BITS_PER_SAMPLE; bits_per_sample++) {
+      const int32_t absmask = (1 << (bits_per_sample - 1)) - 1;
+      AADTable_Initialize(&table, bits_per_sample);
+      for (index = 0; index < AAD_STEPSIZE_TABLE_SIZE; index++) {
+        int32_t stepsize;
+        table.stepsize_index = (int16_t)AAD_TABLES_INDEX_TO_FLOAT(index);
+        stepsize = AADTable_GetStepSize(&table);
+        for (diffabs = (1 << 16) - 16; diffabs <= (1 << 16) + 4096; diffabs++) {
+          const int32_t clipped = AAD_MIN_VAL(diffabs, 1 << 16);
+          if (AAD_MIN_VAL(AADTable_DivideByStepSize(&table, clipped << (bits_per_sample - 2)), absmask)
+              != AAD_MIN_VAL((diffabs << (bits_per_sample - 2)) / stepsize, absmask)) {
+            is_ok = 0;
+          }
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+  }
+}
+
 void AADTablesTest_Setup(void)
 {
   struct TestSuite *suite
@@ -33,4 +117,6 @@ void AADTablesTest_Setup(void)
         NULL, AADTablesTest_Initialize, AADTablesTest_Finalize);
 
   Test_AddTest(suite, AADTablesTest_Dummy);
+  Test_AddTest(suite, AADTablesTest_QuantizedDiffTableTest);
+  Test_AddTest(suite, AADTablesTest_DivideByStepSizeTest);
 }
@@ -363,6 +363,52 @@ static void ByteArrayTest_ReadWriteTest(void *obj)
 #undef TEST_SIZE_UINT16
   }
 
+  /* 8バイトの読み書き（ビッグエンディアン） */
+  {
+#define TEST_SIZE_UINT64 (TEST_SIZE / sizeof(uint64_t))
+    uint8_t   *pos;
+    uint8_t   array[TEST_SIZE];
+    uint64_t  test[TEST_SIZE_UINT64], answer[TEST_SIZE_UINT64];
+    uint32_t  i;
+
+    /* 上位32bitにも値が入るようにする */
+    for (i = 0; i < TEST_SIZE_UINT64; i++) {
+      answer[i] = ((uint64_t)(i * 0x01030507UL) << 32) | (uint64_t)(0xFFFFFFFFUL - i);
+    }
+
+    /* Write/Read */
+    pos = array;
+    for (i = 0; i < TEST_SIZE_UINT64; i++) {
+      ByteArray_WriteUint64BE(pos, answer[i]);
+      pos += 8;
+    }
+    pos = array;
+    for (i = 0; i < TEST_SIZE_UINT64; i++) {
+      test[i] = ByteArray_ReadUint64BE(pos);
+      pos += 8;
+    }
+    Test_AssertEqual(memcmp(test, answer, sizeof(uint8_t) * TEST_SIZE), 0);
+
+    /* 上位バイトから並んでいるか？ */
+    Test_AssertEqual(array[8], (uint8_t)((answer[1] >> 56) & 0xFF));
+    Test_AssertEqual(array[15], (uint8_t)(answer[1] & 0xFF));
+
+    /* Put/Get */
+    memset(test, 0, sizeof(test));
+    pos = array;
+    for (i = 0; i < TEST_SIZE_UINT64; i++) {
+      ByteArray_PutUint64BE(pos, answer[i]);
+    }
+    Test_AssertEqual(pos - array, (long)(TEST_SIZE_UINT64 * 8));
+    pos = array;
+    for (i = 0; i < TEST_SIZE_UINT64; i++) {
+      ByteArray_GetUint64BE(pos, &test[i]);
+    }
+    Test_AssertEqual(memcmp(test, answer, sizeof(uint8_t) * TEST_SIZE), 0);
+
+#undef TEST_SIZE_UINT64
+  }
+
 #undef TEST_SIZE
 }
 
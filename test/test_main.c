@@ -3,9 +3,11 @@
 /* 各テストスイートのセットアップ関数宣言 */
 void ByteArrayTest_Setup(void);
 void AADTablesTest_Setup(void);
+void AADSampleBufferTest_Setup(void);
 void AADEncoderTest_Setup(void);
 void AADDecoderTest_Setup(void);
 void AADEncodeDecodeTest_Setup(void);
+void WorkStealingPoolTest_Setup(void);
 
 /* テスト実行 */
 int main(int argc, char **argv)
@@ -19,9 +21,11 @@ int main(int argc, char **argv)
 
   ByteArrayTest_Setup();
   AADTablesTest_Setup();
+  AADSampleBufferTest_Setup();
   AADEncoderTest_Setup();
   AADDecoderTest_Setup();
   AADEncodeDecodeTest_Setup();
+  WorkStealingPoolTest_Setup();
 
   ret = Test_RunAllTestSuite();
 
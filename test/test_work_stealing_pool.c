@@ -0,0 +1,160 @@
+#include "test.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* テスト対象のモジュール */
+#include "../src/work_stealing_pool.c"
+
+/* テストのセットアップ関数 */
+void WorkStealingPoolTest_Setup(void);
+
+/* テスト用のワーカ引数 */
+struct WorkStealingPoolTestWorker {
+  pthread_mutex_t *mutex;         /* 記録の排他           */
+  uint32_t        *job_counts;    /* ジョブごとの処理回数 */
+  uint32_t        *job_order;     /* 処理したジョブの順番 */
+  uint32_t        *num_processed; /* 全体の処理数         */
+  uint32_t        num_own;        /* このワーカの処理数   */
+};
+
+static int WorkStealingPoolTest_Initialize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+static int WorkStealingPoolTest_Finalize(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+  return 0;
+}
+
+/* 処理したジョブを記録するジョブ処理関数 */
+static void WorkStealingPoolTest_RecordJob(void *worker_arg, uint32_t job)
+{
+  struct WorkStealingPoolTestWorker *worker = (struct WorkStealingPoolTestWorker *)worker_arg;
+
+  pthread_mutex_lock(worker->mutex);
+  worker->job_counts[job]++;
+  worker->job_order[*(worker->num_processed)] = job;
+  (*(worker->num_processed))++;
+  pthread_mutex_unlock(worker->mutex);
+  worker->num_own++;
+}
+
+/* 何もしないジョブ処理関数 */
+static void WorkStealingPoolTest_NullJob(void *worker_arg, uint32_t job)
+{
+  TEST_UNUSED_PARAMETER(worker_arg);
+  TEST_UNUSED_PARAMETER(job);
+}
+
+/* 実行のテスト */
+static void WorkStealingPoolTest_RunTest(void *obj)
+{
+  TEST_UNUSED_PARAMETER(obj);
+
+  /* 全ジョブがちょうど1回ずつ処理されるか */
+  {
+#define MAX_NUM_WORKERS 16
+#define MAX_NUM_JOBS    1000
+    static uint32_t job_counts[MAX_NUM_JOBS], job_order[MAX_NUM_JOBS];
+    static uint64_t job_costs[MAX_NUM_JOBS];
+    struct WorkStealingPoolTestWorker workers[MAX_NUM_WORKERS];
+    void *worker_args[MAX_NUM_WORKERS];
+    pthread_mutex_t mutex;
+    uint32_t i, w, j, c, num_processed, num_own_total;
+    uint8_t is_ok = 1;
+    const uint32_t num_workers_list[] = { 1, 2, 3, 4, 8, MAX_NUM_WORKERS };
+    const uint32_t num_jobs_list[] = { 1, 2, 7, 64, MAX_NUM_JOBS };
+
+    pthread_mutex_init(&mutex, NULL);
+    for (i = 0; i < MAX_NUM_JOBS; i++) {
+      /* 大小のジョブが混ざるようにする */
+      job_costs[i] = (uint64_t)((i * 7919) % 1009);
+    }
+
+    for (w = 0; w < sizeof(num_workers_list) / sizeof(num_workers_list[0]); w++) {
+      for (j = 0; j < sizeof(num_jobs_list) / sizeof(num_jobs_list[0]); j++) {
+        /* コスト指定あり・なし（NULL） */
+        for (c = 0; c < 2; c++) {
+          const uint32_t num_workers = num_workers_list[w];
+          const uint32_t num_jobs = num_jobs_list[j];
+          memset(job_counts, 0, sizeof(job_counts));
+          num_processed = 0;
+          for (i = 0; i < num_workers; i++) {
+            workers[i].mutex = &mutex;
+            workers[i].job_counts = job_counts;
+            workers[i].job_order = job_order;
+            workers[i].num_processed = &num_processed;
+            workers[i].num_own = 0;
+            worker_args[i] = &workers[i];
+          }
+          if (WorkStealingPool_Run(num_workers, (c == 0) ? job_costs : NULL, num_jobs,
+                WorkStealingPoolTest_RecordJob, worker_args) != WORK_STEALING_POOL_APIRESULT_OK) {
+            is_ok = 0;
+          }
+          for (i = 0; i < num_jobs; i++) {
+            if (job_counts[i] != 1) {
+              is_ok = 0;
+            }
+          }
+          /* 各ワーカの処理数の合計もジョブ数に一致 */
+          num_own_total = 0;
+          for (i = 0; i < num_workers; i++) {
+            num_own_total += workers[i].num_own;
+          }
+          if ((num_processed != num_jobs) || (num_own_total != num_jobs)) {
+            is_ok = 0;
+          }
+        }
+      }
+    }
+    Test_AssertEqual(is_ok, 1);
+
+    /* 1ワーカならコストの降順（同じならジョブ番号の昇順）に処理される */
+    {
+      const uint64_t costs[] = { 3, 10, 3, 0, 7 };
+      const uint32_t answer[] = { 1, 4, 0, 2, 3 };
+      memset(job_counts, 0, sizeof(job_counts));
+      num_processed = 0;
+      workers[0].num_own = 0;
+      worker_args[0] = &workers[0];
+      Test_AssertEqual(WorkStealingPool_Run(1, costs, 5, WorkStealingPoolTest_RecordJob, worker_args),
+          WORK_STEALING_POOL_APIRESULT_OK);
+      Test_AssertEqual(num_processed, 5);
+      Test_AssertEqual(memcmp(job_order, answer, sizeof(answer)), 0);
+    }
+
+    pthread_mutex_destroy(&mutex);
+#undef MAX_NUM_WORKERS
+#undef MAX_NUM_JOBS
+  }
+
+  /* ジョブがなければ何もせず成功 */
+  {
+    void *worker_args[1] = { NULL };
+    Test_AssertEqual(WorkStealingPool_Run(4, NULL, 0, WorkStealingPoolTest_NullJob, worker_args),
+        WORK_STEALING_POOL_APIRESULT_OK);
+  }
+
+  /* 失敗ケース */
+  {
+    void *worker_args[1] = { NULL };
+    Test_AssertEqual(WorkStealingPool_Run(0, NULL, 1, WorkStealingPoolTest_NullJob, worker_args),
+        WORK_STEALING_POOL_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(WorkStealingPool_Run(1, NULL, 1, NULL, worker_args),
+        WORK_STEALING_POOL_APIRESULT_INVALID_ARGUMENT);
+    Test_AssertEqual(WorkStealingPool_Run(1, NULL, 1, WorkStealingPoolTest_NullJob, NULL),
+        WORK_STEALING_POOL_APIRESULT_INVALID_ARGUMENT);
+  }
+}
+
+void WorkStealingPoolTest_Setup(void)
+{
+  struct TestSuite *suite
+    = Test_AddTestSuite("Work Stealing Pool Test Suite",
+        NULL, WorkStealingPoolTest_Initialize, WorkStealingPoolTest_Finalize);
+
+  Test_AddTest(suite, WorkStealingPoolTest_RunTest);
+}